@@ -5,16 +5,20 @@
 #include <ostream>
 
 #include "CoolParser.h"
+#include "intern/Interner.h"
 #include "semantics/ClassTable.h"
 
 class CoolCodegen {
   private:
     std::string file_name_;
+    // Names the symbols in `class_table_` and the typed AST.
+    const Interner &interner_;
     std::unique_ptr<ClassTable> class_table_;
 
   public:
-    CoolCodegen(std::string file_name, std::unique_ptr<ClassTable> class_table)
-        : file_name_(std::move(file_name)),
+    CoolCodegen(std::string file_name, const Interner &interner,
+                std::unique_ptr<ClassTable> class_table)
+        : file_name_(std::move(file_name)), interner_(interner),
           class_table_(std::move(class_table)) {}
 
     void generate(std::ostream &out);
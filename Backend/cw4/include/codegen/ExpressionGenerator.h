@@ -4,7 +4,11 @@
 #include <map>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "intern/Interner.h"
 #include "semantics/ClassTable.h"
 #include "semantics/typed-ast/Expr.h"
 
@@ -46,25 +50,29 @@ constexpr int BOOL_TAG = 3;
 constexpr int STRING_TAG = 4;
 
 // String constant management
-int register_string_constant(const std::string& value);
-std::string escape_string(const std::string& s);
-int compute_string_length(const std::string& s);
+//
+// String constants are registered by the symbol of their contents, which the
+// lexer has already decoded. get_string_constants returns them with their ids,
+// in the order in which they are emitted.
+int register_string_constant(Symbol value);
+std::string escape_string(std::string_view s);
 void reset_string_constants();
-const std::map<std::string, int>& get_string_constants();
+std::vector<std::pair<Symbol, int>> get_string_constants(const Interner& interner);
 
 const std::map<int, int>& get_int_constants();
 
 class ExpressionGenerator {
 private:
+    const Interner& interner_;
     ClassTable* class_table_;
     int current_class_index_;
-    std::map<std::string, int> local_var_offsets_;
+    std::map<Symbol, int> local_var_offsets_;
     int next_local_offset_;
 
 public:
-    ExpressionGenerator(ClassTable* class_table, int current_class_index,
-                        std::map<std::string, int> local_var_offsets, int next_local_offset)
-        : class_table_(class_table), current_class_index_(current_class_index),
+    ExpressionGenerator(const Interner& interner, ClassTable* class_table, int current_class_index,
+                        std::map<Symbol, int> local_var_offsets, int next_local_offset)
+        : interner_(interner), class_table_(class_table), current_class_index_(current_class_index),
           local_var_offsets_(std::move(local_var_offsets)), next_local_offset_(next_local_offset) {}
 
     void emit_expr(std::ostream& out, const Expr* expr);
@@ -0,0 +1,78 @@
+#ifndef INPUT_MAPPED_CHAR_STREAM_H_
+#define INPUT_MAPPED_CHAR_STREAM_H_
+
+#include <string>
+#include <string_view>
+
+#include "antlr4-runtime.h"
+
+// A CharStream over a read-only memory mapping of a source file.
+//
+// ANTLRInputStream copies the whole input into a heap buffer and decodes it to
+// UTF-32, i.e. it costs four bytes per source byte before lexing even starts.
+// This stream maps the file instead and serves its bytes directly as symbols,
+// so opening a file is O(1) and the text is never duplicated.
+//
+// COOL sources are ASCII, so a byte is a character. Bytes outside of ASCII are
+// handed to the lexer one at a time, instead of being decoded as UTF-8 the way
+// ANTLRInputStream does. For non-ASCII input this changes what the lexer sees:
+// - outside of strings and comments, each byte of a multi-byte character is an
+//   ERROR token of its own, where ANTLRInputStream gives one per character;
+// - in a string, each byte counts towards MAX_STR_CONST, so a string of 513
+//   two-byte characters is too long;
+// - columns count bytes, not characters.
+// CoolFastLexer reads the same bytes and agrees with this.
+// Semantics/cw3/tests/lexer/non_ascii.cl covers these cases.
+class MappedCharStream : public antlr4::CharStream {
+  private:
+    std::string source_name_;
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    // Index of the next symbol to be consumed.
+    size_t p_ = 0;
+    bool is_open_ = false;
+
+  public:
+    explicit MappedCharStream(const std::string &file_path);
+    ~MappedCharStream() override;
+
+    MappedCharStream(const MappedCharStream &) = delete;
+    MappedCharStream &operator=(const MappedCharStream &) = delete;
+
+    // Whether the file could be opened and mapped. An empty file is open, but
+    // has no mapping.
+    bool is_open() const { return is_open_; }
+
+    // The raw bytes of the file. Valid for the lifetime of the stream.
+    const char *data() const { return data_; }
+
+    // Returns a view on the bytes in [start, stop] (both inclusive, like
+    // misc::Interval), clamped to the end of the file. No copy is made.
+    std::string_view get_view(size_t start, size_t stop) const;
+
+    // Returns a view on the text of a token lexed from this stream. Unlike
+    // Token::getText(), no copy is made.
+    std::string_view get_view(const antlr4::Token &token) const {
+        return get_view(token.getStartIndex(), token.getStopIndex());
+    }
+
+    // ----------------------- IntStream -------------------------
+
+    void consume() override;
+    size_t LA(ssize_t i) override;
+    // Marks are not needed, since the whole file is always available.
+    ssize_t mark() override { return -1; }
+    void release(ssize_t marker) override {}
+    size_t index() override { return p_; }
+    void seek(size_t index) override;
+    size_t size() override { return size_; }
+    std::string getSourceName() const override;
+
+    // ----------------------- CharStream -------------------------
+
+    // The text is extracted lazily, only for the requested interval.
+    std::string getText(const antlr4::misc::Interval &interval) override;
+    std::string toString() const override;
+};
+
+#endif
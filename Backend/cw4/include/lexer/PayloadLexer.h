@@ -0,0 +1,98 @@
+#ifndef LEXER_PAYLOAD_LEXER_H_
+#define LEXER_PAYLOAD_LEXER_H_
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+
+// The ANTLR generated CoolLexer, with its side data laid out as
+// CoolFastLexer lays it out: one payload per emitted token, indexed by token
+// index. The payload is the value of a BOOL_CONST, the symbol of an OBJECTID,
+// TYPEID or STR_CONST or the error code of an ERROR. Every other token gets 0,
+// and the token type tells how the payload is to be read.
+//
+// CoolLexer itself is generated from CoolLexer.g4 and keeps its side data in
+// maps keyed by the start char index of each token. Rather than changing the
+// grammar, and the generated code linked from lib/, each token is read from
+// CoolLexer and its entry in the maps is turned into a payload as the token
+// is passed on.
+class PayloadLexer : public antlr4::TokenSource {
+  public:
+    using ErrorCode = CoolLexer::ErrorCode;
+
+  private:
+    MappedCharStream *input_;
+    CoolLexer lexer_;
+
+    std::vector<int> token_payloads_;
+    // The payload of the token returned last by nextToken().
+    int last_payload_ = 0;
+    // Whether the payloads are kept in token_payloads_. A reader that takes
+    // the payload of each token as it is returned, like TokenWindow, turns
+    // this off, so that nothing grows with the input.
+    bool keep_token_payloads_ = true;
+
+    Interner own_interner_;
+    Interner *interner_ = &own_interner_;
+
+    // Returns the payload of `token` and drops its side data from lexer_.
+    int take_payload(const antlr4::Token &token);
+
+  public:
+    explicit PayloadLexer(MappedCharStream *input);
+
+    // The generated lexer, e.g. for its vocabulary and error listeners.
+    CoolLexer &lexer() { return lexer_; }
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override { return lexer_.getLine(); }
+    size_t getCharPositionInLine() override {
+        return lexer_.getCharPositionInLine();
+    }
+    antlr4::CharStream *getInputStream() override { return input_; }
+    std::string getSourceName() override { return lexer_.getSourceName(); }
+    antlr4::TokenFactory<antlr4::CommonToken> *getTokenFactory() override {
+        return lexer_.getTokenFactory();
+    }
+
+    // The side data accessors are the same as in CoolFastLexer.
+
+    // Identifiers and the contents of string constants are interned here. The
+    // driver shares one interner with the rest of the compiler; until then
+    // the lexer uses its own.
+    void set_interner(Interner *shared_interner) {
+        interner_ = shared_interner;
+    }
+
+    const std::vector<int> &get_token_payloads() const {
+        return token_payloads_;
+    }
+
+    const int &get_last_payload() const { return last_payload_; }
+
+    void set_keep_token_payloads(bool keep) { keep_token_payloads_ = keep; }
+
+    bool get_bool_value(size_t token_index) const {
+        return token_payloads_[token_index] != 0;
+    }
+
+    Symbol get_symbol(size_t token_index) const {
+        return token_payloads_[token_index];
+    }
+
+    std::string_view get_csl_text(size_t token_index) const {
+        return interner_->name(get_symbol(token_index));
+    }
+
+    ErrorCode get_error_code(size_t token_index) const {
+        return static_cast<ErrorCode>(token_payloads_[token_index]);
+    }
+};
+
+#endif
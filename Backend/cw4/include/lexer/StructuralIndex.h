@@ -0,0 +1,79 @@
+#ifndef LEXER_STRUCTURAL_INDEX_H_
+#define LEXER_STRUCTURAL_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A structural index of a COOL source, built before lexing in the spirit of
+// simdjson.
+//
+// Stage 1 classifies the raw bytes 64 at a time with SSE2 or AVX2 (or plain
+// loops on other targets) into bitmaps of quotes, backslashes, newlines,
+// comment delimiters, braces, semicolons and whitespace. Stage 2 walks only
+// the set bits of those bitmaps to find where strings and comments begin and
+// end, following the same rules as the STR, ESTR and COMM modes of CoolLexer.
+//
+// The result tells which bytes are blank (whitespace and comments outside of
+// string literals, which the lexer may skip in bulk), where the top-level
+// classes end and which structural errors the source contains.
+class StructuralIndex {
+  public:
+    enum class ErrorKind {
+        UNMATCHED_COMMENT_END,
+        COMMENT_CONTAINS_EOF,
+        STR_CONTAINS_EOF,
+    };
+
+    struct Error {
+        ErrorKind kind;
+        // Index of the char the error is found at.
+        size_t char_index;
+    };
+
+  private:
+    size_t size_;
+
+    // One bit per byte of the source, 64 bytes per word. There is always a
+    // word for the index one past the end of the source.
+    std::vector<uint64_t> newlines_;
+    std::vector<uint64_t> blank_;
+
+    std::vector<size_t> class_ends_;
+    std::vector<Error> errors_;
+
+  public:
+    StructuralIndex(const char *data, size_t size);
+
+    // Whether the byte at `char_index` can be skipped by the lexer. Comments
+    // that are still open at the end of the source are not blank, so that the
+    // lexer gets to report them.
+    bool is_blank(size_t char_index) const {
+        return blank_[char_index / 64] >> (char_index % 64) & 1;
+    }
+
+    // Returns the index of the first byte at or after `char_index` that is not
+    // blank, or the size of the source if there is none.
+    size_t skip_blank(size_t char_index) const;
+
+    // Returns the number of newlines in [begin, end).
+    size_t count_newlines(size_t begin, size_t end) const;
+
+    // Returns the index of the first char of the line that contains
+    // `char_index`.
+    size_t line_start(size_t char_index) const;
+
+    // Returns the line (starting from 1) that contains `char_index`.
+    size_t line_of(size_t char_index) const {
+        return count_newlines(0, char_index) + 1;
+    }
+
+    // The index one past the semicolon that ends each top-level class, in
+    // source order. Consecutive entries delimit the classes, so the source can
+    // be split at them.
+    const std::vector<size_t> &class_ends() const { return class_ends_; }
+
+    const std::vector<Error> &errors() const { return errors_; }
+};
+
+#endif
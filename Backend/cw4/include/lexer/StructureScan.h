@@ -0,0 +1,14 @@
+#ifndef LEXER_STRUCTURE_SCAN_H_
+#define LEXER_STRUCTURE_SCAN_H_
+
+#include <ostream>
+#include <string>
+
+// Builds a StructuralIndex of the file at `file_path` and reports on `out`
+// the number of top-level classes, the structural errors with their lines,
+// and how fast the index was built, in bytes per cycle.
+//
+// Returns whether the file could be read and has no structural errors.
+bool scan_structure(const std::string &file_path, std::ostream &out);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef PARSER_PARSE_PROFILE_H_
+#define PARSER_PARSE_PROFILE_H_
+
+#include <ostream>
+#include <string>
+
+// Lexes the file at `file_path` with CoolLexer, parses it with CoolParser
+// with ANTLR's profiling on, and writes what the profile found to `out` as a
+// JSON object.
+//
+// The object has the time spent lexing and parsing, and one entry per
+// decision of CoolParser.g4, in decision order. An entry names the rule the
+// decision is in, and has how often it was predicted, the time spent
+// predicting it, the total and deepest lookahead of its SLL and LL
+// predictions, how often SLL fell back to LL, and how many ambiguities,
+// context sensitivities and syntax errors it met. The DFA cache of CoolParser
+// is shared by the whole process, so only the first file profiled is
+// predicted from a cold cache.
+//
+// Times are in nanoseconds. The object is written even if the file could not
+// be read, with an "error" member instead of a profile. Returns whether the
+// file was read and has no syntax errors.
+bool profile_parser(const std::string &file_path, std::ostream &out);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef PARSER_PARSER_DIFF_H_
+#define PARSER_PARSER_DIFF_H_
+
+#include <ostream>
+#include <string>
+
+// Parses the file at `file_path` with both CoolParser and PrattParser, from
+// the same tokens, and checks that they build the same tree: the same
+// contexts, with the same children and the same start and stop tokens. Files
+// with syntax errors must be rejected by both.
+//
+// The first difference found is described on `out`. Returns whether the two
+// trees are equal.
+bool diff_parsers(const std::string &file_path, std::ostream &out);
+
+#endif
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "ObjectEnvironment.h"
+#include "intern/Interner.h"
 #include "typed-ast/Attributes.h"
 #include "typed-ast/Method.h"
 #include "typed-ast/Methods.h"
@@ -27,16 +28,30 @@ class Class {
 
     // Returns whether this is the first time the attribute is being added or
     // not.
-    bool add_attribute(std::string attribute_name, int type_index) {
+    bool add_attribute(Symbol attribute_name, int type_index) {
         return attributes.add({attribute_name, type_index});
     }
 };
 
+// Classes are named by their text, as the codegen emits them. Attributes,
+// methods and arguments are named by the Symbol that the lexer interned for
+// them, so the semantics never copies those names out of the tokens.
 class ClassTable {
   private:
     std::unique_ptr<std::vector<std::string>> class_names_;
     std::unordered_map<std::string_view, int> class_name_to_index_;
     std::vector<Class> classes_;
+    // Filled by index_least_upper_bounds(). shallowest_[k][i] is the
+    // shallowest class among those with the indices i to i + 2^k - 1.
+    std::vector<int> depths_;
+    std::vector<std::vector<int>> shallowest_;
+
+    // Builds the sparse table that class_least_upper_bound() reads. Requires
+    // normalize_indexes(). depths_ follows from the parents in index order,
+    // since a parent comes before its heirs; level 0 of shallowest_ is the
+    // identity, and each further level takes the shallower of two entries of
+    // the level below, half a span apart.
+    void index_least_upper_bounds();
 
   public:
     void init(std::unique_ptr<std::vector<std::string>> class_names);
@@ -46,56 +61,54 @@ class ClassTable {
     // If this method returns a string, then adding the attribute failed and the
     // string is the error message.
     std::optional<std::string> add_attribute(std::string_view class_name,
-                                             std::string attribute_name,
+                                             Symbol attribute_name,
                                              std::string attribute_type);
 
     // If this method returns a string, then adding the method failed and the
     // string is the error message.
     std::optional<std::string>
-    add_method(std::string_view class_name, std::string method_name,
+    add_method(std::string_view class_name, Symbol method_name,
                const std::vector<std::string> &signature,
                SourceLocation source_location);
 
     // Returns the list of bottom-level attributes for the given class. This
     // means that inherited attributes are not returned.
-    std::vector<std::string> get_attributes(int class_index);
+    std::vector<Symbol> get_attributes(int class_index);
 
     // Returns the list of all attributes for the given class, transitively
     // including all inherited attributes.
-    std::vector<std::string> get_all_attributes(int class_index);
+    std::vector<Symbol> get_all_attributes(int class_index);
 
     // If this method returns nullopt, then the specified class does not have an
     // attribute with this name.
     std::optional<int> get_attribute_type(int class_index,
-                                          const std::string &attribute_name);
+                                          Symbol attribute_name);
 
     // If this method returns nullopt, then neither the specified class, nor any
     // of its ancestors has an attribute with this name.
-    std::optional<int>
-    transitive_get_attribute_type(int class_index,
-                                  const std::string &attribute_name);
+    std::optional<int> transitive_get_attribute_type(int class_index,
+                                                     Symbol attribute_name);
 
     const Expr *
     transitive_get_attribute_initializer(const std::string &class_name,
-                                         const std::string &attribute_name);
+                                         Symbol attribute_name);
 
     void set_attribute_initializer(const std::string &class_name,
-                                   const std::string &attribute_name,
+                                   Symbol attribute_name,
                                    std::unique_ptr<Expr> &&initializer);
 
-    void set_argument_names(int class_index, const std::string &method_name,
-                            std::vector<std::string> argument_names);
+    void set_argument_names(int class_index, Symbol method_name,
+                            std::vector<Symbol> argument_names);
 
-    void set_method_body(int class_index, const std::string &method_name,
+    void set_method_body(int class_index, Symbol method_name,
                          std::unique_ptr<Expr> &&body);
 
-    const Expr *get_method_body(int class_index,
-                                const std::string &method_name);
+    const Expr *get_method_body(int class_index, Symbol method_name);
 
-    std::vector<std::string> get_method_names(int class_index);
+    std::vector<Symbol> get_method_names(int class_index);
 
-    std::vector<std::string> get_argument_names(int class_index,
-                                                const std::string &method_name);
+    std::vector<Symbol> get_argument_names(int class_index,
+                                           Symbol method_name);
 
     // Returns a map from each method that the given class provides to the last
     // ancestor in the ancestry of the given glass that overrides the method.
@@ -103,32 +116,39 @@ class ClassTable {
     // The order is important (it is the order in which the methods are defined
     // by ancestors and the given class), which is why the map is represented by
     // vector of pairs.
-    std::vector<std::pair<std::string, int>> get_all_methods(int class_index);
+    std::vector<std::pair<Symbol, int>> get_all_methods(int class_index);
 
     // Returns the index of the given method_name in the output of
     // get_all_methods for the given class.
     //
     // Returns -1 if the method is not defined by any class in the ancestry of
     // the given class.
-    int get_method_index(int class_index, const std::string &method_name);
+    int get_method_index(int class_index, Symbol method_name);
 
     // If this method returns nullopt, then the specified class does not have a
     // method with this name.
-    std::optional<std::vector<int>>
-    get_signature(int class_index, const std::string &method_name);
+    std::optional<std::vector<int>> get_signature(int class_index,
+                                                  Symbol method_name);
 
     // If this method returns nullopt, then the specified class does not have a
     // method with this name at this source_location.
     std::optional<std::vector<int>>
-    get_signature(int class_index, const std::string &method_name,
+    get_signature(int class_index, Symbol method_name,
                   SourceLocation source_location);
 
+    // Requires normalize_indexes() and compute_sub_hierarchy_sizes(): the
+    // heirs of a class then take the indices right after its own, so this
+    // tests whether class_index is in the range of ancestor_index, in constant
+    // time however deep the hierarchy. That is
+    //   ancestor_index <= class_index &&
+    //   class_index < ancestor_index + sub_hierarchy_size of ancestor_index
+    // rather than a walk up the parents of class_index.
     bool is_subclass_of(int class_index, int ancestor_index);
 
     // If this method returns nullopt, then neither the specified class, nor any
     // of its ancestors has a method with this name.
     std::optional<std::vector<int>>
-    transitive_get_signature(int class_index, const std::string &method_name);
+    transitive_get_signature(int class_index, Symbol method_name);
 
     const std::vector<std::string> &get_class_names();
 
@@ -170,6 +190,15 @@ class ClassTable {
     // The result is >= 1, because subtyping is reflexive.
     int get_sub_hierarchy_size(int type_index);
 
+    // Requires normalize_indexes(). The classes after the first of the two,
+    // up to the second, all descend from the least upper bound, and the
+    // shallowest of them is one of its children; the sparse table finds it in
+    // constant time, from the two overlapping spans of the largest power of two
+    // that fits.
+    //
+    // The table is built on the first call, with
+    //   if (shallowest_.empty()) index_least_upper_bounds();
+    // so callers need not know when the hierarchy became final.
     int class_least_upper_bound(int class_a, int class_b);
 
     ObjectEnvironment load_attribute_types(std::string current_class_name);
@@ -7,17 +7,56 @@
 #include <vector>
 
 #include "ClassTable.h"
-#include "CoolLexer.h"
 #include "CoolParser.h"
+#include "intern/Interner.h"
+
+// Reads the symbols that the lexer interned for the OBJECTID, TYPEID and
+// STR_CONST tokens of the parse tree, so that names are never copied out of
+// the tokens.
+class TokenSymbols {
+  private:
+    Interner &interner_;
+    // The payloads of the lexer, indexed by token index.
+    const std::vector<int> &token_payloads_;
+
+  public:
+    TokenSymbols(Interner &interner, const std::vector<int> &token_payloads)
+        : interner_(interner), token_payloads_(token_payloads) {}
+
+    Symbol symbol(antlr4::tree::TerminalNode *node) const {
+        // Tokens that CoolParser conjures up while recovering from a syntax
+        // error, e.g. the missing TYPEID in `class A inherits {`, never came
+        // from the lexer and have no payload. Their text is interned instead.
+        size_t index = node->getSymbol()->getTokenIndex();
+        if (index >= token_payloads_.size()) {
+            return interner_.intern(node->getText());
+        }
+        return token_payloads_[index];
+    }
+
+    std::string_view name(Symbol symbol) const {
+        return interner_.name(symbol);
+    }
+
+    std::string_view name(antlr4::tree::TerminalNode *node) const {
+        return name(symbol(node));
+    }
+};
 
 class CoolSemantics {
   private:
-    CoolLexer *lexer_;
-    CoolParser *parser_;
+    // The names of the tree, keyed as in ClassTable: attribute, method and
+    // argument names by their Symbol, class names by their text.
+    TokenSymbols symbols_;
+    CoolParser::ProgramContext *program_;
 
   public:
-    CoolSemantics(CoolLexer *lexer, CoolParser *parser)
-        : lexer_(lexer), parser_(parser) {}
+    // `program` is the tree of the whole program, from CoolParser or
+    // PrattParser. `token_payloads` are the payloads of the lexer that produced
+    // its tokens, which interns into `interner`.
+    CoolSemantics(Interner &interner, const std::vector<int> &token_payloads,
+                  CoolParser::ProgramContext *program)
+        : symbols_(interner, token_payloads), program_(program) {}
 
     // Runs semantic analysis and returns the ClassTable generated in the
     // process.
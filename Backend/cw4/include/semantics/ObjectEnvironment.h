@@ -1,27 +1,35 @@
 #ifndef SEMANTICS_OBJECT_ENVIRONMENT_H_
 #define SEMANTICS_OBJECT_ENVIRONMENT_H_
 
-#include <string>
-#include <unordered_map>
-#include <vector>
+#include <span>
+
+#include "ScopedSymbolTable.h"
+#include "intern/Interner.h"
 
 class ObjectEnvironment {
   private:
     // It's okay to use indexes here, since they should be stablized by the time
     // type checking begins.
-    std::vector<std::unordered_map<std::string, int>> scopes;
+    //
+    // Each scope of the environment is one scope of the table, so a lookup
+    // probes one hash table however deep the nesting, and popping a scope
+    // puts back only what that scope shadowed.
+    ScopedSymbolTable objects_;
 
   public:
     // Add a scope with a single object in it. Remove the scope via `pop_scope`.
-    void add_object(std::string name, int type_index);
+    // That is objects_.enter_scope() followed by objects_.bind().
+    void add_object(Symbol name, int type_index);
 
     // -1 indicates no type, i.e. name not in scope
-    int get_type(std::string name);
+    int get_type(Symbol name) const;
 
     // Add a bunch of objects at once, shadowing previously added objects with
-    // the same names. Remove it via `pop_scope`.
-    void push_scope(std::vector<std::string> names, std::vector<int> types);
+    // the same names. Remove it via `pop_scope`. One objects_.enter_scope(),
+    // then a bind() per name.
+    void push_scope(std::span<const Symbol> names, std::span<const int> types);
 
+    // objects_.exit_scope().
     void pop_scope();
 };
 
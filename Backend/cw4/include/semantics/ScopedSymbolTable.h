@@ -0,0 +1,124 @@
+#ifndef SEMANTICS_SCOPED_SYMBOL_TABLE_H_
+#define SEMANTICS_SCOPED_SYMBOL_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "intern/Interner.h"
+
+// Maps symbols to ints across nested scopes, e.g. the objects in scope to
+// their type indices.
+//
+// All scopes share one hash table with open addressing, which holds the
+// innermost binding of each symbol, so a lookup probes a single table however
+// many scopes are open. Binding a symbol in an inner scope shadows its outer
+// binding, which goes to an undo log and is put back when the scope is left.
+// Entering a scope costs nothing, and leaving it costs one probe per symbol it
+// bound.
+class ScopedSymbolTable {
+  private:
+    static constexpr Symbol EMPTY = std::numeric_limits<Symbol>::max();
+    // The scope of a symbol that no open scope binds. Its slot stays, so
+    // that slots are never removed from the middle of a probe sequence.
+    static constexpr int UNBOUND = -1;
+    static constexpr size_t INITIAL_SLOTS = 64;
+
+    struct Slot {
+        Symbol symbol = EMPTY;
+        int value = 0;
+        // The depth of the scope that binds the symbol, or UNBOUND.
+        int scope = UNBOUND;
+    };
+
+    // A binding that a scope shadowed, to be put back when it is left.
+    struct Shadowed {
+        Symbol symbol;
+        int value;
+        int scope;
+    };
+
+    // A power of two in size, and at most half full.
+    std::vector<Slot> slots_ = std::vector<Slot>(INITIAL_SLOTS);
+    size_t used_ = 0;
+    std::vector<Shadowed> undo_log_;
+    // Where the undo log of each open scope starts.
+    std::vector<size_t> scope_starts_;
+
+    // The slot of `symbol`, or the empty slot where it would go.
+    size_t slot_of(Symbol symbol) const {
+        size_t mask = slots_.size() - 1;
+        uint32_t hash = symbol * 0x9E3779B1u;
+        size_t slot = (hash ^ (hash >> 16)) & mask;
+        while (slots_[slot].symbol != symbol &&
+               slots_[slot].symbol != EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(old.size() * 2, Slot{});
+        for (const Slot &slot : old) {
+            if (slot.symbol != EMPTY) {
+                slots_[slot_of(slot.symbol)] = slot;
+            }
+        }
+    }
+
+    int depth() const { return static_cast<int>(scope_starts_.size()); }
+
+  public:
+    void enter_scope() { scope_starts_.push_back(undo_log_.size()); }
+
+    // Unbinds what the innermost scope bound, and puts back what it shadowed.
+    void exit_scope() {
+        size_t start = scope_starts_.back();
+        scope_starts_.pop_back();
+        while (undo_log_.size() > start) {
+            const Shadowed &shadowed = undo_log_.back();
+            Slot &slot = slots_[slot_of(shadowed.symbol)];
+            slot.value = shadowed.value;
+            slot.scope = shadowed.scope;
+            undo_log_.pop_back();
+        }
+    }
+
+    // Binds `symbol` to `value` in the innermost scope, which must exist.
+    // Binding it again in the same scope replaces the value.
+    void bind(Symbol symbol, int value) {
+        if ((used_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        Slot &slot = slots_[slot_of(symbol)];
+        if (slot.symbol == EMPTY) {
+            slot.symbol = symbol;
+            ++used_;
+        }
+        if (slot.scope != depth()) {
+            undo_log_.push_back({symbol, slot.value, slot.scope});
+            slot.scope = depth();
+        }
+        slot.value = value;
+    }
+
+    // The value of the innermost binding of `symbol`, if any scope binds it.
+    std::optional<int> find(Symbol symbol) const {
+        const Slot &slot = slots_[slot_of(symbol)];
+        if (slot.scope == UNBOUND) {
+            return std::nullopt;
+        }
+        return slot.value;
+    }
+
+    // Whether the innermost scope binds `symbol`.
+    bool bound_in_innermost_scope(Symbol symbol) const {
+        return slots_[slot_of(symbol)].scope == depth();
+    }
+};
+
+#endif
@@ -13,9 +13,15 @@ class TypeArithmetic {
     explicit TypeArithmetic(ClassTable *class_table)
         : class_table_(class_table) {}
 
+    // SELF_TYPE only conforms to SELF_TYPE, or as the current class. Classes
+    // are tested with ClassTable::is_subclass_of, so the class table must be
+    // normalized: equal types conform, nothing else conforms to SELF_TYPE,
+    // and SELF_TYPE is then replaced by the index of the current class.
     bool is_subtype_of(int a_type_index, int b_type_index,
                        const std::string &current_class_name) const;
 
+    // SELF_TYPE stands for the current class, unless both are SELF_TYPE. The
+    // classes are then joined with ClassTable::class_least_upper_bound.
     int type_least_upper_bound(int type_a, int type_b,
                                const std::string &current_class_name) const;
 };
@@ -2,20 +2,20 @@
 #define SEMANTICS_TYPED_AST_ASSIGNMENT_H_
 
 #include "Expr.h"
+#include "intern/Interner.h"
 
 #include <memory>
-#include <string>
 
 class Assignment : public Expr {
   private:
-    std::string assignee_name_;
+    Symbol assignee_name_;
     std::unique_ptr<Expr> value_;
 
   public:
-    Assignment(std::string assignee_name, std::unique_ptr<Expr> value, int type)
+    Assignment(Symbol assignee_name, std::unique_ptr<Expr> value, int type)
         : Expr(type), assignee_name_(assignee_name), value_(std::move(value)) {}
 
-    const std::string &get_assignee_name() const { return assignee_name_; }
+    Symbol get_assignee_name() const { return assignee_name_; }
     Expr *get_value() const { return value_.get(); }
 };
 
@@ -2,7 +2,6 @@
 #define SEMANTICS_TYPED_AST_ATTRIBUTES_H_
 
 #include <optional>
-#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -13,10 +12,10 @@ class Attributes {
     // This design keeps the order of the attributes the same as their order of
     // being added to the class, while allowing quick lookup by name.
     std::vector<Attribute> attributes_;
-    std::unordered_map<std::string, int> name_to_index_;
+    std::unordered_map<Symbol, int> name_to_index_;
 
   public:
-    std::optional<int> get_type(const std::string &attribute_name);
+    std::optional<int> get_type(Symbol attribute_name);
 
     // Returns whether this is the first time the attribute is added or not.
     //
@@ -24,17 +23,17 @@ class Attributes {
     bool add(Attribute &&attribute);
 
     // Returns nullptr if the argument does not name an attribute.
-    Attribute *get(const std::string &attribute_name);
+    Attribute *get(Symbol attribute_name);
 
-    bool contains(const std::string &attribute_name);
+    bool contains(Symbol attribute_name);
 
-    std::vector<std::string> get_names();
+    std::vector<Symbol> get_names();
 
-    bool has_initializer(const std::string &attribute_name) const;
+    bool has_initializer(Symbol attribute_name) const;
 
-    const Expr *get_initializer(const std::string &attribute_name) const;
+    const Expr *get_initializer(Symbol attribute_name) const;
 
-    void set_initializer(const std::string &attribute_name,
+    void set_initializer(Symbol attribute_name,
                          std::unique_ptr<Expr> &&initializer);
 
     std::vector<Attribute>::const_iterator begin() const {
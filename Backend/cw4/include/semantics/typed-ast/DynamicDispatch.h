@@ -2,28 +2,28 @@
 #define SEMANTICS_TYPED_AST_DYNAMIC_DISPATCH_H_
 
 #include "Expr.h"
+#include "intern/Interner.h"
 
 #include <memory>
-#include <string>
 #include <utility>
 #include <vector>
 
 class DynamicDispatch : public Expr {
   private:
     std::unique_ptr<Expr> target_;
-    std::string method_name_;
+    Symbol method_name_;
     std::vector<std::unique_ptr<Expr>> arguments_;
 
   public:
-    DynamicDispatch(std::unique_ptr<Expr> target, std::string method_name,
+    DynamicDispatch(std::unique_ptr<Expr> target, Symbol method_name,
                     std::vector<std::unique_ptr<Expr>> arguments, int type)
         : Expr(type), target_(std::move(target)),
-          method_name_(std::move(method_name)),
+          method_name_(method_name),
           arguments_(std::move(arguments)) {}
 
     Expr *get_target() const { return target_.get(); }
 
-    std::string get_method_name() const { return method_name_; }
+    Symbol get_method_name() const { return method_name_; }
 
     std::vector<Expr *> get_arguments() const {
         // TODO: for-each?
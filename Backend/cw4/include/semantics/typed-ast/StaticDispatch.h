@@ -2,9 +2,9 @@
 #define SEMANTICS_TYPED_AST_STATIC_DISPATCH_H_
 
 #include "Expr.h"
+#include "intern/Interner.h"
 
 #include <memory>
-#include <string>
 #include <utility>
 #include <vector>
 
@@ -12,16 +12,16 @@ class StaticDispatch : public Expr {
   private:
     std::unique_ptr<Expr> target_;
     int static_dispatch_type_;
-    std::string method_name_;
+    Symbol method_name_;
     std::vector<std::unique_ptr<Expr>> arguments_;
 
   public:
     StaticDispatch(std::unique_ptr<Expr> target, int static_dispatch_type,
-                   std::string method_name,
+                   Symbol method_name,
                    std::vector<std::unique_ptr<Expr>> arguments, int type)
         : Expr(type), target_(std::move(target)),
           static_dispatch_type_(static_dispatch_type),
-          method_name_(std::move(method_name)),
+          method_name_(method_name),
           arguments_(std::move(arguments)) {}
 
     Expr *get_target() const { return target_.get(); }
@@ -32,7 +32,7 @@ class StaticDispatch : public Expr {
     // Note: different than get_type(): that's the return type of the method.
     int get_static_dispatch_type() const { return static_dispatch_type_; }
 
-    std::string get_method_name() const { return method_name_; }
+    Symbol get_method_name() const { return method_name_; }
 
     std::vector<Expr *> get_arguments() const {
         std::vector<Expr *> result;
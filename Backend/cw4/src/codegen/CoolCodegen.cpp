@@ -48,15 +48,16 @@ void CoolCodegen::generate(ostream &out) {
         // Get methods defined in this class
         auto method_names = class_table_->get_method_names(i);
         
-        for (const auto& method_name : method_names) {
+        for (Symbol method_name : method_names) {
             const Expr* body = class_table_->get_method_body(i, method_name);
             if (!body) continue;
             
             auto arg_names = class_table_->get_argument_names(i, method_name);
+            string method_label = class_name + "." + string(interner_.name(method_name));
             
             // Emit method label
-            emit_globl(out, class_name + "." + method_name);
-            emit_label(out, class_name + "." + method_name);
+            emit_globl(out, method_label);
+            emit_label(out, method_label);
             
             // Method prologue: set up frame
             emit_move(out, FramePointer{}, StackPointer{});
@@ -66,7 +67,7 @@ void CoolCodegen::generate(ostream &out) {
             emit_grow_stack(out, 1);
             
             // Set up local variable tracking
-            map<string, int> local_var_offsets;
+            map<Symbol, int> local_var_offsets;
             int next_local_offset = -8;
             
             int n_args = (int)arg_names.size();
@@ -75,7 +76,7 @@ void CoolCodegen::generate(ostream &out) {
             }
             
             // Generate body code
-            ExpressionGenerator expr_gen(class_table_.get(), i, local_var_offsets, next_local_offset);
+            ExpressionGenerator expr_gen(interner_, class_table_.get(), i, local_var_offsets, next_local_offset);
             expr_gen.emit_expr(out, body);
             
             // Method epilogue: restore state and return
@@ -164,7 +165,7 @@ void CoolCodegen::generate(ostream &out) {
         
         // Attributes with default values (0)
         for (size_t j = 0; j < attrs.size(); j++) {
-            emit_word(out, 0, "attribute: " + attrs[j]);
+            emit_word(out, 0, "attribute: " + string(interner_.name(attrs[j])));
         }
         emit_empty_line(out);
     }
@@ -181,7 +182,7 @@ void CoolCodegen::generate(ostream &out) {
         
         for (const auto& [method_name, defining_class] : methods) {
             string defining_class_name(class_table_->get_name(defining_class));
-            emit_word(out, defining_class_name + "." + method_name);
+            emit_word(out, defining_class_name + "." + string(interner_.name(method_name)));
         }
         emit_empty_line(out);
     }
@@ -248,12 +249,12 @@ void CoolCodegen::generate(ostream &out) {
         auto attrs = class_table_->get_attributes(i);
         auto all_attrs = class_table_->get_all_attributes(i);
         
-        for (const auto& attr_name : attrs) {
+        for (Symbol attr_name : attrs) {
             const Expr* init = class_table_->transitive_get_attribute_initializer(class_name, attr_name);
             if (init) {
-                map<string, int> local_var_offsets;
+                map<Symbol, int> local_var_offsets;
                 int next_local_offset = -12;
-                ExpressionGenerator expr_gen(class_table_.get(), i, local_var_offsets, next_local_offset);
+                ExpressionGenerator expr_gen(interner_, class_table_.get(), i, local_var_offsets, next_local_offset);
                 expr_gen.emit_expr(out, init);
                 
                 // Find attribute offset in object
@@ -290,9 +291,10 @@ void CoolCodegen::generate(ostream &out) {
     // String constants
     emit_header_comment(out, "String constants");
     
-    for (const auto& [str, id] : get_string_constants()) {
+    for (const auto& [symbol, id] : get_string_constants(interner_)) {
         string label = "_string" + to_string(id);
-        int actual_len = compute_string_length(str);
+        string_view str = interner_.name(symbol);
+        int actual_len = (int)str.size();
         
         // Length Int object
         emit_gc_tag(out);
@@ -26,8 +26,12 @@
 #include "semantics/typed-ast/Vardecl.h"
 #include "semantics/typed-ast/WhileLoopPool.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -37,35 +41,72 @@ using namespace riscv_emit;
 // String constant management
 // ============================================================================
 
-static map<string, int> string_constants;
-static int string_constant_counter = 0;
+// The registered string constants in the order they were registered. The id
+// of each is its position in this order plus one.
+static vector<Symbol> string_constants;
+static unordered_map<Symbol, int> string_constant_ids;
 
 static map<int, int> int_constants;
 static int int_constant_counter = 0;
 
 void reset_string_constants() {
     string_constants.clear();
-    string_constant_counter = 0;
+    string_constant_ids.clear();
     int_constants.clear();
     int_constant_counter = 0;
 }
 
-const map<string, int>& get_string_constants() {
-    return string_constants;
+// Returns how a string literal with contents `s` is spelled in the source,
+// quotes included.
+static string source_spelling(string_view s) {
+    string spelling = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '\n': spelling += "\\n"; break;
+            case '\t': spelling += "\\t"; break;
+            case '\b': spelling += "\\b"; break;
+            case '\f': spelling += "\\f"; break;
+            case '\\': spelling += "\\\\"; break;
+            case '"': spelling += "\\\""; break;
+            default: spelling += c; break;
+        }
+    }
+    spelling += '"';
+    return spelling;
+}
+
+vector<pair<Symbol, int>> get_string_constants(const Interner& interner) {
+    // String constants used to be registered by their source text, in an
+    // ordered map. They are still emitted in that order, so that the data
+    // section doesn't change.
+    vector<tuple<string, Symbol, int>> spelled;
+    spelled.reserve(string_constants.size());
+    for (size_t i = 0; i < string_constants.size(); i++) {
+        Symbol symbol = string_constants[i];
+        spelled.emplace_back(source_spelling(interner.name(symbol)), symbol,
+                             (int)i + 1);
+    }
+    sort(spelled.begin(), spelled.end());
+
+    vector<pair<Symbol, int>> ordered;
+    ordered.reserve(spelled.size());
+    for (const auto& [spelling, symbol, id] : spelled) {
+        ordered.emplace_back(symbol, id);
+    }
+    return ordered;
 }
 
 const map<int, int>& get_int_constants() {
     return int_constants;
 }
 
-int register_string_constant(const string& value) {
-    auto it = string_constants.find(value);
-    if (it != string_constants.end()) {
-        return it->second;
+int register_string_constant(Symbol value) {
+    auto [it, inserted] =
+        string_constant_ids.try_emplace(value, (int)string_constants.size() + 1);
+    if (inserted) {
+        string_constants.push_back(value);
     }
-    int id = ++string_constant_counter;
-    string_constants[value] = id;
-    return id;
+    return it->second;
 }
 
 int register_int_constant(int value) {
@@ -78,80 +119,33 @@ int register_int_constant(int value) {
     return id;
 }
 
-// Helper to escape strings for assembly output
-// The input string may include surrounding quotes from the source - strip them
-string escape_string(const string& s) {
+// Helper to escape strings for assembly output. Chars that aren't printable
+// are written as octal escapes, which the assembler turns back into the same
+// bytes.
+string escape_string(string_view s) {
     ostringstream result;
     result << "\"";
-    
-    string input = s;
-    // Strip surrounding quotes if present (from source parsing)
-    if (input.size() >= 2 && input.front() == '"' && input.back() == '"') {
-        input = input.substr(1, input.size() - 2);
-    }
-    
-    for (size_t i = 0; i < input.size(); i++) {
-        char c = input[i];
-        // Handle escape sequences from the source
-        if (c == '\\' && i + 1 < input.size()) {
-            char next = input[i + 1];
-            switch (next) {
-                case 'n':
-                    result << "\\n";
-                    i++;
-                    break;
-                case 't':
-                    result << "\\t";
-                    i++;
-                    break;
-                case '\\':
-                    result << "\\\\";
-                    i++;
-                    break;
-                case '"':
-                    result << "\\\"";
-                    i++;
-                    break;
-                default:
+    for (char c : s) {
+        unsigned char byte = c;
+        switch (c) {
+            case '\n': result << "\\n"; break;
+            case '\t': result << "\\t"; break;
+            case '\\': result << "\\\\"; break;
+            case '"': result << "\\\""; break;
+            default:
+                if (byte < 0x20 || byte >= 0x7f) {
+                    result << '\\' << oct << setw(3) << setfill('0')
+                           << (int)byte << dec;
+                } else {
                     result << c;
-                    break;
-            }
-        } else {
-            switch (c) {
-                case '\n': result << "\\n"; break;
-                case '\t': result << "\\t"; break;
-                case '\\': result << "\\\\"; break;
-                case '"': result << "\\\""; break;
-                default: result << c; break;
-            }
+                }
+                break;
         }
     }
     result << "\"";
     return result.str();
 }
 
-// Compute the actual string length (after processing escape sequences)
-int compute_string_length(const string& s) {
-    string input = s;
-    // Strip surrounding quotes if present
-    if (input.size() >= 2 && input.front() == '"' && input.back() == '"') {
-        input = input.substr(1, input.size() - 2);
-    }
-    
-    int len = 0;
-    for (size_t i = 0; i < input.size(); i++) {
-        char c = input[i];
-        if (c == '\\' && i + 1 < input.size()) {
-            char next = input[i + 1];
-            if (next == 'n' || next == 't' || next == '\\' || next == '"') {
-                i++;  // Skip the escape character
-            }
-        }
-        len++;
-    }
-    return len;
-}
-
 // ============================================================================
 // Expression Generator Implementation
 // ============================================================================
@@ -244,9 +238,9 @@ void ExpressionGenerator::emit_bool_constant(ostream& out, const BoolConstant* e
 }
 
 void ExpressionGenerator::emit_object_reference(ostream& out, const ObjectReference* expr) {
-    const string& name = expr->get_name();
+    Symbol name = expr->get_name();
     
-    if (name == "self") {
+    if (name == Interner::SELF) {
         emit_load_word(out, TempRegister{0}, MemoryLocation{-4, FramePointer{}});
         emit_push_register(out, TempRegister{0});
         emit_pop_into_register(out, ArgumentRegister{0});
@@ -271,7 +265,7 @@ void ExpressionGenerator::emit_object_reference(ostream& out, const ObjectRefere
         }
     }
     
-    cerr << "ICE: unknown object reference: " << name << endl;
+    cerr << "ICE: unknown object reference: " << interner_.name(name) << endl;
     abort();
 }
 
@@ -310,7 +304,7 @@ void ExpressionGenerator::emit_static_dispatch(ostream& out, const StaticDispatc
     // Call the method using static dispatch
     int dispatch_type = expr->get_static_dispatch_type();
     string class_name(class_table_->get_name(dispatch_type));
-    string method_name = expr->get_method_name();
+    string method_name(interner_.name(expr->get_method_name()));
     
     emit_jump_and_link(out, class_name + "." + method_name);
 }
@@ -353,7 +347,7 @@ void ExpressionGenerator::emit_sequence(ostream& out, const Sequence* expr) {
 }
 
 void ExpressionGenerator::emit_assignment(ostream& out, const Assignment* expr) {
-    const string& name = expr->get_assignee_name();
+    Symbol name = expr->get_assignee_name();
     
     // Evaluate the expression
     emit_expr(out, expr->get_value());
@@ -375,7 +369,7 @@ void ExpressionGenerator::emit_assignment(ostream& out, const Assignment* expr)
         }
     }
     
-    cerr << "ICE: unknown assignment target: " << name << endl;
+    cerr << "ICE: unknown assignment target: " << interner_.name(name) << endl;
     abort();
 }
 
@@ -438,12 +432,12 @@ void ExpressionGenerator::emit_while_loop(ostream& out, const WhileLoopPool* exp
 
 void ExpressionGenerator::emit_let_in(ostream& out, const LetIn* expr) {
     auto vardecls = expr->get_vardecls();
-    vector<string> var_names;
+    vector<Symbol> var_names;
     vector<int> var_offsets;
     
     // Process each vardecl
     for (auto* vardecl : vardecls) {
-        const string& var_name = vardecl->get_name();
+        Symbol var_name = vardecl->get_name();
         int var_type = vardecl->get_type();
         
         // Evaluate initializer if present
@@ -480,7 +474,7 @@ void ExpressionGenerator::emit_let_in(ostream& out, const LetIn* expr) {
     emit_expr(out, expr->get_body());
     
     // Clean up variables
-    for (const auto& name : var_names) {
+    for (Symbol name : var_names) {
         local_var_offsets_.erase(name);
     }
     
@@ -627,7 +621,7 @@ void ExpressionGenerator::emit_case_of_esac(ostream& out, const CaseOfEsac* expr
         emit_branch_not_equal_zero(out, TempRegister{2}, next_label);
         
         // Match found - bind variable and evaluate body
-        const string& var_name = cases[i].get_name();
+        Symbol var_name = cases[i].get_name();
         int offset = next_local_offset_;
         next_local_offset_ -= WORD_SIZE;
         
@@ -1,6 +1,8 @@
 #include <cctype>
+#include <chrono>
 #include <expected>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -13,6 +15,19 @@
 #include "CoolParser.h"
 #include "antlr4-runtime/antlr4-runtime.h"
 
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+#include "lexer/CoolFastLexer.h"
+#include "lexer/LexerDiff.h"
+#include "lexer/PayloadLexer.h"
+#include "lexer/StructuralIndex.h"
+#include "lexer/StructureScan.h"
+#include "memory/AllocationStats.h"
+#include "memory/Arena.h"
+#include "parser/ParseProfile.h"
+#include "parser/ParserDiff.h"
+#include "parser/PrattParser.h"
+#include "parser/TwoStageParse.h"
 #include "semantics/ClassTable.h"
 #include "semantics/CoolSemantics.h"
 
@@ -24,45 +39,286 @@ using namespace antlr4::tree;
 
 namespace fs = filesystem;
 
-int main(int argc, const char *argv[]) {
-    if (argc != 2) {
-        cerr << "Expecting exactly one argument: name of input file" << endl;
-        return 1;
-    }
+// How each file is compiled.
+struct CompileOptions {
+    bool use_fast_lexer = false;
+    bool use_pratt_parser = false;
+    bool use_two_stage = true;
+};
 
-    auto file_path = argv[1];
-    ifstream fin(file_path);
+// Compiles the file at `file_path` and writes its assembly, or its semantic
+// errors, to `out`. Two-stage parses are counted in `parse_stats`, and the
+// allocations of lexing, parsing, semantics, codegen and teardown are split
+// into `phases`.
+//
+// Returns false if the file could not be opened.
+bool compile(const string &file_path, const CompileOptions &options,
+             TwoStageStats &parse_stats, AllocationPhases &phases,
+             ostream &out) {
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        cerr << "Could not open input file: " << file_path << endl;
+        return false;
+    }
 
     auto file_name = fs::path(file_path).filename().string();
 
-    ANTLRInputStream input(fin);
-    CoolLexer lexer(&input);
+    // Every name and string constant of the program is interned here, for
+    // both lexers alike.
+    Interner interner;
 
-    // Silence console error reporting.
-    // lexer.removeErrorListener(&ConsoleErrorListener::INSTANCE);
+    unique_ptr<StructuralIndex> index;
+    unique_ptr<TokenSource> lexer;
+    const vector<int> *token_payloads;
+    if (options.use_fast_lexer) {
+        index = make_unique<StructuralIndex>(input.data(), input.size());
+        auto fast_lexer = make_unique<CoolFastLexer>(&input, index.get());
+        fast_lexer->set_interner(&interner);
+        token_payloads = &fast_lexer->get_token_payloads();
+        lexer = move(fast_lexer);
+    } else {
+        auto cool_lexer = make_unique<PayloadLexer>(&input);
+        cool_lexer->set_interner(&interner);
+        token_payloads = &cool_lexer->get_token_payloads();
+        lexer = move(cool_lexer);
+    }
 
-    CommonTokenStream tokenStream(&lexer);
+    phases.begin("lex");
+    CommonTokenStream tokenStream(lexer.get());
+    tokenStream.fill();
+
+    // PrattParser gives up at the first syntax error, and leaves it to
+    // CoolParser to report the errors. Its tree is made in parse_arena, and
+    // freed in one go once the file is compiled.
+    phases.begin("parse");
+    Arena parse_arena;
+    CoolParser::ProgramContext *program = nullptr;
+    if (options.use_pratt_parser) {
+        PrattParser pratt_parser(&tokenStream, parse_arena);
+        program = pratt_parser.parse();
+    }
 
     CoolParser parser(&tokenStream);
+    if (program == nullptr) {
+        program = options.use_two_stage ? parse_two_stage(parser, parse_stats)
+                                        : parser.program();
+    }
 
-    CoolSemantics semantics(&lexer, &parser);
+    phases.begin("semantics");
+    CoolSemantics semantics(interner, *token_payloads, program);
 
     auto semantics_result = semantics.run();
 
     if (!semantics_result.has_value()) {
         auto errors = semantics_result.error();
-        cout << "Semantic check failed with " << errors.size()
-             << " errors:" << endl;
+        out << "Semantic check failed with " << errors.size() << " errors:"
+            << endl;
         for (auto &error : errors) {
-            cout << error << endl;
+            out << error << endl;
+        }
+    } else {
+        phases.begin("codegen");
+        auto class_table = std::move(semantics_result.value());
+        CoolCodegen codegen(file_name, interner, std::move(class_table));
+
+        codegen.generate(out);
+    }
+
+    phases.begin("teardown");
+    parse_arena.release();
+    phases.end();
+
+    return true;
+}
+
+// Reports on `out` how much of the time to compile `file_paths` goes to
+// starting up: deserializing the ATNs of CoolLexer and CoolParser, and
+// filling their DFA caches.
+//
+// The ATNs and DFA caches are static, so they are shared by every file that
+// is compiled in the same process. The files are compiled twice, into a
+// null stream: the first pass starts cold, as a process that compiles one
+// file does, and the second pass finds everything warm, as the files after
+// the first one of a --batch run do.
+void startup_bench(const vector<string> &file_paths,
+                   const CompileOptions &options, ostream &out) {
+    using Clock = chrono::steady_clock;
+    auto microseconds = [](Clock::duration duration) {
+        return chrono::duration<double, micro>(duration).count();
+    };
+
+    ostream null_stream(nullptr);
+    TwoStageStats parse_stats;
+    AllocationPhases phases;
+
+    auto start = Clock::now();
+    CoolLexer::initialize();
+    CoolParser::initialize();
+    auto atn_time = Clock::now() - start;
+
+    vector<Clock::duration> cold_times;
+    vector<Clock::duration> warm_times;
+    for (auto *times : {&cold_times, &warm_times}) {
+        for (const auto &file_path : file_paths) {
+            start = Clock::now();
+            compile(file_path, options, parse_stats, phases, null_stream);
+            times->push_back(Clock::now() - start);
         }
+    }
+
+    auto average = [&](const vector<Clock::duration> &times) {
+        Clock::duration total{};
+        for (auto time : times) {
+            total += time;
+        }
+        return microseconds(total) / max<size_t>(times.size(), 1);
+    };
+
+    out << fixed << setprecision(1)
+        << "ATN deserialization:      " << microseconds(atn_time) << " us"
+        << endl;
+    if (!cold_times.empty()) {
+        out << "First file, cold DFA:     " << microseconds(cold_times[0])
+            << " us" << endl;
+    }
+    out << "Per file, first pass:     " << average(cold_times) << " us" << endl
+        << "Per file, warm DFA:       " << average(warm_times) << " us" << endl;
+}
+
+int main(int argc, const char *argv[]) {
+    vector<string> args(argv + 1, argv + argc);
+
+    // --diff-lexers checks that CoolFastLexer and CoolLexer produce the same
+    // tokens for each of the given files.
+    if (!args.empty() && args[0] == "--diff-lexers") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!diff_lexers(args[i], cerr)) {
+                ++failed;
+            }
+        }
+        cout << "Lexers differ on " << failed << " of " << args.size() - 1
+             << " files" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --scan reports the structural errors of each of the given files and how
+    // fast their StructuralIndex is built.
+    if (!args.empty() && args[0] == "--scan") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!scan_structure(args[i], cout)) {
+                ++failed;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --diff-parsers checks that PrattParser and CoolParser build the same
+    // tree for each of the given files.
+    if (!args.empty() && args[0] == "--diff-parsers") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!diff_parsers(args[i], cerr)) {
+                ++failed;
+            }
+        }
+        cout << "Parsers differ on " << failed << " of " << args.size() - 1
+             << " files" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --profile-parser profiles the decisions of CoolParser on each of the
+    // given files, and writes the profiles as a JSON array.
+    if (!args.empty() && args[0] == "--profile-parser") {
+        size_t failed = 0;
+        cout << "[";
+        for (size_t i = 1; i < args.size(); ++i) {
+            cout << (i == 1 ? "\n" : ",\n");
+            if (!profile_parser(args[i], cout)) {
+                ++failed;
+            }
+        }
+        cout << "\n]" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --fast-lexer selects CoolFastLexer instead of CoolLexer, and --pratt
+    // selects PrattParser instead of CoolParser. CoolParser parses in two
+    // stages, SLL then LL, unless --ll makes it use LL from the start.
+    // --parse-stats reports how often the LL stage was needed, and
+    // --alloc-stats the allocations of each phase of the compilation.
+    CompileOptions options;
+    bool print_parse_stats = false;
+    bool print_alloc_stats = false;
+    for (; !args.empty(); args.erase(args.begin())) {
+        if (args[0] == "--fast-lexer") {
+            options.use_fast_lexer = true;
+        } else if (args[0] == "--pratt") {
+            options.use_pratt_parser = true;
+        } else if (args[0] == "--ll") {
+            options.use_two_stage = false;
+        } else if (args[0] == "--parse-stats") {
+            print_parse_stats = true;
+        } else if (args[0] == "--alloc-stats") {
+            print_alloc_stats = true;
+        } else {
+            break;
+        }
+    }
+
+    // --startup-bench reports the cold and warm startup costs of compiling
+    // the given files.
+    if (!args.empty() && args[0] == "--startup-bench") {
+        startup_bench(vector<string>(args.begin() + 1, args.end()), options,
+                      cout);
         return 0;
     }
 
-    auto class_table = std::move(semantics_result.value());
-    CoolCodegen codegen(file_name, std::move(class_table));
+    TwoStageStats parse_stats;
+    AllocationPhases phases;
+    auto report_stats = [&]() {
+        if (print_parse_stats) {
+            cerr << "Two-stage parses: " << parse_stats.parses
+                 << ", LL fallbacks: " << parse_stats.ll_fallbacks << endl;
+        }
+        if (print_alloc_stats) {
+            phases.report(cerr);
+        }
+    };
+
+    // --batch compiles each of the given files into a .s file next to it. The
+    // files share one process, so only the first one pays for deserializing
+    // the ATNs and warming up the DFA caches of CoolLexer and CoolParser.
+    if (!args.empty() && args[0] == "--batch") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            auto output_path = fs::path(args[i]).replace_extension(".s");
+            ofstream output(output_path);
+            if (!output) {
+                cerr << "Could not open output file: " << output_path.string()
+                     << endl;
+                ++failed;
+                continue;
+            }
+            // compile() fails only before writing anything, e.g. on an input
+            // that does not open, so no empty .s file is left behind for it.
+            if (!compile(args[i], options, parse_stats, phases, output)) {
+                output.close();
+                fs::remove(output_path);
+                ++failed;
+            }
+        }
+        report_stats();
+        return failed == 0 ? 0 : 1;
+    }
 
-    codegen.generate(cout);
+    if (args.size() != 1) {
+        cerr << "Expecting exactly one argument: name of input file" << endl;
+        return 1;
+    }
 
-    return 0;
+    bool compiled = compile(args[0], options, parse_stats, phases, cout);
+    report_stats();
+    return compiled ? 0 : 1;
 }
@@ -0,0 +1,64 @@
+#include "intern/Interner.h"
+
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+Interner::Interner() {
+    // The order must match the constants in the header.
+    for (string_view name :
+         {"Object", "IO", "Int", "String", "Bool", "SELF_TYPE", "self"}) {
+        intern(name);
+    }
+    assert(name(SELF) == "self");
+}
+
+string_view Interner::store(string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+
+    char *bytes;
+    if (text.size() > BLOCK_SIZE / 4) {
+        // Long strings get a block of their own, so that the rest of the
+        // current block is not wasted.
+        blocks_.emplace_back(new char[text.size()]);
+        bytes = blocks_.back().get();
+    } else {
+        if (text.size() > free_size_) {
+            blocks_.emplace_back(new char[BLOCK_SIZE]);
+            free_ = blocks_.back().get();
+            free_size_ = BLOCK_SIZE;
+        }
+        bytes = free_;
+        free_ += text.size();
+        free_size_ -= text.size();
+    }
+
+    memcpy(bytes, text.data(), text.size());
+    return {bytes, text.size()};
+}
+
+Symbol Interner::intern(string_view text) {
+    auto it = symbols_.find(text);
+    if (it != symbols_.end()) {
+        return it->second;
+    }
+
+    // The key must be the stored copy, since `text` may point to temporary
+    // memory.
+    string_view stored = store(text);
+    Symbol symbol = names_.size();
+    names_.push_back(stored);
+    symbols_.emplace(stored, symbol);
+    return symbol;
+}
+
+optional<Symbol> Interner::find(string_view text) const {
+    auto it = symbols_.find(text);
+    if (it == symbols_.end()) {
+        return nullopt;
+    }
+    return it->second;
+}
@@ -0,0 +1,564 @@
+#include "lexer/CoolFastLexer.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// ----------------------- character classes -------------------------
+
+enum CharClass : uint8_t {
+    C_OTHER,
+    C_LOWER,
+    C_UPPER,
+    C_DIGIT,
+    C_UNDERSCORE,
+    C_SPACE,
+    C_SEMI,
+    C_OCURLY,
+    C_CCURLY,
+    C_OPAREN,
+    C_COMMA,
+    C_CPAREN,
+    C_COLON,
+    C_AT,
+    C_DOT,
+    C_PLUS,
+    C_MINUS,
+    C_STAR,
+    C_SLASH,
+    C_TILDE,
+    C_LT,
+    C_EQ,
+    C_GT,
+    C_QUOTE,
+    CHAR_CLASS_COUNT
+};
+
+constexpr auto char_classes = [] {
+    array<uint8_t, 256> classes{};
+    for (int c = 'a'; c <= 'z'; ++c) {
+        classes[c] = C_LOWER;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        classes[c] = C_UPPER;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        classes[c] = C_DIGIT;
+    }
+    classes['_'] = C_UNDERSCORE;
+    for (unsigned char c : {' ', '\f', '\v', '\t', '\r', '\n'}) {
+        classes[c] = C_SPACE;
+    }
+    classes[';'] = C_SEMI;
+    classes['{'] = C_OCURLY;
+    classes['}'] = C_CCURLY;
+    classes['('] = C_OPAREN;
+    classes[','] = C_COMMA;
+    classes[')'] = C_CPAREN;
+    classes[':'] = C_COLON;
+    classes['@'] = C_AT;
+    classes['.'] = C_DOT;
+    classes['+'] = C_PLUS;
+    classes['-'] = C_MINUS;
+    classes['*'] = C_STAR;
+    classes['/'] = C_SLASH;
+    classes['~'] = C_TILDE;
+    classes['<'] = C_LT;
+    classes['='] = C_EQ;
+    classes['>'] = C_GT;
+    classes['"'] = C_QUOTE;
+    return classes;
+}();
+
+// ----------------------- default mode DFA -------------------------
+
+// Every state other than S_DEAD and S_START accepts, so the longest match
+// ends right where the DFA dies.
+enum State : uint8_t {
+    S_DEAD,
+    S_START,
+    S_SEMI,
+    S_OCURLY,
+    S_CCURLY,
+    S_OPAREN,
+    S_COMMA,
+    S_CPAREN,
+    S_COLON,
+    S_AT,
+    S_DOT,
+    S_PLUS,
+    S_MINUS,
+    S_STAR,
+    S_SLASH,
+    S_TILDE,
+    S_LT,
+    S_EQ,
+    S_DARROW,
+    S_ASSIGN,
+    S_LE,
+    S_COMM_BEGIN,
+    S_COMM_END,
+    S_LCOMM_BEGIN,
+    S_STR_BEGIN,
+    S_INT,
+    S_OBJECTID,
+    S_TYPEID,
+    S_WS,
+    S_ERROR,
+    STATE_COUNT
+};
+
+using TransitionTable = array<array<uint8_t, CHAR_CLASS_COUNT>, STATE_COUNT>;
+
+constexpr TransitionTable transitions = [] {
+    TransitionTable table{};
+
+    auto &start = table[S_START];
+    start.fill(S_ERROR);
+    start[C_LOWER] = S_OBJECTID;
+    start[C_UPPER] = S_TYPEID;
+    start[C_DIGIT] = S_INT;
+    start[C_SPACE] = S_WS;
+    start[C_SEMI] = S_SEMI;
+    start[C_OCURLY] = S_OCURLY;
+    start[C_CCURLY] = S_CCURLY;
+    start[C_OPAREN] = S_OPAREN;
+    start[C_COMMA] = S_COMMA;
+    start[C_CPAREN] = S_CPAREN;
+    start[C_COLON] = S_COLON;
+    start[C_AT] = S_AT;
+    start[C_DOT] = S_DOT;
+    start[C_PLUS] = S_PLUS;
+    start[C_MINUS] = S_MINUS;
+    start[C_STAR] = S_STAR;
+    start[C_SLASH] = S_SLASH;
+    start[C_TILDE] = S_TILDE;
+    start[C_LT] = S_LT;
+    start[C_EQ] = S_EQ;
+    start[C_QUOTE] = S_STR_BEGIN;
+
+    table[S_OPAREN][C_STAR] = S_COMM_BEGIN;
+    table[S_STAR][C_CPAREN] = S_COMM_END;
+    table[S_MINUS][C_MINUS] = S_LCOMM_BEGIN;
+    table[S_LT][C_MINUS] = S_ASSIGN;
+    table[S_LT][C_EQ] = S_LE;
+    table[S_EQ][C_GT] = S_DARROW;
+
+    table[S_INT][C_DIGIT] = S_INT;
+    table[S_WS][C_SPACE] = S_WS;
+    for (auto identifier : {S_OBJECTID, S_TYPEID}) {
+        for (auto c : {C_LOWER, C_UPPER, C_DIGIT, C_UNDERSCORE}) {
+            table[identifier][c] = identifier;
+        }
+    }
+
+    return table;
+}();
+
+// Token types of the states that stand for a single token and need no further
+// handling. Zero for the rest.
+constexpr auto state_token_types = [] {
+    array<size_t, STATE_COUNT> types{};
+    types[S_SEMI] = CoolLexer::SEMI;
+    types[S_OCURLY] = CoolLexer::OCURLY;
+    types[S_CCURLY] = CoolLexer::CCURLY;
+    types[S_OPAREN] = CoolLexer::OPAREN;
+    types[S_COMMA] = CoolLexer::COMMA;
+    types[S_CPAREN] = CoolLexer::CPAREN;
+    types[S_COLON] = CoolLexer::COLON;
+    types[S_AT] = CoolLexer::AT;
+    types[S_DOT] = CoolLexer::DOT;
+    types[S_PLUS] = CoolLexer::PLUS;
+    types[S_MINUS] = CoolLexer::MINUS;
+    types[S_STAR] = CoolLexer::STAR;
+    types[S_SLASH] = CoolLexer::SLASH;
+    types[S_TILDE] = CoolLexer::TILDE;
+    types[S_LT] = CoolLexer::LT;
+    types[S_EQ] = CoolLexer::EQ;
+    types[S_DARROW] = CoolLexer::DARROW;
+    types[S_ASSIGN] = CoolLexer::ASSIGN;
+    types[S_LE] = CoolLexer::LE;
+    types[S_INT] = CoolLexer::INT_CONST;
+    return types;
+}();
+
+// ----------------------- keywords -------------------------
+
+struct Keyword {
+    string_view text;
+    size_t type;
+};
+
+constexpr array<Keyword, 19> keywords = {{
+    {"class", CoolLexer::CLASS},
+    {"else", CoolLexer::ELSE},
+    {"fi", CoolLexer::FI},
+    {"if", CoolLexer::IF},
+    {"in", CoolLexer::IN},
+    {"inherits", CoolLexer::INHERITS},
+    {"isvoid", CoolLexer::ISVOID},
+    {"let", CoolLexer::LET},
+    {"loop", CoolLexer::LOOP},
+    {"pool", CoolLexer::POOL},
+    {"then", CoolLexer::THEN},
+    {"while", CoolLexer::WHILE},
+    {"case", CoolLexer::CASE},
+    {"esac", CoolLexer::ESAC},
+    {"new", CoolLexer::NEW},
+    {"of", CoolLexer::OF},
+    {"not", CoolLexer::NOT},
+    {"true", CoolLexer::BOOL_CONST},
+    {"false", CoolLexer::BOOL_CONST},
+}};
+
+constexpr size_t MIN_KEYWORD_LENGTH = 2;
+constexpr size_t MAX_KEYWORD_LENGTH = 8;
+
+// Setting bit 5 maps upper case letters to lower case ones, leaves digits as
+// they are and maps '_' to DEL, which no keyword contains.
+constexpr unsigned char fold_case(char c) { return c | 0x20; }
+
+// A perfect hash of the keywords: no two of them share a slot, which is
+// checked when the table is built.
+constexpr size_t keyword_hash(char first, char last, size_t length) {
+    return (fold_case(first) * 8 + fold_case(last) * 5 + length) & 31;
+}
+
+constexpr auto keyword_table = [] {
+    array<Keyword, 32> table{};
+    for (const auto &keyword : keywords) {
+        auto &slot = table[keyword_hash(keyword.text.front(),
+                                        keyword.text.back(),
+                                        keyword.text.size())];
+        if (!slot.text.empty()) {
+            throw "keyword hash collision";
+        }
+        slot = keyword;
+    }
+    return table;
+}();
+
+// ----------------------- strings -------------------------
+
+// Whether a char of a string literal needs more than to be copied: it ends the
+// literal, starts an escape sequence or is an error.
+constexpr auto string_specials = [] {
+    array<bool, 256> specials{};
+    for (unsigned char c : {'"', '\\', '\n', '\0'}) {
+        specials[c] = true;
+    }
+    return specials;
+}();
+
+} // namespace
+
+CoolFastLexer::CoolFastLexer(MappedCharStream *input,
+                             const StructuralIndex *index)
+    : input_(input), index_(index), source_(this, input),
+      factory_(CommonTokenFactory::DEFAULT.get()), data_(input->data()),
+      size_(input->size()) {}
+
+void CoolFastLexer::advance_to(size_t end) {
+    for (; p_ < end; ++p_) {
+        if (data_[p_] == '\n') {
+            ++line_;
+            column_ = 0;
+        } else {
+            ++column_;
+        }
+    }
+}
+
+void CoolFastLexer::jump_to(size_t end) {
+    size_t newlines = index_->count_newlines(p_, end);
+    if (newlines == 0) {
+        column_ += end - p_;
+    } else {
+        line_ += newlines;
+        column_ = end - index_->line_start(end);
+    }
+    p_ = end;
+}
+
+unique_ptr<Token> CoolFastLexer::make_token(size_t type, size_t start,
+                                            size_t stop, size_t line,
+                                            size_t column, int payload) {
+    last_payload_ = payload;
+    if (keep_token_payloads_) {
+        token_payloads_.push_back(payload);
+    }
+
+    // The text is left empty, so that it is read lazily from the input, like
+    // it is for the tokens of CoolLexer.
+    return factory_->create(source_, type, "", Token::DEFAULT_CHANNEL, start,
+                            stop, line, column);
+}
+
+size_t CoolFastLexer::keyword_type(size_t start, size_t end,
+                                   size_t identifier_type) const {
+    size_t length = end - start;
+    if (length < MIN_KEYWORD_LENGTH || length > MAX_KEYWORD_LENGTH) {
+        return identifier_type;
+    }
+
+    const auto &keyword =
+        keyword_table[keyword_hash(data_[start], data_[end - 1], length)];
+    if (keyword.text.size() != length) {
+        return identifier_type;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (fold_case(data_[start + i]) != keyword.text[i]) {
+            return identifier_type;
+        }
+    }
+
+    // Keywords are case insensitive, except for the first letter of true and
+    // false, which must be lower case.
+    if (keyword.type == CoolLexer::BOOL_CONST &&
+        data_[start] != keyword.text.front()) {
+        return identifier_type;
+    }
+
+    return keyword.type;
+}
+
+unique_ptr<Token> CoolFastLexer::nextToken() {
+    while (p_ < size_) {
+        if (index_ != nullptr && index_->is_blank(p_)) {
+            jump_to(index_->skip_blank(p_));
+            continue;
+        }
+
+        size_t start = p_;
+        size_t line = line_;
+        size_t column = column_;
+
+        uint8_t state = S_START;
+        size_t end = p_;
+        while (end < size_) {
+            uint8_t next =
+                transitions[state][char_classes[(unsigned char)data_[end]]];
+            if (next == S_DEAD) {
+                break;
+            }
+            state = next;
+            ++end;
+        }
+        advance_to(end);
+
+        if (size_t type = state_token_types[state]) {
+            return make_token(type, start, end - 1, line, column);
+        }
+
+        switch (state) {
+        case S_OBJECTID:
+        case S_TYPEID: {
+            size_t type = keyword_type(start, end,
+                                       state == S_OBJECTID ? CoolLexer::OBJECTID
+                                                           : CoolLexer::TYPEID);
+            int payload = 0;
+            if (type == CoolLexer::BOOL_CONST) {
+                payload = data_[start] == 't';
+            } else if (type == CoolLexer::OBJECTID ||
+                       type == CoolLexer::TYPEID) {
+                payload = interner_->intern({data_ + start, end - start});
+            }
+            return make_token(type, start, end - 1, line, column, payload);
+        }
+        case S_WS:
+            break;
+        case S_STR_BEGIN:
+            if (auto token = lex_string(start)) {
+                return token;
+            }
+            break;
+        case S_COMM_BEGIN:
+            if (auto token = lex_comment()) {
+                return token;
+            }
+            break;
+        case S_LCOMM_BEGIN:
+            skip_line_comment();
+            break;
+        case S_COMM_END:
+            return make_token(
+                CoolLexer::ERROR, start, end - 1, line, column,
+                static_cast<int>(ErrorCode::UNMATCHED_COMMENT_END));
+        case S_ERROR:
+            return make_token(CoolLexer::ERROR, start, end - 1, line, column,
+                              static_cast<int>(ErrorCode::INVALID_SYMBOL));
+        default:
+            assert(false && "unhandled lexer state");
+        }
+    }
+
+    return make_token(Token::EOF, p_, p_ - 1, line_, column_);
+}
+
+unique_ptr<Token> CoolFastLexer::lex_string(size_t start) {
+    // Most literals have no escape sequences, so their contents can be
+    // interned straight from the source, without being decoded first.
+    size_t end = p_;
+    while (end < size_ &&
+           !string_specials[static_cast<unsigned char>(data_[end])]) {
+        ++end;
+    }
+    if (end < size_ && data_[end] == '"' && end - p_ <= MAX_STR_CONST) {
+        Symbol symbol = interner_->intern({data_ + p_, end - p_});
+        column_ += end - p_;
+        p_ = end;
+        size_t column = column_;
+        advance_to(p_ + 1);
+        return make_token(CoolLexer::STR_CONST, start, end, line_, column,
+                          symbol);
+    }
+
+    // Otherwise the literal is decoded char by char into string_buffer_.
+    string_buffer_.clear();
+
+    while (p_ < size_) {
+        size_t char_index = p_;
+        size_t line = line_;
+        size_t column = column_;
+        bool is_last = p_ + 1 == size_;
+
+        char c = data_[p_];
+        switch (c) {
+        case '"':
+            advance_to(p_ + 1);
+            // The token spans the whole literal, but is positioned at its
+            // closing quote, as in CoolLexer.
+            return make_token(CoolLexer::STR_CONST, start, char_index, line,
+                              column, intern_string());
+        case '\n':
+            advance_to(p_ + 1);
+            return make_token(
+                CoolLexer::ERROR, char_index, char_index, line, column,
+                static_cast<int>(ErrorCode::STR_CONTAINS_NEW_LINE));
+        case '\0':
+            advance_to(p_ + 1);
+            return lex_invalid_string(ErrorCode::STR_CONTAINS_NULL);
+        default:
+            break;
+        }
+
+        if (is_last) {
+            advance_to(p_ + 1);
+            return make_token(CoolLexer::ERROR, char_index, char_index, line,
+                              column,
+                              static_cast<int>(ErrorCode::STR_CONTAINS_EOF));
+        }
+
+        if (c == '\\') {
+            char escaped = data_[p_ + 1];
+            advance_to(p_ + 2);
+            switch (escaped) {
+            case 'n':
+                c = '\n';
+                break;
+            case 'b':
+                c = '\b';
+                break;
+            case 'f':
+                c = '\f';
+                break;
+            case 't':
+                c = '\t';
+                break;
+            case '\0':
+                return lex_invalid_string(ErrorCode::STR_CONTAINS_ESC_NULL);
+            default:
+                c = escaped;
+                break;
+            }
+        } else {
+            advance_to(p_ + 1);
+        }
+
+        if (string_buffer_.size() == MAX_STR_CONST) {
+            return lex_invalid_string(ErrorCode::STR_TOO_LONG);
+        }
+        string_buffer_.push_back(c);
+    }
+
+    // A quote or an escape sequence right before the end of the source is not
+    // reported by CoolLexer either.
+    return nullptr;
+}
+
+unique_ptr<Token> CoolFastLexer::lex_invalid_string(ErrorCode error_code) {
+    // The rest of the literal is skipped up to its closing quote or the end
+    // of the line. An escaped quote does end the literal here, as it does in
+    // the ESTR mode of CoolLexer.
+    while (p_ < size_) {
+        size_t char_index = p_;
+        size_t line = line_;
+        size_t column = column_;
+
+        char c = data_[p_];
+        advance_to(p_ + 1);
+        if (c == '"' || c == '\n') {
+            return make_token(CoolLexer::ERROR, char_index, char_index, line,
+                              column, static_cast<int>(error_code));
+        }
+    }
+
+    return nullptr;
+}
+
+unique_ptr<Token> CoolFastLexer::lex_comment() {
+    size_t depth = 1;
+
+    while (p_ + 1 < size_) {
+        char c = data_[p_];
+        char next = data_[p_ + 1];
+        if (c == '(' && next == '*') {
+            advance_to(p_ + 2);
+            ++depth;
+        } else if (c == '*' && next == ')') {
+            advance_to(p_ + 2);
+            if (--depth == 0) {
+                return nullptr;
+            }
+        } else {
+            advance_to(p_ + 1);
+        }
+    }
+
+    // A comment that is still open at its last char is reported at that char.
+    if (p_ < size_) {
+        size_t char_index = p_;
+        size_t line = line_;
+        size_t column = column_;
+        advance_to(p_ + 1);
+        return make_token(CoolLexer::ERROR, char_index, char_index, line,
+                          column,
+                          static_cast<int>(ErrorCode::COMMENT_CONTAINS_EOF));
+    }
+
+    return nullptr;
+}
+
+void CoolFastLexer::skip_line_comment() {
+    const void *new_line = memchr(data_ + p_, '\n', size_ - p_);
+    if (new_line == nullptr) {
+        column_ += size_ - p_;
+        p_ = size_;
+        return;
+    }
+
+    p_ = static_cast<const char *>(new_line) - data_ + 1;
+    ++line_;
+    column_ = 0;
+}
+
+Symbol CoolFastLexer::intern_string() {
+    return interner_->intern(string_buffer_);
+}
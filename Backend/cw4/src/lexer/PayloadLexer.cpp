@@ -0,0 +1,46 @@
+#include "lexer/PayloadLexer.h"
+
+using namespace std;
+using namespace antlr4;
+
+PayloadLexer::PayloadLexer(MappedCharStream *input)
+    : input_(input), lexer_(input) {}
+
+unique_ptr<Token> PayloadLexer::nextToken() {
+    unique_ptr<Token> token = lexer_.nextToken();
+    last_payload_ = take_payload(*token);
+    if (keep_token_payloads_) {
+        token_payloads_.push_back(last_payload_);
+    }
+    return token;
+}
+
+int PayloadLexer::take_payload(const Token &token) {
+    // CoolLexer keys its side data by the start char index of each token; a
+    // STR_CONST starts at its opening quote. The entries are erased once
+    // read, so that the maps don't grow with the input either.
+    int start = static_cast<int>(token.getStartIndex());
+    switch (token.getType()) {
+    case CoolLexer::BOOL_CONST: {
+        bool value = lexer_.get_bool_value(start);
+        lexer_.bool_values.erase(start);
+        return value;
+    }
+    case CoolLexer::OBJECTID:
+    case CoolLexer::TYPEID:
+        // Identifiers have no side data in CoolLexer.
+        return interner_->intern(input_->get_view(token));
+    case CoolLexer::STR_CONST: {
+        Symbol symbol = interner_->intern(lexer_.get_csl_text(start));
+        lexer_.string_tokens.erase(start);
+        return symbol;
+    }
+    case CoolLexer::ERROR: {
+        ErrorCode error_code = lexer_.get_error_code(start);
+        lexer_.error_codes.erase(start);
+        return static_cast<int>(error_code);
+    }
+    default:
+        return 0;
+    }
+}
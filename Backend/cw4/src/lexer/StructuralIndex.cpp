@@ -0,0 +1,512 @@
+#include "lexer/StructuralIndex.h"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STRUCTURAL_INDEX_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Maximum length of a constant string literal, same as in CoolLexer.
+constexpr size_t MAX_STR_CONST = 1024;
+
+// ----------------------- stage 1: classification -------------------------
+
+// The bitmaps of the chars in a block of 64 bytes. Bit j stands for byte j of
+// the block.
+struct Chars {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t newline = 0;
+    uint64_t nul = 0;
+    uint64_t space = 0;
+    uint64_t lbrace = 0;
+    uint64_t rbrace = 0;
+    uint64_t semi = 0;
+    uint64_t lparen = 0;
+    uint64_t rparen = 0;
+    uint64_t star = 0;
+    uint64_t minus = 0;
+    uint64_t lt = 0;
+};
+
+// Classifies the first `count` bytes at `p`, at most 64.
+Chars classify_scalar(const char *p, size_t count = 64) {
+    Chars block;
+    for (size_t j = 0; j < count; ++j) {
+        uint64_t bit = uint64_t(1) << j;
+        switch (p[j]) {
+        case '"':
+            block.quote |= bit;
+            break;
+        case '\\':
+            block.backslash |= bit;
+            break;
+        case '\n':
+            block.newline |= bit;
+            block.space |= bit;
+            break;
+        case '\0':
+            block.nul |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\v':
+        case '\f':
+        case '\r':
+            block.space |= bit;
+            break;
+        case '{':
+            block.lbrace |= bit;
+            break;
+        case '}':
+            block.rbrace |= bit;
+            break;
+        case ';':
+            block.semi |= bit;
+            break;
+        case '(':
+            block.lparen |= bit;
+            break;
+        case ')':
+            block.rparen |= bit;
+            break;
+        case '*':
+            block.star |= bit;
+            break;
+        case '-':
+            block.minus |= bit;
+            break;
+        case '<':
+            block.lt |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+    return block;
+}
+
+#ifdef STRUCTURAL_INDEX_X86
+
+Chars classify_sse2(const char *p) {
+    Chars block;
+    for (size_t k = 0; k < 64; k += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + k));
+        auto eq = [&](char c) {
+            uint32_t mask =
+                _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(c)));
+            return uint64_t(mask) << k;
+        };
+
+        // \t, \n, \v, \f and \r are the chars in [9, 13].
+        __m128i control = _mm_sub_epi8(x, _mm_set1_epi8(9));
+        __m128i is_control = _mm_cmpeq_epi8(
+            _mm_min_epu8(control, _mm_set1_epi8(4)), control);
+        uint64_t control_mask = uint32_t(_mm_movemask_epi8(is_control));
+
+        block.quote |= eq('"');
+        block.backslash |= eq('\\');
+        block.newline |= eq('\n');
+        block.nul |= eq('\0');
+        block.space |= eq(' ') | control_mask << k;
+        block.lbrace |= eq('{');
+        block.rbrace |= eq('}');
+        block.semi |= eq(';');
+        block.lparen |= eq('(');
+        block.rparen |= eq(')');
+        block.star |= eq('*');
+        block.minus |= eq('-');
+        block.lt |= eq('<');
+    }
+    return block;
+}
+
+__attribute__((target("avx2"))) Chars classify_avx2(const char *p) {
+    Chars block;
+    for (size_t k = 0; k < 64; k += 32) {
+        __m256i x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + k));
+        auto eq = [&](char c) __attribute__((target("avx2"))) {
+            uint32_t mask =
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(c)));
+            return uint64_t(mask) << k;
+        };
+
+        // \t, \n, \v, \f and \r are the chars in [9, 13].
+        __m256i control = _mm256_sub_epi8(x, _mm256_set1_epi8(9));
+        __m256i is_control = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(control, _mm256_set1_epi8(4)), control);
+        uint64_t control_mask = uint32_t(_mm256_movemask_epi8(is_control));
+
+        block.quote |= eq('"');
+        block.backslash |= eq('\\');
+        block.newline |= eq('\n');
+        block.nul |= eq('\0');
+        block.space |= eq(' ') | control_mask << k;
+        block.lbrace |= eq('{');
+        block.rbrace |= eq('}');
+        block.semi |= eq(';');
+        block.lparen |= eq('(');
+        block.rparen |= eq(')');
+        block.star |= eq('*');
+        block.minus |= eq('-');
+        block.lt |= eq('<');
+    }
+    return block;
+}
+
+#endif
+
+using Classifier = Chars (*)(const char *);
+
+Classifier select_classifier() {
+#ifdef STRUCTURAL_INDEX_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return classify_avx2;
+    }
+    return classify_sse2;
+#else
+    return [](const char *p) { return classify_scalar(p); };
+#endif
+}
+
+// What stage 2 needs to know of a block of 64 bytes: where its structural
+// chars and char sequences are. Sequences are marked at their first char.
+struct Block {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t newline;
+    uint64_t nul;
+    uint64_t space;
+    uint64_t lbrace;
+    uint64_t rbrace;
+    uint64_t semi;
+    uint64_t comment_open;  // (*
+    uint64_t comment_close; // *)
+    uint64_t line_comment;  // --
+    // The <- of an assignment that is followed by a -, which must not be taken
+    // for the start of a line comment.
+    uint64_t assign_minus;  // <--
+};
+
+Block make_block(const Chars &chars, const Chars &next) {
+    // Bit j of the result is set when byte j + 1 is set in `mask`.
+    auto followed_by = [&](uint64_t Chars::*mask) {
+        return chars.*mask >> 1 | next.*mask << 63;
+    };
+
+    uint64_t line_comment = chars.minus & followed_by(&Chars::minus);
+    uint64_t next_line_comment = next.minus & next.minus >> 1;
+
+    return {
+        chars.quote,
+        chars.backslash,
+        chars.newline,
+        chars.nul,
+        chars.space,
+        chars.lbrace,
+        chars.rbrace,
+        chars.semi,
+        chars.lparen & followed_by(&Chars::star),
+        chars.star & followed_by(&Chars::rparen),
+        line_comment,
+        chars.lt & (line_comment >> 1 | next_line_comment << 63),
+    };
+}
+
+vector<Block> classify(const char *data, size_t size) {
+    static const Classifier classifier = select_classifier();
+
+    size_t full_blocks = size / 64;
+    // The vector loads would read past the end of the source in the last
+    // block, so it is classified one byte at a time.
+    auto classify_block = [&](size_t k) {
+        if (k < full_blocks) {
+            return classifier(data + k * 64);
+        }
+        if (k == full_blocks) {
+            return classify_scalar(data + k * 64, size % 64);
+        }
+        return Chars{};
+    };
+
+    // One more block than needed, so that the index one past the end of the
+    // source has a block too. A block is completed once the next one is
+    // classified, since char sequences may cross them.
+    vector<Block> blocks;
+    blocks.reserve(full_blocks + 1);
+    Chars chars = classify_block(0);
+    for (size_t k = 0; k <= full_blocks; ++k) {
+        Chars next = classify_block(k + 1);
+        blocks.push_back(make_block(chars, next));
+        chars = next;
+    }
+
+    return blocks;
+}
+
+// ----------------------- stage 2: structure -------------------------
+
+// The lexer modes that change how the structural chars are read.
+enum class Mode {
+    CODE,
+    STR,
+    // A string literal after an error, up to its closing quote or the end of
+    // the line. Backslashes escape nothing here.
+    ESTR,
+    COMM,
+    LCOMM,
+};
+
+// The structural chars that matter in each mode.
+uint64_t events(const Block &block, Mode mode) {
+    switch (mode) {
+    case Mode::CODE:
+        return block.quote | block.comment_open | block.comment_close |
+               block.line_comment | block.assign_minus;
+    case Mode::STR:
+        return block.quote | block.backslash | block.newline | block.nul;
+    case Mode::ESTR:
+        return block.quote | block.newline;
+    case Mode::COMM:
+        return block.comment_open | block.comment_close;
+    case Mode::LCOMM:
+        return block.newline;
+    }
+    return 0;
+}
+
+bool has_bit(uint64_t mask, size_t char_index) {
+    return mask >> (char_index % 64) & 1;
+}
+
+// Sets or clears the bits for the bytes in [begin, end).
+void set_bits(vector<uint64_t> &bits, size_t begin, size_t end, bool value) {
+    for (size_t i = begin; i < end;) {
+        size_t k = i / 64;
+        size_t bit = i % 64;
+        size_t count = min<size_t>(64 - bit, end - i);
+        uint64_t mask =
+            (count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << bit;
+        if (value) {
+            bits[k] |= mask;
+        } else {
+            bits[k] &= ~mask;
+        }
+        i += count;
+    }
+}
+
+} // namespace
+
+StructuralIndex::StructuralIndex(const char *data, size_t size)
+    : size_(size) {
+    vector<Block> blocks = classify(data, size);
+
+    newlines_.resize(blocks.size());
+    blank_.resize(blocks.size());
+    // The bytes of strings and comments, where braces and semicolons do not
+    // count.
+    vector<uint64_t> not_code(blocks.size());
+    for (size_t k = 0; k < blocks.size(); ++k) {
+        newlines_[k] = blocks[k].newline;
+        blank_[k] = blocks[k].space;
+    }
+
+    // Returns the index of the first event at or after `from` in the given
+    // mode, or `size` if there is none.
+    auto next_event = [&](size_t from, Mode mode) {
+        if (from >= size) {
+            return size;
+        }
+        size_t k = from / 64;
+        uint64_t mask = events(blocks[k], mode) & (~uint64_t(0) << from % 64);
+        while (mask == 0) {
+            if (++k == blocks.size()) {
+                return size;
+            }
+            mask = events(blocks[k], mode);
+        }
+        return min(k * 64 + countr_zero(mask), size);
+    };
+
+    Mode mode = Mode::CODE;
+    // Index of the opening char of the current string or comment.
+    size_t start = 0;
+    size_t comment_depth = 0;
+    size_t escapes = 0;
+
+    size_t i;
+    for (size_t p = 0; (i = next_event(p, mode)) < size;) {
+        const Block &block = blocks[i / 64];
+        p = i + 1;
+
+        switch (mode) {
+        case Mode::CODE:
+            if (has_bit(block.quote, i)) {
+                mode = Mode::STR;
+                start = i;
+                escapes = 0;
+            } else if (has_bit(block.comment_open, i)) {
+                mode = Mode::COMM;
+                start = i;
+                comment_depth = 1;
+                p = i + 2;
+            } else if (has_bit(block.comment_close, i)) {
+                errors_.push_back({ErrorKind::UNMATCHED_COMMENT_END, i});
+                p = i + 2;
+            } else if (has_bit(block.line_comment, i)) {
+                mode = Mode::LCOMM;
+                start = i;
+                p = i + 2;
+            } else {
+                p = i + 2;
+            }
+            break;
+
+        case Mode::STR:
+            if (has_bit(block.backslash, i)) {
+                // The number of chars added to the string so far. Once there
+                // are too many, CoolLexer stops decoding escape sequences.
+                size_t length = i - start - 1 - escapes;
+                if (length > MAX_STR_CONST) {
+                    mode = Mode::ESTR;
+                    break;
+                }
+                ++escapes;
+                p = i + 2;
+                if (length == MAX_STR_CONST ||
+                    (i + 1 < size && data[i + 1] == '\0')) {
+                    mode = Mode::ESTR;
+                }
+                break;
+            }
+            if (has_bit(block.nul, i)) {
+                mode = Mode::ESTR;
+                break;
+            }
+            [[fallthrough]];
+
+        case Mode::ESTR:
+            // Both a quote and a new line end the literal, with or without an
+            // error.
+            set_bits(blank_, start, i + 1, false);
+            set_bits(not_code, start, i + 1, true);
+            mode = Mode::CODE;
+            break;
+
+        case Mode::COMM:
+            p = i + 2;
+            if (has_bit(block.comment_open, i)) {
+                ++comment_depth;
+            } else if (--comment_depth == 0) {
+                set_bits(blank_, start, i + 2, true);
+                set_bits(not_code, start, i + 2, true);
+                mode = Mode::CODE;
+            }
+            break;
+
+        case Mode::LCOMM:
+            set_bits(blank_, start, i, true);
+            set_bits(not_code, start, i, true);
+            mode = Mode::CODE;
+            break;
+        }
+    }
+
+    switch (mode) {
+    case Mode::CODE:
+        break;
+    case Mode::STR:
+    case Mode::ESTR:
+        set_bits(blank_, start, size, false);
+        set_bits(not_code, start, size, true);
+        errors_.push_back({ErrorKind::STR_CONTAINS_EOF, size - 1});
+        break;
+    case Mode::COMM:
+        set_bits(blank_, start, size, false);
+        set_bits(not_code, start, size, true);
+        errors_.push_back({ErrorKind::COMMENT_CONTAINS_EOF, size - 1});
+        break;
+    case Mode::LCOMM:
+        set_bits(blank_, start, size, true);
+        set_bits(not_code, start, size, true);
+        break;
+    }
+
+    // The braces are counted a word at a time. Only in the words where the
+    // depth may drop to zero are they walked one by one, to find the
+    // semicolons that end top-level classes.
+    size_t brace_depth = 0;
+    for (size_t k = 0; k < blocks.size(); ++k) {
+        uint64_t code = ~not_code[k];
+        uint64_t opening = blocks[k].lbrace & code;
+        uint64_t closing = blocks[k].rbrace & code;
+        size_t closing_count = popcount(closing);
+        if (brace_depth > closing_count) {
+            brace_depth += popcount(opening) - closing_count;
+            continue;
+        }
+
+        uint64_t mask = opening | closing | (blocks[k].semi & code);
+        for (; mask != 0; mask &= mask - 1) {
+            uint64_t bit = mask & -mask;
+            if (opening & bit) {
+                ++brace_depth;
+            } else if (closing & bit) {
+                if (brace_depth > 0) {
+                    --brace_depth;
+                }
+            } else if (brace_depth == 0) {
+                class_ends_.push_back(k * 64 + countr_zero(mask) + 1);
+            }
+        }
+    }
+}
+
+size_t StructuralIndex::skip_blank(size_t char_index) const {
+    if (char_index >= size_) {
+        return size_;
+    }
+    size_t k = char_index / 64;
+    uint64_t mask = ~blank_[k] & (~uint64_t(0) << char_index % 64);
+    while (mask == 0) {
+        mask = ~blank_[++k];
+    }
+    return min(k * 64 + countr_zero(mask), size_);
+}
+
+size_t StructuralIndex::count_newlines(size_t begin, size_t end) const {
+    if (begin >= end) {
+        return 0;
+    }
+    size_t first = begin / 64;
+    size_t last = end / 64;
+    uint64_t begin_mask = ~uint64_t(0) << begin % 64;
+    uint64_t end_mask = (uint64_t(1) << end % 64) - 1;
+    if (first == last) {
+        return popcount(newlines_[first] & begin_mask & end_mask);
+    }
+    size_t count = popcount(newlines_[first] & begin_mask);
+    for (size_t k = first + 1; k < last; ++k) {
+        count += popcount(newlines_[k]);
+    }
+    return count + popcount(newlines_[last] & end_mask);
+}
+
+size_t StructuralIndex::line_start(size_t char_index) const {
+    size_t k = char_index / 64;
+    uint64_t mask = newlines_[k] & ((uint64_t(1) << char_index % 64) - 1);
+    while (mask == 0) {
+        if (k == 0) {
+            return 0;
+        }
+        mask = newlines_[--k];
+    }
+    return k * 64 + (63 - countl_zero(mask)) + 1;
+}
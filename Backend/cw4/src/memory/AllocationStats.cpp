@@ -0,0 +1,104 @@
+#include "memory/AllocationStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#include <malloc.h>
+
+using namespace std;
+
+namespace {
+
+// Relaxed, since the counts are only read between phases.
+atomic<size_t> allocations{0};
+atomic<size_t> deallocations{0};
+atomic<size_t> bytes_allocated{0};
+atomic<size_t> bytes_live{0};
+atomic<size_t> peak_bytes_live{0};
+
+void raise_peak(size_t live) {
+    size_t peak = peak_bytes_live.load(memory_order_relaxed);
+    while (live > peak && !peak_bytes_live.compare_exchange_weak(
+                              peak, live, memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    bytes_allocated.fetch_add(size, memory_order_relaxed);
+    // malloc(0) may return null, which operator new must not.
+    if (void *memory = malloc(size == 0 ? 1 : size)) {
+        size_t usable = malloc_usable_size(memory);
+        raise_peak(bytes_live.fetch_add(usable, memory_order_relaxed) + usable);
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    if (memory != nullptr) {
+        deallocations.fetch_add(1, memory_order_relaxed);
+        bytes_live.fetch_sub(malloc_usable_size(memory), memory_order_relaxed);
+    }
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+AllocationCounts allocation_counts() {
+    return {allocations.load(memory_order_relaxed),
+            deallocations.load(memory_order_relaxed),
+            bytes_allocated.load(memory_order_relaxed),
+            bytes_live.load(memory_order_relaxed),
+            peak_bytes_live.load(memory_order_relaxed)};
+}
+
+void reset_peak_bytes_live() {
+    peak_bytes_live.store(bytes_live.load(memory_order_relaxed),
+                          memory_order_relaxed);
+}
+
+void AllocationPhases::end_current() {
+    if (current_ < 0) {
+        return;
+    }
+    AllocationCounts now = allocation_counts();
+    AllocationCounts &counts = phases_[current_].counts;
+    counts.allocations += now.allocations - current_start_.allocations;
+    counts.deallocations += now.deallocations - current_start_.deallocations;
+    counts.bytes_allocated +=
+        now.bytes_allocated - current_start_.bytes_allocated;
+    current_ = -1;
+}
+
+void AllocationPhases::begin(const string &name) {
+    end_current();
+    auto it = find_if(phases_.begin(), phases_.end(),
+                      [&](const Phase &phase) { return phase.name == name; });
+    if (it == phases_.end()) {
+        it = phases_.insert(it, {name, {}});
+    }
+    current_ = it - phases_.begin();
+    current_start_ = allocation_counts();
+}
+
+void AllocationPhases::end() { end_current(); }
+
+void AllocationPhases::report(ostream &out) {
+    end_current();
+    out << left << setw(12) << "Phase" << right << setw(12) << "allocs"
+        << setw(12) << "frees" << setw(14) << "bytes" << endl;
+    for (const auto &phase : phases_) {
+        out << left << setw(12) << phase.name << right << setw(12)
+            << phase.counts.allocations << setw(12)
+            << phase.counts.deallocations << setw(14)
+            << phase.counts.bytes_allocated << endl;
+    }
+}
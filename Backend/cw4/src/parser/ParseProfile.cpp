@@ -0,0 +1,103 @@
+#include "parser/ParseProfile.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include "antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "CoolParser.h"
+#include "input/MappedCharStream.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+long long nanoseconds(Clock::duration duration) {
+    return chrono::duration_cast<chrono::nanoseconds>(duration).count();
+}
+
+// Writes `text` as a JSON string, quoted and escaped.
+void write_string(ostream &out, const string &text) {
+    out << '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c < 0x20) {
+            char escape[7];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out << escape;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void write_decision(ostream &out, CoolParser &parser,
+                    const atn::DecisionInfo &info) {
+    size_t rule = parser.getATN().getDecisionState(info.decision)->ruleIndex;
+    out << "{\"decision\": " << info.decision << ", \"rule\": ";
+    write_string(out, parser.getRuleNames()[rule]);
+    out << ", \"invocations\": " << info.invocations
+        << ", \"time_ns\": " << info.timeInPrediction
+        << ", \"sll_total_look\": " << info.SLL_TotalLook
+        << ", \"sll_max_look\": " << info.SLL_MaxLook
+        << ", \"ll_fallbacks\": " << info.LL_Fallback
+        << ", \"ll_total_look\": " << info.LL_TotalLook
+        << ", \"ll_max_look\": " << info.LL_MaxLook
+        << ", \"ambiguities\": " << info.ambiguities.size()
+        << ", \"context_sensitivities\": " << info.contextSensitivities.size()
+        << ", \"errors\": " << info.errors.size() << "}";
+}
+
+} // namespace
+
+bool profile_parser(const string &file_path, ostream &out) {
+    out << "{\"file\": ";
+    write_string(out, file_path);
+
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        out << ", \"error\": \"could not open file\"}";
+        return false;
+    }
+
+    CoolLexer lexer(&input);
+    CommonTokenStream tokens(&lexer);
+    auto lex_start = Clock::now();
+    tokens.fill();
+    auto lex_time = Clock::now() - lex_start;
+
+    CoolParser parser(&tokens);
+    parser.removeErrorListeners();
+    parser.setProfile(true);
+    auto parse_start = Clock::now();
+    parser.program();
+    auto parse_time = Clock::now() - parse_start;
+
+    atn::ParseInfo parse_info(
+        parser.getInterpreter<atn::ProfilingATNSimulator>());
+    size_t syntax_errors = parser.getNumberOfSyntaxErrors();
+    out << ", \"tokens\": " << tokens.size()
+        << ", \"syntax_errors\": " << syntax_errors
+        << ", \"lex_ns\": " << nanoseconds(lex_time)
+        << ", \"parse_ns\": " << nanoseconds(parse_time)
+        << ", \"prediction_ns\": " << parse_info.getTotalTimeInPrediction()
+        << ", \"dfa_states\": " << parse_info.getDFASize()
+        << ", \"decisions\": [";
+
+    // Decisions that were never predicted are listed too, so that profiles
+    // of the same grammar line up.
+    const auto &decisions = parser.getInterpreter<atn::ProfilingATNSimulator>()
+                                ->getDecisionInfo();
+    for (size_t i = 0; i < decisions.size(); ++i) {
+        out << (i == 0 ? "\n  " : ",\n  ");
+        write_decision(out, parser, decisions[i]);
+    }
+    out << "\n]}";
+    return syntax_errors == 0;
+}
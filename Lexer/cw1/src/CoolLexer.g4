@@ -14,8 +14,28 @@ channels { COMMENTS, WHITESPACES }
     // Stores the current CSL as it's being built.
     std::vector<char> string_buffer;
 
-    // Maps token start indices to their corresponding string values.
-    std::map<int, std::string> string_values;
+    // ----------------------- token payloads -------------------------
+
+    // The payload of every emitted token, indexed by token index: the value of
+    // a BOOL_CONST, the index of the string value of a STR_CONST or the error
+    // code of an ERROR. Every other token gets 0. The token type tells how the
+    // payload is to be read.
+    std::vector<int> token_payloads;
+
+    // The payload of the token being matched. Actions set it and emit() moves
+    // it into token_payloads.
+    int pending_payload = 0;
+
+    using antlr4::Lexer::emit;
+
+    void emit(std::unique_ptr<antlr4::Token> token) override {
+        token_payloads.push_back(pending_payload);
+        pending_payload = 0;
+        antlr4::Lexer::emit(std::move(token));
+    }
+
+    // The values of the string constants, in the order they are found.
+    std::vector<std::string> string_values;
 
     // Calculates the size of the buffer by counting escape sequences as single characters.
     size_t get_string_buffer_size() {
@@ -117,27 +137,25 @@ channels { COMMENTS, WHITESPACES }
 
     }
 
-    // Associates the built string with the token's start index
+    // Associates the built string with the current token
     void assoc_string_with_token() {
-        string_values[tokenStartCharIndex] = std::string(string_buffer.begin(), string_buffer.end());
+        pending_payload = string_values.size();
+        string_values.emplace_back(string_buffer.begin(), string_buffer.end());
     }
 
-    // Retrieves the string value associated with a token's start index
-    std::string get_string_value(int token_start_char_index) {
-        return string_values.at(token_start_char_index);
+    // Retrieves the string value of the token with the given index
+    const std::string &get_string_value(size_t token_index) {
+        return string_values[token_payloads[token_index]];
     }
 
-    // Boolean constants handling
-    std::map<int, bool> bool_values;
-
-    // Associates a boolean value with the token's start index
+    // Associates a boolean value with the current token
     void assoc_bool_with_token(bool value) {
-        bool_values[tokenStartCharIndex] = value;
+        pending_payload = value;
     }
 
-    // Retrieves the boolean value associated with a token's start index
-    bool get_bool_value(int token_start_char_index) {
-        return bool_values.at(token_start_char_index);
+    // Retrieves the boolean value of the token with the given index
+    bool get_bool_value(size_t token_index) {
+        return token_payloads[token_index] != 0;
     }
 
     // Error types for tracking lexer errors
@@ -153,18 +171,14 @@ channels { COMMENTS, WHITESPACES }
         INVALID_SYMBOL_NON_PRINTABLE,
     };
 
-    // Maps token start indices to their corresponding error codes,
-    // so line numbers can be retrieved later
-    std::map<int, ErrorCode> err_codes;
-
     // Registers an error code for the current token
     void register_error(ErrorCode code) {
-        err_codes[tokenStartCharIndex] = code;
+        pending_payload = static_cast<int>(code);
     }
 
-    // Retrieves the error code associated with a token's start index
-    ErrorCode get_error_code(int token_start_char_index) {
-        return err_codes.at(token_start_char_index);
+    // Retrieves the error code of the token with the given index
+    ErrorCode get_error_code(size_t token_index) {
+        return static_cast<ErrorCode>(token_payloads[token_index]);
     }
 
 }
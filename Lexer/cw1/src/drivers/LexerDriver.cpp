@@ -1,21 +1,26 @@
-#include <cctype>
-#include <iomanip>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <unistd.h>
+
 #include "antlr4-runtime/antlr4-runtime.h"
 
+#include "BufferedWriter.h"
 #include "CoolLexer.h"
+#include "MappedCharStream.h"
+#include "TokenFile.h"
 
 using namespace std;
 using namespace antlr4;
 
-string cool_token_to_string(Token *token) {
-    auto token_type = token->getType();
-
+string_view cool_token_to_string(int token_type) {
     switch (token_type) {
-        case static_cast<size_t>(-1) : return "EOF";
+        case -1 : return "EOF";
 
         case CoolLexer::SEMI: return "';'";
         case CoolLexer::COLON: return "':'";
@@ -62,11 +67,11 @@ string cool_token_to_string(Token *token) {
         case CoolLexer::ERROR: return "ERROR";
         case CoolLexer::STR_CONST: return "STR_CONST";
 
-        default : return "<Invalid Token>: " + token->toString();
+        default : return "<Invalid Token>";
     }
 }
 
-string cool_error_code_to_string(CoolLexer::ErrorCode code) {
+string_view cool_error_code_to_string(CoolLexer::ErrorCode code) {
     switch (code) {
         case CoolLexer::ErrorCode::UNMATCHED_COMMENT:
             return "Unmatched";
@@ -89,60 +94,160 @@ string cool_error_code_to_string(CoolLexer::ErrorCode code) {
     }
 }
 
-void dump_cool_token(CoolLexer *lexer, ostream &out, Token *token) {
-    if (token->getType() == static_cast<size_t>(-1)) {
+// Writes a non-printable char in <0xXX> format, like
+// CoolLexer::convert_non_printable_to_hex.
+void write_hex(BufferedWriter &out, char c) {
+    static constexpr char digits[] = "0123456789abcdef";
+    unsigned char byte = c;
+    out.write("<0x");
+    out.write(digits[byte >> 4]);
+    out.write(digits[byte & 0xF]);
+    out.write('>');
+}
+
+void dump_cool_token(const TokenTable &table, BufferedWriter &out,
+                     size_t token_index) {
+    const TokenRecord &token = table.tokens[token_index];
+    if (token.type == -1) {
         return;
     }
 
-    out << "#" << token->getLine() << " " << cool_token_to_string(token);
+    out.write('#');
+    out.write_decimal(token.line);
+    out.write(' ');
+    out.write(cool_token_to_string(token.type));
 
-    auto token_type = token->getType();
-    auto token_start_char_index = token->getStartIndex();
-    switch (token_type) {
+    string_view text = table.text(token);
+    switch (token.type) {
     case CoolLexer::BOOL_CONST:
-        out << " "
-            << (lexer->get_bool_value(token_start_char_index) ? "true"
-                                                              : "false");
+        out.write(' ');
+        out.write(table.get_bool_value(token_index) ? "true" : "false");
         break;
     case CoolLexer::TYPEID:
     case CoolLexer::OBJECTID:
     case CoolLexer::INT_CONST:
-        out << " " << token->getText();
+        out.write(' ');
+        out.write(text);
         break;
     case CoolLexer::ERROR: {
-        CoolLexer::ErrorCode error_code = lexer->get_error_code(token_start_char_index);
+        CoolLexer::ErrorCode error_code = table.get_error_code(token_index);
         // Prints out a non-printable in <0xXX> format
         if (error_code == CoolLexer::ErrorCode::INVALID_SYMBOL_NON_PRINTABLE) {
-            out << ": " << cool_error_code_to_string(CoolLexer::ErrorCode::INVALID_SYMBOL) << " \"" << lexer->convert_non_printable_to_hex(token->getText()[0]) << "\"";
+            out.write(": ");
+            out.write(cool_error_code_to_string(CoolLexer::ErrorCode::INVALID_SYMBOL));
+            out.write(" \"");
+            write_hex(out, text[0]);
+            out.write('"');
         }
         else if (error_code == CoolLexer::ErrorCode::INVALID_SYMBOL) {
+            out.write(": ");
+            out.write(cool_error_code_to_string(error_code));
+            out.write(" \"");
             // Prints out escape sequences properly
-            if (token->getText()[0] == '\\')
-                out << ": " << cool_error_code_to_string(error_code) << " \"\\" << token->getText() << "\"";
-            // Prints out normal characters
-            else
-                out << ": " << cool_error_code_to_string(error_code) << " \"" << token->getText() << "\"";
+            if (text[0] == '\\')
+                out.write('\\');
+            out.write(text);
+            out.write('"');
         }
         // Details for unmatched comment
         else if (error_code == CoolLexer::ErrorCode::UNMATCHED_COMMENT) {
-            out << ": " << cool_error_code_to_string(error_code) << " " << token->getText();
+            out.write(": ");
+            out.write(cool_error_code_to_string(error_code));
+            out.write(' ');
+            out.write(text);
         // Common case
         } else {
-            out << ": " << cool_error_code_to_string(error_code);
+            out.write(": ");
+            out.write(cool_error_code_to_string(error_code));
         }
         break;
     }
     case CoolLexer::STR_CONST:
-        out << " " << "\"" << lexer->get_string_value(token_start_char_index) << "\"";
+        out.write(" \"");
+        out.write(table.get_string_value(token_index));
+        out.write('"');
         break;
     }
     
-    out << endl;
+    out.write('\n');
+}
+
+// Renders the tokens of `table` as text on stdout.
+void dump_cool_tokens(const TokenTable &table) {
+    BufferedWriter out(STDOUT_FILENO);
+
+    for (size_t i = 0; i < table.tokens.size(); ++i) {
+        if (table.tokens[i].channel == Token::DEFAULT_CHANNEL) 
+            dump_cool_token(table, out, i);
+
+        /**
+         * @note Uncomment to see dumped comments or whitespaces tokens on the hidden channels
+         */
+        // if (table.tokens[i].channel == CoolLexer::COMMENTS)
+        //     dump_cool_token(table, out, i);
+        // if (table.tokens[i].channel == CoolLexer::WHITESPACES)
+        //     dump_cool_token(table, out, i);
+    };
+}
+
+void print_usage() {
+    cerr << "Usage: lexer [--ctok <out.ctok>] [file]" << endl
+         << "       lexer --from-ctok <in.ctok>" << endl;
 }
 
 int main(int argc, const char *argv[]) {
-    ANTLRInputStream input(cin);
-    CoolLexer lexer(&input);
+    vector<string_view> args(argv + 1, argv + argc);
+
+    // Renders a token file written by an earlier run with --ctok.
+    if (!args.empty() && args[0] == "--from-ctok") {
+        if (args.size() != 2) {
+            print_usage();
+            return 1;
+        }
+        TokenFile token_file{string(args[1])};
+        if (!token_file.is_valid()) {
+            cerr << "Could not read token file " << args[1] << ": "
+                 << token_file.error() << endl;
+            return 1;
+        }
+        dump_cool_tokens(token_file.table());
+        return 0;
+    }
+
+    // With --ctok the tokens are stored in a binary token file instead of
+    // being printed.
+    string ctok_path;
+    if (!args.empty() && args[0] == "--ctok") {
+        if (args.size() < 2) {
+            print_usage();
+            return 1;
+        }
+        ctok_path = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+
+    if (args.size() > 1) {
+        cerr << "Expecting at most one argument: name of input file" << endl;
+        return 1;
+    }
+
+    // A file given on the command line is mapped into memory; otherwise the
+    // source is read from stdin, which cannot be mapped.
+    string stdin_data;
+    unique_ptr<MappedCharStream> input;
+    if (args.size() == 1) {
+        input = make_unique<MappedCharStream>(string(args[0]));
+        if (!input->is_open()) {
+            cerr << "Could not open input file: " << args[0] << endl;
+            return 1;
+        }
+    } else {
+        stdin_data.assign(istreambuf_iterator<char>(cin),
+                          istreambuf_iterator<char>());
+        input = make_unique<MappedCharStream>(stdin_data, "<stdin>");
+    }
+
+    CoolLexer lexer(input.get());
 
     // За временно скриване на грешките:
     // lexer.removeErrorListener(&ConsoleErrorListener::INSTANCE);
@@ -151,19 +256,20 @@ int main(int argc, const char *argv[]) {
 
     tokenStream.fill(); // Изчитане на всички жетони.
 
-    vector<Token *> tokens = tokenStream.getTokens();
-    for (Token *token : tokens) {
-        if (token->getChannel() == Token::DEFAULT_CHANNEL) 
-            dump_cool_token(&lexer, cout, token);
+    TokenTable table = TokenTable::from_lexer(
+        tokenStream.getTokens(), lexer, string_view(input->data(), input->size()),
+        input->getSourceName());
 
-        /**
-         * @note Uncomment to see dumped comments or whitespaces tokens on the hidden channels
-         */
-        // if (token->getChannel() == CoolLexer::COMMENTS)
-        //     dump_cool_token(&lexer, cout, token);
-        // if (token->getChannel() == CoolLexer::WHITESPACES)
-        //     dump_cool_token(&lexer, cout, token);
-    };
+    if (!ctok_path.empty()) {
+        if (!table.write(ctok_path)) {
+            cerr << "Could not write token file " << ctok_path << ": "
+                 << strerror(errno) << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    dump_cool_tokens(table);
 
     return 0;
 }
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Writes to a file descriptor through a large buffer.
+//
+// Unlike an ostream, no locale or formatting state is consulted on the way,
+// and there is one system call per buffer instead of one per flush.
+class BufferedWriter {
+  private:
+    int fd_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    bool failed_ = false;
+
+    void write_all(const char *bytes, size_t size);
+
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 20;
+
+    // Does not take ownership of `fd`.
+    explicit BufferedWriter(int fd, size_t capacity = DEFAULT_CAPACITY);
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    void write(const void *bytes, size_t size);
+    void write(std::string_view text) { write(text.data(), text.size()); }
+
+    void write(char c) {
+        if (used_ == buffer_.size()) {
+            flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    // Writes `value` in decimal.
+    void write_decimal(uint64_t value);
+
+    // Writes out the buffered bytes. Returns whether every write so far
+    // succeeded.
+    bool flush();
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime/antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "MappedCharStream.h"
+
+// The header of a .ctok file. See TokenTable for the layout of the rest.
+struct TokenFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t token_count;
+    uint64_t string_count;
+    uint64_t source_size;
+    uint64_t source_name_size;
+};
+
+// A token as stored in a .ctok file.
+struct TokenRecord {
+    // The token type, -1 for EOF.
+    int32_t type;
+    uint32_t channel;
+    uint32_t line;
+    uint32_t column;
+    // The span of the token text in the source.
+    uint32_t start;
+    uint32_t length;
+    // The payload of the token, as in CoolLexer::token_payloads: the value of
+    // a BOOL_CONST, the string table index of a STR_CONST or the error code of
+    // an ERROR.
+    int32_t payload;
+};
+
+// The tokens of a COOL source, with everything needed to print or parse them
+// without lexing the source again: the string table and the source text.
+//
+// This is the in-memory form of a .ctok file, which is laid out as follows,
+// with all integers in host byte order:
+//
+//   TokenFileHeader
+//   TokenRecord tokens[token_count]
+//   uint32_t    string_offsets[string_count + 1]
+//   char        strings[string_offsets[string_count]]
+//   char        source[source_size]
+//   char        source_name[source_name_size]
+//
+// Token spans are 32-bit, so sources are limited to 4 GiB.
+class TokenTable {
+  public:
+    std::vector<TokenRecord> tokens;
+    std::vector<std::string> strings;
+    // Not owned. Valid as long as the input of the lexer or the TokenFile
+    // that the table comes from.
+    std::string_view source;
+    std::string source_name;
+
+    // Collects the tokens that `lexer` produced from `source`, which must be
+    // the data of its input.
+    static TokenTable from_lexer(const std::vector<antlr4::Token *> &tokens,
+                                 const CoolLexer &lexer,
+                                 std::string_view source,
+                                 const std::string &source_name);
+
+    std::string_view text(const TokenRecord &token) const {
+        return source.substr(token.start, token.length);
+    }
+
+    // The payload accessors mirror the ones in CoolLexer.
+
+    bool get_bool_value(size_t token_index) const {
+        return tokens[token_index].payload != 0;
+    }
+
+    const std::string &get_string_value(size_t token_index) const {
+        return strings[tokens[token_index].payload];
+    }
+
+    CoolLexer::ErrorCode get_error_code(size_t token_index) const {
+        return static_cast<CoolLexer::ErrorCode>(tokens[token_index].payload);
+    }
+
+    // Writes the table to a .ctok file. Returns whether it succeeded.
+    bool write(const std::string &file_path) const;
+};
+
+// A .ctok file, read through a memory mapping.
+class TokenFile {
+  private:
+    MappedCharStream file_;
+    TokenTable table_;
+    std::string error_;
+
+  public:
+    explicit TokenFile(const std::string &file_path);
+
+    // Whether the file could be read. If not, error() tells why.
+    bool is_valid() const { return error_.empty(); }
+    const std::string &error() const { return error_; }
+
+    // The source of the table points into the mapping of the file.
+    const TokenTable &table() const { return table_; }
+};
+
+// A TokenSource that replays the tokens of a TokenTable, e.g. to feed
+// CoolParser from a .ctok file. The tokens carry their text, since there is
+// no CharStream behind them.
+class TokenTableSource : public antlr4::TokenSource {
+  private:
+    const TokenTable &table_;
+    antlr4::TokenFactory<antlr4::CommonToken> *factory_;
+    // Index of the next token to be returned.
+    size_t next_ = 0;
+
+  public:
+    explicit TokenTableSource(const TokenTable &table);
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override;
+    size_t getCharPositionInLine() override;
+    antlr4::CharStream *getInputStream() override { return nullptr; }
+    std::string getSourceName() override { return table_.source_name; }
+    antlr4::TokenFactory<antlr4::CommonToken> *getTokenFactory() override {
+        return factory_;
+    }
+};
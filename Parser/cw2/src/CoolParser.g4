@@ -22,13 +22,12 @@ expr   : NEW TYPEID                                                         # ne
        | LBRACE (expr SEMI)+ RBRACE                                         # block
        | CASE expr OF (OBJECTID COLON TYPEID DARROW expr SEMI)+ ESAC        # case
        | LPAREN expr RPAREN                                                 # paren
-       | OBJECTID                                                           # object
+       | OBJECTID (LPAREN (expr (COMMA expr)*)? RPAREN | ASSIGN expr)?      # identifier
        | INT_CONST                                                          # int
        | STR_CONST                                                          # string
        | BOOL_CONST                                                         # bool
        | expr AT TYPEID DOT OBJECTID LPAREN (expr (COMMA expr)*)? RPAREN    # statdispatch
        | expr DOT OBJECTID LPAREN (expr (COMMA expr)*)? RPAREN              # dispatch
-       | OBJECTID LPAREN (expr (COMMA expr)*)? RPAREN                       # selfdispatch
        | TILDE expr                                                         # neg
        | ISVOID expr                                                        # isvoid
        | expr (MULT | DIV) expr                                             # multdiv
@@ -36,5 +35,4 @@ expr   : NEW TYPEID                                                         # ne
        | expr (LE | EQ | LT) expr                                           # comp
        | NOT expr                                                           # not
        | LET let_binding (COMMA let_binding)* IN expr                       # let
-       | <assoc=right> OBJECTID ASSIGN expr                                 # assign
        ;
@@ -1,17 +1,34 @@
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <unistd.h>
+
 #include "antlr4-runtime/antlr4-runtime.h"
 
+#include "BufferedWriter.h"
 #include "CoolLexer.h"
 #include "CoolParser.h"
 #include "CoolParserBaseVisitor.h"
 #include "ErrorPrinter.h"
+#include "IncrementalParse.h"
+#include "MappedCharStream.h"
 #include "ChainedCompVisitor.h"
+#include "ParallelParse.h"
+#include "ParseProfile.h"
+#include "ParserDiff.h"
+#include "PipelinedTokenSource.h"
+#include "PrattParser.h"
+#include "ThreadPool.h"
+#include "TokenFile.h"
+#include "TwoStageParse.h"
 #include "TreePrinter.h"
 
 using namespace std;
@@ -20,43 +37,478 @@ using namespace antlr4::tree;
 
 namespace fs = filesystem;
 
-int main(int argc, const char *argv[]) {
-    if (argc != 2) {
-        cerr << "Expecting exactly one argument: name of input file" << endl;
-        return 1;
+// How parse_and_print() parses.
+struct ParseOptions {
+    // Parse with PrattParser first, and with CoolParser only to report
+    // syntax errors.
+    bool use_pratt_parser = false;
+    // Parse with CoolParser in two stages, SLL then LL.
+    bool use_two_stage = false;
+    // Report on stderr how often the LL stage was needed.
+    bool print_parse_stats = false;
+    // Lex and parse slices of the source on several threads first, and the
+    // whole of it only to report errors.
+    bool parse_in_parallel = false;
+    // Lex on a thread of its own while parsing, and lex and parse again in
+    // one go only to report errors. The pipelined parse is CoolParser's, in
+    // one or two stages as use_two_stage says; PrattParser is only tried in
+    // the parse again. Only this driver has the option so far; the drivers of
+    // the later stages still lex in one go before parsing.
+    bool pipeline_lexer = false;
+};
+
+// Checks `program_tree` for chained comparisons and prints it, or reports
+// that the compilation halted if `error_printer` has reported any error.
+void print_tree(CoolParser::ProgramContext *program_tree,
+                const TokenTable &tokens, CoolParser *parser,
+                const string &file_name, ErrorPrinter &error_printer,
+                ThreadPool &pool) {
+    // The chained comparisons are checked while the tree is rendered. A
+    // chained comparison halts the compilation, so the tree is only written
+    // out once the whole of it is rendered without one.
+    if (!error_printer.has_error()) {
+        TreePrinter tree_printer(tokens, parser, file_name, &pool);
+        tree_printer.render(program_tree, &error_printer);
+        if (!error_printer.has_error()) {
+            cout.flush();
+            BufferedWriter out(STDOUT_FILENO);
+            tree_printer.write(out);
+            return;
+        }
     }
 
-    auto file_path = argv[1];
-    ifstream fin(file_path);
+    cout << "Compilation halted due to lex and parse errors" << endl;
+}
 
-    auto file_name = fs::path(file_path).filename().string();
+// Parses `tokenStream`, which holds the tokens of `tokens`, and prints the
+// tree.
+void parse_and_print(CommonTokenStream *tokenStream, const TokenTable &tokens,
+                     CoolLexer *lexer, const string &file_name,
+                     const ParseOptions &options) {
+    CoolParser parser(tokenStream);
 
-    ANTLRInputStream input(fin);
-    CoolLexer lexer(&input);
+    ErrorPrinter error_printer(file_name, lexer, &parser);
+
+    parser.removeErrorListener(&ConsoleErrorListener::INSTANCE);
+    parser.addErrorListener(&error_printer);
+
+    unique_ptr<PrattParser> pratt_parser;
+    CoolParser::ProgramContext *program_tree = nullptr;
+    if (options.use_pratt_parser) {
+        pratt_parser = make_unique<PrattParser>(tokenStream);
+        program_tree = pratt_parser->parse();
+    }
+
+    bool parsed_by_pratt = program_tree != nullptr;
+    TwoStageStats parse_stats;
+    if (!parsed_by_pratt) {
+        // This will trigger the error_printer, in case there are errors.
+        program_tree = options.use_two_stage
+                           ? parse_two_stage(parser, parse_stats)
+                           : parser.program();
+    }
+
+    if (options.print_parse_stats) {
+        cerr << "Two-stage parses: " << parse_stats.parses
+             << ", LL fallbacks: " << parse_stats.ll_fallbacks << endl;
+    }
+
+    ThreadPool pool;
+    print_tree(program_tree, tokens, &parser, file_name, error_printer, pool);
+}
 
+// Parses `source` in slices, replaces the `length` bytes at `offset` with
+// `text`, and prints the tree of the edited source, for which only the classes
+// that the edit touches are lexed and parsed again. If the edited source has
+// errors, it is lexed and parsed again in one go, so that its errors are
+// reported the usual way.
+void edit_and_print(string_view source, const string &source_name,
+                    const string &file_name, size_t offset, size_t length,
+                    string_view text, const ParseOptions &options) {
+    IncrementalParse parse(string(source), source_name);
+    parse.parse();
+    if (auto *program_tree = parse.edit(offset, length, text)) {
+        ErrorPrinter error_printer(file_name, nullptr, parse.parser());
+        ThreadPool pool;
+        print_tree(program_tree, parse.tokens(), parse.parser(), file_name,
+                   error_printer, pool);
+        return;
+    }
+
+    MappedCharStream input(parse.source(), source_name);
+    CoolLexer lexer(&input);
     CommonTokenStream tokenStream(&lexer);
+    tokenStream.fill();
+    TokenTable tokens = TokenTable::from_lexer(
+        tokenStream.getTokens(), lexer, parse.source(), source_name);
+    parse_and_print(&tokenStream, tokens, &lexer, file_name, options);
+}
 
-    CoolParser parser(&tokenStream);
+// Reports on `out` how long the tree of `tokenStream` takes to check and
+// print, the way this driver used to do it and the way it does it now.
+//
+// The old way parses, walks the tree with ChainedCompVisitor, then parses
+// again for TreePrinter. The new way parses once, and checks while printing.
+// Each way runs `rounds` times after a warm-up parse, and the fastest round
+// is reported. The trees are only rendered, so only the work of building
+// the text is timed. Classes are rendered on one thread, as they used to be.
+void pipeline_bench(CommonTokenStream *tokenStream, const TokenTable &tokens,
+                    CoolLexer *lexer, const string &file_name, ostream &out) {
+    using Clock = chrono::steady_clock;
+    constexpr int rounds = 5;
 
-    ErrorPrinter error_printer(file_name, &lexer, &parser);
+    auto run = [&](bool fused) {
+        tokenStream->seek(0);
+        CoolParser parser(tokenStream);
+        ErrorPrinter error_printer(file_name, lexer, &parser);
+        parser.removeErrorListener(&ConsoleErrorListener::INSTANCE);
+        parser.addErrorListener(&error_printer);
 
-    parser.removeErrorListener(&ConsoleErrorListener::INSTANCE);
-    parser.addErrorListener(&error_printer);
+        auto start = Clock::now();
+        CoolParser::ProgramContext *program_tree = parser.program();
+        if (fused) {
+            TreePrinter(tokens, &parser, file_name)
+                .render(program_tree, &error_printer);
+        } else {
+            ChainedCompVisitor chained_comp_visitor(error_printer);
+            chained_comp_visitor.visit(program_tree);
+            parser.reset();
+            TreePrinter(tokens, &parser, file_name).render(parser.program());
+        }
+        return Clock::now() - start;
+    };
 
-    // This will trigger the error_printer, in case there are errors.
-    auto *program_tree = parser.program();
+    run(true);
+    auto best_separate = Clock::duration::max();
+    auto best_fused = Clock::duration::max();
+    for (int i = 0; i < rounds; ++i) {
+        best_separate = min(best_separate, run(false));
+        best_fused = min(best_fused, run(true));
+    }
 
-    if (!error_printer.has_error()) {
-        ChainedCompVisitor chained_comp_visitor(error_printer);
-        chained_comp_visitor.visit(program_tree);
+    auto milliseconds = [](Clock::duration duration) {
+        return chrono::duration<double, milli>(duration).count();
+    };
+    out << fixed << setprecision(2)
+        << "Parse, check, parse again, print: " << milliseconds(best_separate)
+        << " ms" << endl
+        << "Parse, check while printing:      " << milliseconds(best_fused)
+        << " ms" << endl;
+}
+
+// Reports on `out` how long `source` takes to lex and parse in one go, and in
+// slices on the threads of `pool`. Each way runs `rounds` times after a
+// warm-up parse, and the fastest round is reported.
+void parallel_bench(string_view source, const string &source_name,
+                    ThreadPool &pool, ostream &out) {
+    using Clock = chrono::steady_clock;
+    constexpr int rounds = 5;
+
+    size_t slice_count = 0;
+    auto run = [&](bool parallel) {
+        auto start = Clock::now();
+        if (parallel) {
+            ParallelParse parallel_parse(source, source_name);
+            parallel_parse.parse(pool);
+            slice_count = parallel_parse.slice_count();
+        } else {
+            MappedCharStream input(source, source_name);
+            CoolLexer lexer(&input);
+            CommonTokenStream tokenStream(&lexer);
+            tokenStream.fill();
+            CoolParser parser(&tokenStream);
+            parser.removeErrorListeners();
+            TwoStageStats parse_stats;
+            parse_two_stage(parser, parse_stats);
+        }
+        return Clock::now() - start;
+    };
+
+    run(true);
+    auto best_serial = Clock::duration::max();
+    auto best_parallel = Clock::duration::max();
+    for (int i = 0; i < rounds; ++i) {
+        best_serial = min(best_serial, run(false));
+        best_parallel = min(best_parallel, run(true));
     }
 
-    parser.reset();
+    auto milliseconds = [](Clock::duration duration) {
+        return chrono::duration<double, milli>(duration).count();
+    };
+    out << fixed << setprecision(2)
+        << "Lex and parse in one go: " << milliseconds(best_serial) << " ms"
+        << endl
+        << "Lex and parse " << slice_count << " slices on "
+        << pool.thread_count() << " threads: " << milliseconds(best_parallel)
+        << " ms" << endl;
+}
 
-    if (!error_printer.has_error()) {
-        TreePrinter(&lexer, &parser, file_name).print();
+// Reports on `out` how long `source` takes to lex and parse in full, and to
+// parse again after a keystroke, i.e. a space typed into the body of its
+// middle class and deleted again. Each way runs `rounds` times after a
+// warm-up parse, and the fastest round is reported. The tokens after the
+// keystrokes are checked against those of a full parse of the same source.
+void incremental_bench(string_view source, const string &source_name,
+                       ostream &out) {
+    using Clock = chrono::steady_clock;
+    constexpr int rounds = 5;
+
+    IncrementalParse parse(string(source), source_name);
+    if (parse.parse() == nullptr) {
+        out << "The source has errors, not measured" << endl;
+        return;
+    }
+
+    vector<SourcePosition> class_starts = find_class_starts(source);
+    size_t middle = class_starts[class_starts.size() / 2].offset;
+    size_t brace = source.find('{', middle);
+    if (brace == string_view::npos) {
+        out << "No class body to edit" << endl;
+        return;
+    }
+    size_t offset = brace + 1;
+
+    auto time = [](auto action) {
+        auto start = Clock::now();
+        action();
+        return Clock::now() - start;
+    };
+    auto best_full = Clock::duration::max();
+    auto best_keystroke = Clock::duration::max();
+    size_t reparsed_slices = 0;
+    bool edits_parsed = true;
+    for (int i = 0; i < rounds; ++i) {
+        best_full = min(best_full, time([&]() { parse.parse(); }));
+        best_keystroke = min(best_keystroke, time([&]() {
+            edits_parsed &= parse.edit(offset, 0, " ") != nullptr;
+        }));
+        reparsed_slices = parse.reparsed_slices();
+        best_keystroke = min(best_keystroke, time([&]() {
+            edits_parsed &= parse.edit(offset, 1, "") != nullptr;
+        }));
+    }
+
+    parse.edit(offset, 0, " ");
+    IncrementalParse full(parse.source(), source_name);
+    full.parse();
+    const auto &expected = full.tokens().tokens;
+    const auto &actual = parse.tokens().tokens;
+    bool same_tokens =
+        edits_parsed && expected.size() == actual.size() &&
+        equal(expected.begin(), expected.end(), actual.begin(),
+              [](const TokenRecord &a, const TokenRecord &b) {
+                  return a.type == b.type && a.line == b.line &&
+                         a.column == b.column && a.start == b.start &&
+                         a.length == b.length && a.payload == b.payload;
+              });
+
+    auto milliseconds = [](Clock::duration duration) {
+        return chrono::duration<double, milli>(duration).count();
+    };
+    out << fixed << setprecision(3)
+        << "Lex and parse " << parse.slice_count()
+        << " classes: " << milliseconds(best_full) << " ms" << endl
+        << "Parse again after a keystroke, " << reparsed_slices
+        << " classes: " << milliseconds(best_keystroke) << " ms" << endl
+        << "Tokens after the keystrokes "
+        << (same_tokens ? "match" : "DIFFER from") << " a full parse"
+        << endl;
+}
+
+int main(int argc, const char *argv[]) {
+    vector<string> args(argv + 1, argv + argc);
+
+    // --diff-parsers checks that PrattParser and CoolParser build the same
+    // tree for each of the given files.
+    if (!args.empty() && args[0] == "--diff-parsers") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!diff_parsers(args[i], cerr)) {
+                ++failed;
+            }
+        }
+        cout << "Parsers differ on " << failed << " of " << args.size() - 1
+             << " files" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --profile-parser profiles the decisions of CoolParser on each of the
+    // given files, and writes the profiles as a JSON array.
+    if (!args.empty() && args[0] == "--profile-parser") {
+        size_t failed = 0;
+        cout << "[";
+        for (size_t i = 1; i < args.size(); ++i) {
+            cout << (i == 1 ? "\n" : ",\n");
+            if (!profile_parser(args[i], cout)) {
+                ++failed;
+            }
+        }
+        cout << "\n]" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --pratt selects PrattParser instead of CoolParser. --sll makes
+    // CoolParser parse in two stages, SLL then LL, and --parse-stats reports
+    // how often the LL stage was needed. --parallel parses slices of the
+    // input on several threads, and --pipeline-lexer lexes the input on one
+    // thread while parsing it on another. --pipeline-bench times the parsing
+    // and printing of the input instead of printing it, --parallel-bench
+    // times parsing it in one go and in slices, and --incremental-bench
+    // times parsing it again after an edit.
+    ParseOptions options;
+    bool bench_pipeline = false;
+    bool bench_parallel = false;
+    bool bench_incremental = false;
+    for (; !args.empty(); args.erase(args.begin())) {
+        if (args[0] == "--pratt") {
+            options.use_pratt_parser = true;
+        } else if (args[0] == "--sll") {
+            options.use_two_stage = true;
+        } else if (args[0] == "--parse-stats") {
+            options.print_parse_stats = true;
+        } else if (args[0] == "--parallel") {
+            options.parse_in_parallel = true;
+        } else if (args[0] == "--pipeline-lexer") {
+            options.pipeline_lexer = true;
+        } else if (args[0] == "--pipeline-bench") {
+            bench_pipeline = true;
+        } else if (args[0] == "--parallel-bench") {
+            bench_parallel = true;
+        } else if (args[0] == "--incremental-bench") {
+            bench_incremental = true;
+        } else {
+            break;
+        }
+    }
+
+    // Parses a token file written by the lexer with --ctok, without lexing
+    // the source again.
+    if (args.size() == 2 && args[0] == "--from-ctok") {
+        TokenFile token_file(args[1]);
+        if (!token_file.is_valid()) {
+            cerr << "Could not read token file " << args[1] << ": "
+                 << token_file.error() << endl;
+            return 1;
+        }
+
+        const TokenTable &tokens = token_file.table();
+        TokenTableSource token_source(tokens);
+        CommonTokenStream tokenStream(&token_source);
+        auto file_name = fs::path(tokens.source_name).filename().string();
+        parse_and_print(&tokenStream, tokens, nullptr, file_name, options);
+        return 0;
+    }
+
+    // Parses a file, replaces the LENGTH bytes at OFFSET with TEXT and prints
+    // the tree of the edited source, parsing again only the classes that the
+    // edit touches: --edit OFFSET LENGTH TEXT FILE.
+    if (args.size() == 5 && args[0] == "--edit") {
+        auto is_number = [](const string &arg) {
+            return !arg.empty() &&
+                   all_of(arg.begin(), arg.end(),
+                          [](unsigned char c) { return isdigit(c); });
+        };
+        if (!is_number(args[1]) || !is_number(args[2])) {
+            cerr << "Expecting --edit OFFSET LENGTH TEXT FILE" << endl;
+            return 1;
+        }
+
+        MappedCharStream input(args[4]);
+        if (!input.is_open()) {
+            cerr << "Could not open input file: " << args[4] << endl;
+            return 1;
+        }
+        auto file_name = fs::path(args[4]).filename().string();
+        edit_and_print(string_view(input.data(), input.size()),
+                       input.getSourceName(), file_name, stoul(args[1]),
+                       stoul(args[2]), args[3], options);
+        return 0;
+    }
+
+    if (args.size() != 1) {
+        cerr << "Expecting exactly one argument: name of input file" << endl;
+        return 1;
+    }
+
+    auto file_path = args[0];
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        cerr << "Could not open input file: " << file_path << endl;
+        return 1;
+    }
+
+    auto file_name = fs::path(file_path).filename().string();
+    string_view source(input.data(), input.size());
+
+    if (bench_incremental) {
+        incremental_bench(source, input.getSourceName(), cout);
+        return 0;
+    }
+
+    if (bench_parallel) {
+        ThreadPool pool;
+        parallel_bench(source, input.getSourceName(), pool, cout);
+        return 0;
+    }
+
+    // A source with errors is lexed and parsed again below, in one go, so
+    // that its errors are reported the usual way.
+    if (options.parse_in_parallel) {
+        ThreadPool pool;
+        ParallelParse parallel_parse(source, input.getSourceName());
+        if (auto *program_tree = parallel_parse.parse(pool)) {
+            ErrorPrinter error_printer(file_name, nullptr,
+                                       parallel_parse.parser());
+            print_tree(program_tree, parallel_parse.tokens(),
+                       parallel_parse.parser(), file_name, error_printer, pool);
+            return 0;
+        }
+    }
+
+    // The tokens cross from the lexer thread to this one as they are lexed,
+    // but the payloads and string values that the lexer keeps on the side
+    // are only read once its thread is joined.
+    if (options.pipeline_lexer) {
+        CoolLexer lexer(&input);
+        PipelinedTokenSource token_source(&lexer);
+        CommonTokenStream tokenStream(&token_source);
+        CoolParser parser(&tokenStream);
+        parser.removeErrorListeners();
+        TwoStageStats parse_stats;
+        auto *program_tree = options.use_two_stage
+                                 ? parse_two_stage(parser, parse_stats)
+                                 : parser.program();
+        token_source.join();
+        if (parser.getNumberOfSyntaxErrors() == 0) {
+            if (options.print_parse_stats) {
+                cerr << "Two-stage parses: " << parse_stats.parses
+                     << ", LL fallbacks: " << parse_stats.ll_fallbacks << endl;
+            }
+            tokenStream.fill();
+            TokenTable tokens = TokenTable::from_lexer(
+                tokenStream.getTokens(), lexer, source, input.getSourceName());
+            ErrorPrinter error_printer(file_name, &lexer, &parser);
+            ThreadPool pool;
+            print_tree(program_tree, tokens, &parser, file_name, error_printer,
+                       pool);
+            return 0;
+        }
+        input.seek(0);
+    }
+
+    CoolLexer lexer(&input);
+
+    // The lexer runs to the end first, so that the payloads of all tokens are
+    // in the table before the tree is printed.
+    CommonTokenStream tokenStream(&lexer);
+    tokenStream.fill();
+    TokenTable tokens = TokenTable::from_lexer(
+        tokenStream.getTokens(), lexer, source, input.getSourceName());
+
+    if (bench_pipeline) {
+        pipeline_bench(&tokenStream, tokens, &lexer, file_name, cout);
     } else {
-        cout << "Compilation halted due to lex and parse errors" << endl;
+        parse_and_print(&tokenStream, tokens, &lexer, file_name, options);
     }
 
     return 0;
@@ -0,0 +1,100 @@
+#include "MappedCharStream.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace antlr4;
+
+MappedCharStream::MappedCharStream(const string &file_path)
+    : source_name_(file_path) {
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0) {
+        is_open_ = true;
+        size_ = file_stat.st_size;
+
+        // mmap rejects empty mappings, so empty files are left unmapped.
+        if (size_ > 0) {
+            void *mapping =
+                mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                is_open_ = false;
+                size_ = 0;
+            } else {
+                // The lexer reads the file front to back exactly once.
+                madvise(mapping, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char *>(mapping);
+                owns_data_ = true;
+            }
+        }
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+MappedCharStream::MappedCharStream(string_view data, const string &source_name)
+    : source_name_(source_name), data_(data.data()), size_(data.size()),
+      is_open_(true) {}
+
+MappedCharStream::~MappedCharStream() {
+    if (owns_data_) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+}
+
+string_view MappedCharStream::get_view(size_t start, size_t stop) const {
+    if (start >= size_ || stop < start) {
+        return {};
+    }
+    stop = min(stop, size_ - 1);
+    return {data_ + start, stop - start + 1};
+}
+
+void MappedCharStream::consume() {
+    if (p_ >= size_) {
+        throw IllegalStateException("cannot consume EOF");
+    }
+    ++p_;
+}
+
+size_t MappedCharStream::LA(ssize_t i) {
+    // LA(0) is undefined; ANTLRInputStream returns 0 for it as well.
+    if (i == 0) {
+        return 0;
+    }
+
+    // LA(1) is the next symbol, LA(-1) is the previously consumed one.
+    ssize_t position = static_cast<ssize_t>(p_) + (i > 0 ? i - 1 : i);
+    if (position < 0 || position >= static_cast<ssize_t>(size_)) {
+        return IntStream::EOF;
+    }
+    return static_cast<unsigned char>(data_[position]);
+}
+
+void MappedCharStream::seek(size_t index) { p_ = min(index, size_); }
+
+string MappedCharStream::getSourceName() const {
+    if (source_name_.empty()) {
+        return IntStream::UNKNOWN_SOURCE_NAME;
+    }
+    return source_name_;
+}
+
+string MappedCharStream::getText(const misc::Interval &interval) {
+    if (interval.a < 0 || interval.b < 0) {
+        return "";
+    }
+    return string(get_view(interval.a, interval.b));
+}
+
+string MappedCharStream::toString() const { return string(data_, size_); }
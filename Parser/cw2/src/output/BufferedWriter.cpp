@@ -0,0 +1,60 @@
+#include "BufferedWriter.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+using namespace std;
+
+BufferedWriter::BufferedWriter(int fd, size_t capacity)
+    : fd_(fd), buffer_(capacity) {}
+
+BufferedWriter::~BufferedWriter() { flush(); }
+
+void BufferedWriter::write_all(const char *bytes, size_t size) {
+    while (size > 0 && !failed_) {
+        ssize_t written = ::write(fd_, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            failed_ = true;
+            break;
+        }
+        bytes += written;
+        size -= written;
+    }
+}
+
+void BufferedWriter::write(const void *bytes, size_t size) {
+    if (size > buffer_.size() - used_) {
+        flush();
+        // Writes that do not fit into the buffer bypass it.
+        if (size > buffer_.size()) {
+            write_all(static_cast<const char *>(bytes), size);
+            return;
+        }
+    }
+    memcpy(buffer_.data() + used_, bytes, size);
+    used_ += size;
+}
+
+void BufferedWriter::write_decimal(uint64_t value) {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0) {
+        write(digits[--count]);
+    }
+}
+
+bool BufferedWriter::flush() {
+    write_all(buffer_.data(), used_);
+    used_ = 0;
+    return !failed_;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Text built up in memory, a piece at a time.
+//
+// Unlike an ostringstream, no locale or formatting state is consulted, and
+// numbers are written with to_chars. Indentation comes from a table of
+// spaces, so writing it allocates nothing.
+class TextBuffer {
+  private:
+    std::string text_;
+
+    static constexpr std::string_view SPACES =
+        "                                                                ";
+
+  public:
+    TextBuffer &operator<<(std::string_view text) {
+        text_.append(text);
+        return *this;
+    }
+
+    TextBuffer &operator<<(char c) {
+        text_.push_back(c);
+        return *this;
+    }
+
+    // Writes `value` in decimal.
+    TextBuffer &operator<<(size_t value) {
+        char digits[20];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        text_.append(digits, result.ptr);
+        return *this;
+    }
+
+    // Writes `width` spaces.
+    void indent(size_t width) {
+        for (; width > SPACES.size(); width -= SPACES.size()) {
+            text_.append(SPACES);
+        }
+        text_.append(SPACES.substr(0, width));
+    }
+
+    std::string_view view() const { return text_; }
+};
@@ -0,0 +1,208 @@
+#include "ParallelParse.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "TwoStageParse.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// Slices per thread. A few give the pool room to balance slices whose classes
+// take longer to parse than their size suggests.
+constexpr size_t SLICES_PER_THREAD = 4;
+
+bool is_word_char(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_class_keyword(string_view word) {
+    constexpr string_view keyword = "class";
+    return word.size() == keyword.size() &&
+           equal(word.begin(), word.end(), keyword.begin(), [](char a, char b) {
+               return tolower(static_cast<unsigned char>(a)) == b;
+           });
+}
+
+} // namespace
+
+vector<SourcePosition> find_class_starts(string_view source) {
+    vector<SourcePosition> starts;
+    size_t line = 1;
+    size_t line_start = 0;
+    // Comments nest, as in the lexer.
+    size_t comment_depth = 0;
+
+    auto next_line = [&](size_t newline) {
+        ++line;
+        line_start = newline + 1;
+    };
+
+    for (size_t i = 0; i < source.size(); ++i) {
+        char c = source[i];
+        string_view pair = source.substr(i, 2);
+        if (c == '\n') {
+            next_line(i);
+        } else if (comment_depth > 0) {
+            if (pair == "(*") {
+                ++comment_depth;
+                ++i;
+            } else if (pair == "*)") {
+                --comment_depth;
+                ++i;
+            }
+        } else if (pair == "(*") {
+            comment_depth = 1;
+            ++i;
+        } else if (pair == "--") {
+            // Stops before the newline, which the next iteration counts.
+            size_t newline = source.find('\n', i);
+            i = (newline == string_view::npos ? source.size() : newline) - 1;
+        } else if (c == '"') {
+            // A string ends at an unescaped quote, or at an unescaped newline,
+            // which is an error.
+            for (++i; i < source.size(); ++i) {
+                if (source[i] == '\\' && i + 1 < source.size()) {
+                    if (source[++i] == '\n') {
+                        next_line(i);
+                    }
+                } else if (source[i] == '"') {
+                    break;
+                } else if (source[i] == '\n') {
+                    next_line(i);
+                    break;
+                }
+            }
+        } else if (is_word_char(c)) {
+            // Words are skipped whole, so that a `class` inside a name is not
+            // taken for the keyword.
+            size_t end = i + 1;
+            while (end < source.size() && is_word_char(source[end])) {
+                ++end;
+            }
+            if (is_class_keyword(source.substr(i, end - i))) {
+                starts.push_back({i, line, i - line_start});
+            }
+            i = end - 1;
+        }
+    }
+    return starts;
+}
+
+ParallelParse::ParallelParse(string_view source, const string &source_name)
+    : source_(source), source_name_(source_name) {}
+
+CoolParser::ProgramContext *ParallelParse::parse(ThreadPool &pool) {
+    vector<SourcePosition> class_starts = find_class_starts(source_);
+    if (class_starts.empty()) {
+        return nullptr;
+    }
+
+    // The first slice starts at the start of the source, so that whatever
+    // comes before the first class is lexed too. The others start at the
+    // first class past an even share of the source.
+    size_t target_count =
+        min(class_starts.size(), pool.thread_count() * SLICES_PER_THREAD);
+    vector<SourcePosition> slice_starts = {{0, 1, 0}};
+    for (size_t i = 1; i < class_starts.size(); ++i) {
+        if (class_starts[i].offset * target_count >=
+            source_.size() * slice_starts.size()) {
+            slice_starts.push_back(class_starts[i]);
+        }
+    }
+
+    slices_.clear();
+    slices_.resize(slice_starts.size());
+    pool.run(slices_.size(), [&](size_t i) {
+        size_t end = i + 1 < slice_starts.size() ? slice_starts[i + 1].offset
+                                                 : source_.size();
+        parse_slice(slices_[i], slice_starts[i], end);
+    });
+
+    for (const Slice &slice : slices_) {
+        if (slice.program == nullptr) {
+            return nullptr;
+        }
+    }
+    join();
+    return program_.get();
+}
+
+void ParallelParse::parse_slice(Slice &slice, const SourcePosition &start,
+                                size_t end) {
+    // The stream covers the source up to the end of the slice, so that the
+    // tokens get the offsets they have in the whole source.
+    slice.input = make_unique<MappedCharStream>(source_.substr(0, end),
+                                                source_name_);
+    slice.input->seek(start.offset);
+    slice.lexer = make_unique<CoolLexer>(slice.input.get());
+    slice.lexer->removeErrorListeners();
+    slice.lexer->setLine(start.line);
+    slice.lexer->setCharPositionInLine(start.column);
+
+    slice.tokens = make_unique<CommonTokenStream>(slice.lexer.get());
+    slice.tokens->fill();
+
+    slice.parser = make_unique<CoolParser>(slice.tokens.get());
+    slice.parser->removeErrorListeners();
+    TwoStageStats stats;
+    CoolParser::ProgramContext *program =
+        parse_two_stage(*slice.parser, stats);
+
+    // CoolParser stops at the first token that can't start a class, and
+    // ignores the rest of the input. A slice must be parsed to its end, or
+    // the tokens it ignores would be parsed by the next slice.
+    if (slice.parser->getNumberOfSyntaxErrors() == 0 &&
+        slice.tokens->LA(1) == Token::EOF) {
+        slice.program = program;
+    }
+}
+
+void ParallelParse::join() {
+    tokens_ = TokenTable();
+    tokens_.source = source_;
+    tokens_.source_name = source_name_;
+
+    program_ = make_unique<CoolParser::ProgramContext>(
+        nullptr, atn::ATNState::INVALID_STATE_NUMBER);
+    program_->start = slices_.front().program->start;
+    program_->stop = slices_.back().program->stop;
+
+    for (size_t i = 0; i < slices_.size(); ++i) {
+        Slice &slice = slices_[i];
+
+        // Every slice ends with an EOF token, but only the last one ends
+        // where the source does.
+        vector<Token *> slice_tokens = slice.tokens->getTokens();
+        if (i + 1 < slices_.size()) {
+            slice_tokens.pop_back();
+        }
+
+        TokenTable table = TokenTable::from_lexer(slice_tokens, *slice.lexer,
+                                                  source_, source_name_);
+        int32_t string_base = static_cast<int32_t>(tokens_.strings.size());
+        for (TokenRecord record : table.tokens) {
+            if (record.type == CoolLexer::STR_CONST) {
+                record.payload += string_base;
+            }
+            tokens_.tokens.push_back(record);
+        }
+        move(table.strings.begin(), table.strings.end(),
+             back_inserter(tokens_.strings));
+
+        // The tree refers to the table by token index, so the tokens are
+        // numbered as one stream. This comes last, since from_lexer() reads
+        // the payloads of the lexer by the indices in the slice.
+        size_t index = tokens_.tokens.size() - slice_tokens.size();
+        for (Token *token : slice_tokens) {
+            static_cast<WritableToken *>(token)->setTokenIndex(index++);
+        }
+
+        for (tree::ParseTree *child : slice.program->children) {
+            child->parent = program_.get();
+            program_->children.push_back(child);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime/antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "CoolParser.h"
+#include "MappedCharStream.h"
+#include "ThreadPool.h"
+#include "TokenFile.h"
+
+// A position in a source, as the lexer counts it: lines from 1, columns
+// from 0.
+struct SourcePosition {
+    size_t offset;
+    size_t line;
+    size_t column;
+};
+
+// Returns the positions of the `class` keywords at the top level of
+// `source`, i.e. outside of strings and comments, in order.
+//
+// This is a scan of the bytes, not a lexer: it only knows enough of the
+// lexical rules to skip strings and nested comments. A position it gets wrong
+// makes the slice before it fail to parse, since a string or comment is then
+// cut in two.
+std::vector<SourcePosition> find_class_starts(std::string_view source);
+
+// Lexes and parses a source in slices, on the threads of a pool.
+//
+// `program: (class ';')+` makes classes independent of each other, so the
+// source is cut at top-level `class` keywords into about as many slices of
+// similar size as there are threads. Each slice has its own CoolLexer and
+// CoolParser, which start at the line and column of the slice, so the tokens
+// get the same positions as when the source is lexed in one go. The trees of
+// the slices are then joined under a single ProgramContext, and their tokens
+// into a single TokenTable, numbered as one stream.
+//
+// The slices report no errors. If any of them has a lexical or syntax error,
+// parse() returns nullptr and the source should be parsed again in one go,
+// with an ErrorPrinter, so that errors are reported exactly as they always
+// are, in order and no matter how the source was cut.
+class ParallelParse {
+  private:
+    struct Slice {
+        std::unique_ptr<MappedCharStream> input;
+        std::unique_ptr<CoolLexer> lexer;
+        std::unique_ptr<antlr4::CommonTokenStream> tokens;
+        std::unique_ptr<CoolParser> parser;
+        CoolParser::ProgramContext *program = nullptr;
+    };
+
+    std::string_view source_;
+    std::string source_name_;
+    // The contexts of a slice belong to its parser, and its tokens to its
+    // token stream, so the slices live as long as the joined tree.
+    std::vector<Slice> slices_;
+    std::unique_ptr<CoolParser::ProgramContext> program_;
+    TokenTable tokens_;
+
+    void parse_slice(Slice &slice, const SourcePosition &start, size_t end);
+    void join();
+
+  public:
+    // `source` is the text of the file called `source_name`, and must
+    // outlive the parse.
+    ParallelParse(std::string_view source, const std::string &source_name);
+
+    // Parses the whole source on `pool`. Returns the joined tree, or nullptr
+    // if the source has errors or no class.
+    CoolParser::ProgramContext *parse(ThreadPool &pool);
+
+    // The tokens of the whole source, which the tree refers to by index.
+    const TokenTable &tokens() const { return tokens_; }
+    // A parser that can stand for those of the slices, e.g. for the names of
+    // the rules.
+    CoolParser *parser() const { return slices_.front().parser.get(); }
+    size_t slice_count() const { return slices_.size(); }
+};
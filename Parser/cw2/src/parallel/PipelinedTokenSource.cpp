@@ -0,0 +1,115 @@
+#include "PipelinedTokenSource.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// Polls before yielding, since the other thread usually frees a slot or
+// fills one within a few tokens.
+constexpr int SPINS_BEFORE_YIELD = 64;
+
+template <typename Poll> void wait_for(Poll poll) {
+    for (int spins = 0; !poll(); ++spins) {
+        if (spins >= SPINS_BEFORE_YIELD) {
+            this_thread::yield();
+        }
+    }
+}
+
+} // namespace
+
+PipelinedTokenSource::PipelinedTokenSource(TokenSource *lexer)
+    : lexer_(lexer), ring_(RING_CAPACITY) {
+    thread_ = thread([this]() { lex(); });
+}
+
+PipelinedTokenSource::~PipelinedTokenSource() {
+    stopping_.store(true, memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    Token *token;
+    while (ring_.try_pop(token)) {
+        delete token;
+    }
+}
+
+void PipelinedTokenSource::lex() {
+    // The ring holds raw pointers, so that a slot is a single word. A token
+    // is owned by the ring between the push and the pop. Returns false if
+    // the source is being destroyed, and the token was not pushed.
+    auto push = [&](Token *token) {
+        bool pushed = false;
+        wait_for([&]() {
+            pushed = ring_.try_push(token);
+            return pushed || stopping_.load(memory_order_relaxed);
+        });
+        return pushed;
+    };
+
+    try {
+        while (true) {
+            unique_ptr<Token> token = lexer_->nextToken();
+            bool is_eof = token->getType() == Token::EOF;
+            if (!push(token.get())) {
+                return;
+            }
+            token.release();
+            if (is_eof) {
+                break;
+            }
+        }
+    } catch (...) {
+        error_ = current_exception();
+    }
+    push(nullptr);
+}
+
+void PipelinedTokenSource::join() {
+    if (!joined_) {
+        thread_.join();
+        joined_ = true;
+    }
+    if (error_) {
+        rethrow_exception(error_);
+    }
+}
+
+unique_ptr<Token> PipelinedTokenSource::nextToken() {
+    if (joined_) {
+        return lexer_->nextToken();
+    }
+
+    Token *token;
+    wait_for([&]() { return ring_.try_pop(token); });
+    if (token == nullptr) {
+        join();
+        return lexer_->nextToken();
+    }
+    if (token->getType() == Token::EOF) {
+        // Only the end marker is left in the ring.
+        Token *end;
+        wait_for([&]() { return ring_.try_pop(end); });
+        join();
+    }
+    return unique_ptr<Token>(token);
+}
+
+size_t PipelinedTokenSource::getLine() const { return lexer_->getLine(); }
+
+size_t PipelinedTokenSource::getCharPositionInLine() {
+    return lexer_->getCharPositionInLine();
+}
+
+CharStream *PipelinedTokenSource::getInputStream() {
+    return lexer_->getInputStream();
+}
+
+string PipelinedTokenSource::getSourceName() {
+    return lexer_->getSourceName();
+}
+
+TokenFactory<CommonToken> *PipelinedTokenSource::getTokenFactory() {
+    return lexer_->getTokenFactory();
+}
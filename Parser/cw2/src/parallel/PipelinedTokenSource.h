@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "antlr4-runtime/antlr4-runtime.h"
+
+#include "TokenRing.h"
+
+// A TokenSource that runs another one on a thread of its own, so that a
+// lexer can run ahead of the parser that reads its tokens.
+//
+// The lexer thread pushes its tokens into a TokenRing, and nextToken() pops
+// them on the parser thread. Lexing and parsing overlap, and no more than
+// the capacity of the ring are ever in flight between them. A full ring
+// stalls the lexer and an empty one the parser; both spin briefly, then
+// yield.
+//
+// Nothing but the tokens crosses the ring. The lexer also fills side tables
+// as it goes, e.g. CoolLexer::token_payloads and string_values, which the
+// parser thread must not read while the lexer thread may still be growing
+// them. join() waits for the lexer thread to finish, which publishes
+// everything it wrote, so the tables may be read once join() returns. Parse
+// errors are best left unreported until then too, since reporting them
+// reads the tables: parse with the error listeners removed, and if there are
+// errors, lex and parse again in one go.
+class PipelinedTokenSource : public antlr4::TokenSource {
+  private:
+    // Large enough to cover the lexer running in bursts, small enough to
+    // stay in the cache.
+    static constexpr size_t RING_CAPACITY = 1024;
+
+    antlr4::TokenSource *lexer_;
+    // A null token marks the end of the tokens, after EOF or after the lexer
+    // threw.
+    TokenRing<antlr4::Token *> ring_;
+    std::thread thread_;
+    std::atomic<bool> stopping_ = false;
+    std::exception_ptr error_;
+    bool joined_ = false;
+
+    void lex();
+
+  public:
+    // Starts lexing with `lexer` on a new thread. The lexer must not be used
+    // elsewhere until join() returns.
+    explicit PipelinedTokenSource(antlr4::TokenSource *lexer);
+    // Stops the lexer thread if it is still running, e.g. because the parser
+    // gave up early, and frees the tokens that were never read.
+    ~PipelinedTokenSource() override;
+
+    PipelinedTokenSource(const PipelinedTokenSource &) = delete;
+    PipelinedTokenSource &operator=(const PipelinedTokenSource &) = delete;
+
+    // Waits for the lexer thread to finish. Rethrows what the lexer threw, if
+    // anything.
+    void join();
+
+    // Returns the next token of the lexer, waiting for it if need be. Once
+    // EOF has been returned, the lexer is called directly, on the calling
+    // thread.
+    std::unique_ptr<antlr4::Token> nextToken() override;
+
+    // Only meaningful once joined, like the side tables of the lexer.
+    size_t getLine() const override;
+    size_t getCharPositionInLine() override;
+
+    antlr4::CharStream *getInputStream() override;
+    std::string getSourceName() override;
+    antlr4::TokenFactory<antlr4::CommonToken> *getTokenFactory() override;
+};
@@ -0,0 +1,78 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    // hardware_concurrency() is 0 when it is not known.
+    for (size_t i = 1; i < max<size_t>(thread_count, 1); ++i) {
+        workers_.emplace_back([this]() { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work() {
+    unique_lock<mutex> lock(mutex_);
+    size_t seen_generation = 0;
+    while (true) {
+        work_ready_.wait(lock, [&]() {
+            return stopping_ || generation_ != seen_generation;
+        });
+        if (stopping_) {
+            return;
+        }
+        seen_generation = generation_;
+        run_iterations(lock);
+    }
+}
+
+void ThreadPool::run_iterations(unique_lock<mutex> &lock) {
+    ++running_;
+    while (next_ < count_) {
+        size_t index = next_++;
+        lock.unlock();
+        try {
+            (*task_)(index);
+        } catch (...) {
+            lock.lock();
+            if (!error_) {
+                error_ = current_exception();
+            }
+            continue;
+        }
+        lock.lock();
+    }
+    if (--running_ == 0) {
+        work_done_.notify_all();
+    }
+}
+
+void ThreadPool::run(size_t count, const function<void(size_t)> &task) {
+    unique_lock<mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    error_ = nullptr;
+    ++generation_;
+    work_ready_.notify_all();
+
+    run_iterations(lock);
+    work_done_.wait(lock, [&]() { return running_ == 0; });
+
+    task_ = nullptr;
+    if (error_) {
+        rethrow_exception(exchange(error_, nullptr));
+    }
+}
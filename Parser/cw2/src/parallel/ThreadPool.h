@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that run the iterations of a loop.
+//
+// run() hands out the indices of the loop one at a time, so long iterations
+// don't hold up the others, and the calling thread works on them too. Only
+// one loop runs at a time; run() returns once every iteration is done.
+class ThreadPool {
+  private:
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable work_done_;
+
+    // The loop being run. `generation_` counts the loops, so that a worker
+    // can tell a new loop from the one it has just finished.
+    const std::function<void(size_t)> *task_ = nullptr;
+    size_t count_ = 0;
+    size_t next_ = 0;
+    size_t running_ = 0;
+    size_t generation_ = 0;
+    std::exception_ptr error_;
+    bool stopping_ = false;
+
+    void work();
+    // Runs iterations of the current loop until none are left. Called with
+    // `lock` held, and returns with it held.
+    void run_iterations(std::unique_lock<std::mutex> &lock);
+
+  public:
+    // `thread_count` counts the calling thread, so a pool of one thread has
+    // no workers and runs every loop serially.
+    explicit ThreadPool(
+        size_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Calls task(i) for every i in [0, count). If an iteration throws, the
+    // first exception is rethrown once the others are done.
+    void run(size_t count, const std::function<void(size_t)> &task);
+
+    size_t thread_count() const { return workers_.size() + 1; }
+};
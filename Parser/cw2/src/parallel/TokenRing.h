@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// A bounded queue between exactly one producer thread and one consumer
+// thread, without locks.
+//
+// The producer only writes `tail_` and the consumer only writes `head_`, so
+// each index has a single writer. Storing an index with release ordering
+// publishes the slot it passes over: a value pushed is complete by the time
+// the consumer sees it, and a slot popped is free by the time the producer
+// reuses it. The indices only grow, and are reduced to a slot by masking, so
+// the capacity is a power of two.
+template <typename T> class TokenRing {
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::vector<T> slots_;
+    size_t mask_;
+
+    // On separate cache lines, so that the two threads don't invalidate each
+    // other's line on every push and pop.
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+
+  public:
+    // `capacity` must be a power of two.
+    explicit TokenRing(size_t capacity)
+        : slots_(capacity), mask_(capacity - 1) {}
+
+    TokenRing(const TokenRing &) = delete;
+    TokenRing &operator=(const TokenRing &) = delete;
+
+    // Called by the producer only. Returns false if the ring is full.
+    bool try_push(T value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called by the consumer only. Returns false if the ring is empty.
+    bool try_pop(T &value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+};
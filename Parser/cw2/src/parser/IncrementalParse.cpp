@@ -0,0 +1,235 @@
+#include "IncrementalParse.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "TwoStageParse.h"
+
+using namespace std;
+using namespace antlr4;
+
+IncrementalParse::IncrementalParse(string source, const string &source_name)
+    : source_(move(source)), source_name_(source_name) {}
+
+unique_ptr<IncrementalParse::Slice>
+IncrementalParse::parse_slice(const SourcePosition &start, size_t end) {
+    ++reparsed_slices_;
+
+    auto slice = make_unique<Slice>();
+    slice->text = source_.substr(start.offset, end - start.offset);
+    slice->input = make_unique<MappedCharStream>(slice->text, source_name_);
+    slice->lexer = make_unique<CoolLexer>(slice->input.get());
+    slice->lexer->removeErrorListeners();
+    slice->lexer->setLine(start.line);
+    slice->lexer->setCharPositionInLine(start.column);
+
+    slice->tokens = make_unique<CommonTokenStream>(slice->lexer.get());
+    slice->tokens->fill();
+
+    slice->parser = make_unique<CoolParser>(slice->tokens.get());
+    slice->parser->removeErrorListeners();
+    TwoStageStats stats;
+    slice->program = parse_two_stage(*slice->parser, stats);
+
+    // As in ParallelParse, a slice must be parsed to its end. A slice that
+    // ends inside a string or comment ends with an error token instead.
+    if (slice->parser->getNumberOfSyntaxErrors() != 0 ||
+        slice->tokens->LA(1) != Token::EOF) {
+        return nullptr;
+    }
+
+    slice->table = TokenTable::from_lexer(slice->tokens->getTokens(),
+                                          *slice->lexer, slice->text,
+                                          source_name_);
+    // join() moves the tokens to their place in the source, where the input
+    // of the slice has no text, so each token keeps a copy of its own.
+    for (Token *token : slice->tokens->getTokens()) {
+        static_cast<CommonToken *>(token)->setText(token->getText());
+    }
+    slice->start = start;
+    slice->lexed_at = start;
+    slice->end = {end, slice->lexer->getLine(),
+                  slice->lexer->getCharPositionInLine()};
+    return slice;
+}
+
+vector<unique_ptr<IncrementalParse::Slice>>
+IncrementalParse::parse_region(const SourcePosition &start, size_t end) {
+    string_view region = string_view(source_).substr(start.offset,
+                                                     end - start.offset);
+
+    // The first slice runs from the start of the region to the second class,
+    // so that whatever comes before the first class belongs to a slice.
+    // Positions in the region count from its own first line.
+    vector<SourcePosition> class_starts = find_class_starts(region);
+    vector<SourcePosition> slice_starts = {start};
+    for (size_t i = 1; i < class_starts.size(); ++i) {
+        const SourcePosition &class_start = class_starts[i];
+        slice_starts.push_back({
+            start.offset + class_start.offset,
+            start.line + class_start.line - 1,
+            class_start.line == 1 ? start.column + class_start.column
+                                  : class_start.column,
+        });
+    }
+
+    vector<unique_ptr<Slice>> slices;
+    for (size_t i = 0; i < slice_starts.size(); ++i) {
+        size_t slice_end = i + 1 < slice_starts.size()
+                               ? slice_starts[i + 1].offset
+                               : end;
+        auto slice = parse_slice(slice_starts[i], slice_end);
+        if (!slice) {
+            return {};
+        }
+        slices.push_back(move(slice));
+    }
+    return slices;
+}
+
+CoolParser::ProgramContext *IncrementalParse::parse() {
+    reparsed_slices_ = 0;
+    slices_ = parse_region({0, 1, 0}, source_.size());
+    valid_ = !slices_.empty();
+    if (!valid_) {
+        return nullptr;
+    }
+    join();
+    return program_.get();
+}
+
+CoolParser::ProgramContext *IncrementalParse::edit(size_t offset,
+                                                   size_t length,
+                                                   string_view text) {
+    offset = min(offset, source_.size());
+    length = min(length, source_.size() - offset);
+    size_t old_size = source_.size();
+    source_.replace(offset, length, text);
+    if (!valid_) {
+        return parse();
+    }
+    reparsed_slices_ = 0;
+
+    // The slices the edit touches, in the coordinates from before the edit.
+    // An edit at the boundary of two slices touches both, since it may add to
+    // the end of the first as well as change the start of the second.
+    size_t first = 0;
+    while (first + 1 < slices_.size() &&
+           slices_[first + 1]->start.offset < offset) {
+        ++first;
+    }
+    size_t last = first;
+    while (last + 1 < slices_.size() &&
+           slices_[last + 1]->start.offset <= offset + length) {
+        ++last;
+    }
+
+    // Grows the region one slice at a time until it parses, i.e. until the
+    // lexer ends it in the state that the next slice was lexed from.
+    vector<unique_ptr<Slice>> region;
+    while (true) {
+        size_t old_end = last + 1 < slices_.size()
+                             ? slices_[last + 1]->start.offset
+                             : old_size;
+        region = parse_region(slices_[first]->start,
+                              old_end - length + text.size());
+        if (!region.empty()) {
+            break;
+        }
+        if (last + 1 == slices_.size()) {
+            valid_ = false;
+            return nullptr;
+        }
+        ++last;
+    }
+
+    // The slices after the region move by as much as its end did. Columns
+    // only move on the line where the region ends.
+    if (last + 1 < slices_.size()) {
+        SourcePosition old_end = slices_[last + 1]->start;
+        SourcePosition new_end = region.back()->end;
+        auto shift = [&](SourcePosition &position) {
+            if (position.line == old_end.line) {
+                position.column = position.column - old_end.column +
+                                  new_end.column;
+            }
+            position.line = position.line - old_end.line + new_end.line;
+            position.offset = position.offset - old_end.offset +
+                              new_end.offset;
+        };
+        for (size_t i = last + 1; i < slices_.size(); ++i) {
+            shift(slices_[i]->start);
+            shift(slices_[i]->end);
+        }
+    }
+
+    slices_.erase(slices_.begin() + first, slices_.begin() + last + 1);
+    slices_.insert(slices_.begin() + first, make_move_iterator(region.begin()),
+                   make_move_iterator(region.end()));
+    join();
+    return program_.get();
+}
+
+void IncrementalParse::join() {
+    tokens_ = TokenTable();
+    tokens_.source = source_;
+    tokens_.source_name = source_name_;
+
+    program_ = make_unique<CoolParser::ProgramContext>(
+        nullptr, atn::ATNState::INVALID_STATE_NUMBER);
+    program_->start = slices_.front()->program->start;
+    program_->stop = slices_.back()->program->stop;
+
+    for (size_t i = 0; i < slices_.size(); ++i) {
+        Slice &slice = *slices_[i];
+
+        // Every slice ends with an EOF token, but only the last one ends
+        // where the source does.
+        vector<Token *> slice_tokens = slice.tokens->getTokens();
+        if (i + 1 < slices_.size()) {
+            slice_tokens.pop_back();
+        }
+
+        // Lines and columns are shifted the way edit() shifts the start of
+        // the slice, unsigned arithmetic wrapping back into range.
+        const SourcePosition &start = slice.start;
+        const SourcePosition &lexed_at = slice.lexed_at;
+        int32_t string_base = static_cast<int32_t>(tokens_.strings.size());
+        for (size_t k = 0; k < slice_tokens.size(); ++k) {
+            TokenRecord record = slice.table.tokens[k];
+            record.start += start.offset;
+            if (record.line == lexed_at.line) {
+                record.column += start.column - lexed_at.column;
+            }
+            record.line += start.line - lexed_at.line;
+            if (record.type == CoolLexer::STR_CONST) {
+                record.payload += string_base;
+            }
+            tokens_.tokens.push_back(record);
+        }
+        tokens_.strings.insert(tokens_.strings.end(),
+                               slice.table.strings.begin(),
+                               slice.table.strings.end());
+
+        // The tree refers to the table by token index, so the tokens are
+        // numbered as one stream. They are moved to where their records are,
+        // since the tree is printed with the lines of its tokens. The table
+        // of the slice was made before, so this is safe to do on every join.
+        size_t index = tokens_.tokens.size() - slice_tokens.size();
+        for (Token *token : slice_tokens) {
+            const TokenRecord &record = tokens_.tokens[index];
+            auto *writable = static_cast<CommonToken *>(token);
+            writable->setTokenIndex(index++);
+            writable->setLine(record.line);
+            writable->setCharPositionInLine(record.column);
+            writable->setStartIndex(record.start);
+            // The EOF token stops right before it starts.
+            writable->setStopIndex(size_t{record.start} + record.length - 1);
+        }
+
+        for (tree::ParseTree *child : slice.program->children) {
+            child->parent = program_.get();
+            program_->children.push_back(child);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime/antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "CoolParser.h"
+#include "MappedCharStream.h"
+#include "ParallelParse.h"
+#include "TokenFile.h"
+
+// Keeps the tokens and tree of a source across edits, and lexes and parses
+// again only the classes that an edit touches.
+//
+// The source is cut into one slice per top-level class, found by
+// find_class_starts(), and each slice is lexed and parsed on its own, like
+// the slices of ParallelParse. An edit replaces the slices it overlaps. Their
+// text is cut into classes again, and each is lexed and parsed again. The
+// lexer is back in sync once the new slices parse to their end without
+// error, i.e. once the last of them ends outside of any string or comment.
+// Until it is, e.g. while a new comment is left open, the edited region
+// grows by the next slice. The slices before and after the region keep their
+// tokens and subtrees, and only their positions are shifted.
+//
+// The tree and token table are joined from the slices after every parse. The
+// tokens are renumbered as one stream, which takes time linear in the number
+// of tokens, but neither lexes nor parses them.
+//
+// Slices report no errors. If the source has a lexical or syntax error,
+// parse() and edit() return nullptr, and the source should be parsed again
+// in one go, with an ErrorPrinter. The next edit then parses the whole
+// source again too.
+class IncrementalParse {
+  private:
+    struct Slice {
+        // The slice is lexed from a copy of its text, so that edits to the
+        // source don't move the bytes behind its tokens.
+        std::string text;
+        std::unique_ptr<MappedCharStream> input;
+        std::unique_ptr<CoolLexer> lexer;
+        std::unique_ptr<antlr4::CommonTokenStream> tokens;
+        std::unique_ptr<CoolParser> parser;
+        CoolParser::ProgramContext *program = nullptr;
+        // The tokens of the slice, with offsets from the start of `text`.
+        TokenTable table;
+
+        // Where the slice starts now, and where it started when it was
+        // lexed. The tokens are shifted by the difference when joined.
+        SourcePosition start;
+        SourcePosition lexed_at;
+        // Where the lexer stopped, at the end of the slice.
+        SourcePosition end;
+    };
+
+    std::string source_;
+    std::string source_name_;
+    std::vector<std::unique_ptr<Slice>> slices_;
+    std::unique_ptr<CoolParser::ProgramContext> program_;
+    TokenTable tokens_;
+    // Whether slices_ covers source_ and parses without error.
+    bool valid_ = false;
+    size_t reparsed_slices_ = 0;
+
+    // Lexes and parses the slice of source_ in [start.offset, end). Returns
+    // nullptr if it has an error or does not parse to its end.
+    std::unique_ptr<Slice> parse_slice(const SourcePosition &start,
+                                       size_t end);
+    // Parses source_ in [start.offset, end) into one slice per class.
+    // Returns no slices if any of them has an error.
+    std::vector<std::unique_ptr<Slice>>
+    parse_region(const SourcePosition &start, size_t end);
+    void join();
+
+  public:
+    IncrementalParse(std::string source, const std::string &source_name);
+
+    // Parses the whole source. Returns the tree, or nullptr if the source
+    // has errors or no class.
+    CoolParser::ProgramContext *parse();
+
+    // Replaces the `length` bytes of the source at `offset` with `text`, and
+    // parses the classes it touches again. Returns the tree of the whole
+    // source, or nullptr if it has errors.
+    CoolParser::ProgramContext *edit(size_t offset, size_t length,
+                                     std::string_view text);
+
+    const std::string &source() const { return source_; }
+    // The tokens of the whole source, which the tree refers to by index.
+    // Their text is in source(), which an edit invalidates.
+    const TokenTable &tokens() const { return tokens_; }
+    // A parser that can stand for those of the slices, e.g. for the names of
+    // the rules.
+    CoolParser *parser() const { return slices_.front()->parser.get(); }
+    size_t slice_count() const { return slices_.size(); }
+    // How many slices the last parse() or edit() lexed and parsed.
+    size_t reparsed_slices() const { return reparsed_slices_; }
+};
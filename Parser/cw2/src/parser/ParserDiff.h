@@ -0,0 +1,13 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+// Parses the file at `file_path` with both CoolParser and PrattParser, from
+// the same tokens, and checks that they build the same tree: the same labeled
+// contexts, with the same children and the same start and stop tokens. Files
+// with syntax errors must be rejected by both.
+//
+// The first difference found is described on `out`. Returns whether the two
+// trees are equal.
+bool diff_parsers(const std::string &file_path, std::ostream &out);
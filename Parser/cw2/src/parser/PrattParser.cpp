@@ -0,0 +1,388 @@
+#include "PrattParser.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// ANTLR gives the n-th of the 19 alternatives of `expr` precedence 20 - n.
+// A prefix operator parses its operand at its own precedence, and a binary
+// operator (all of them are left associative) parses its right operand at one
+// above its own. The expressions nested in the other alternatives, like the
+// value assigned by `identifier`, are parsed at precedence 0.
+constexpr int STATDISPATCH_PRECEDENCE = 9;
+constexpr int DISPATCH_PRECEDENCE = 8;
+constexpr int NEG_PRECEDENCE = 7;
+constexpr int ISVOID_PRECEDENCE = 6;
+constexpr int MULTDIV_PRECEDENCE = 5;
+constexpr int SUBADD_PRECEDENCE = 4;
+constexpr int COMP_PRECEDENCE = 3;
+constexpr int NOT_PRECEDENCE = 2;
+constexpr int LET_PRECEDENCE = 1;
+
+// Returns the precedence of the operator or dispatch that `type` starts, or
+// -1 if it does not continue an expression.
+int infix_precedence(size_t type) {
+    switch (type) {
+    case CoolParser::AT:
+        return STATDISPATCH_PRECEDENCE;
+    case CoolParser::DOT:
+        return DISPATCH_PRECEDENCE;
+    case CoolParser::MULT:
+    case CoolParser::DIV:
+        return MULTDIV_PRECEDENCE;
+    case CoolParser::PLUS:
+    case CoolParser::MINUS:
+        return SUBADD_PRECEDENCE;
+    case CoolParser::LE:
+    case CoolParser::EQ:
+    case CoolParser::LT:
+        return COMP_PRECEDENCE;
+    default:
+        return -1;
+    }
+}
+
+} // namespace
+
+PrattParser::PrattParser(BufferedTokenStream *tokens) {
+    tokens->fill();
+    for (Token *token : tokens->getTokens()) {
+        if (token->getChannel() == Token::DEFAULT_CHANNEL) {
+            tokens_.push_back(token);
+        }
+    }
+}
+
+CoolParser::ProgramContext *PrattParser::parse() {
+    next_ = 0;
+    nodes_.clear();
+    try {
+        return program();
+    } catch (const SyntaxError &) {
+        return nullptr;
+    }
+}
+
+size_t PrattParser::la(size_t k) const {
+    // The last token is EOF, which is never consumed.
+    return tokens_[min(next_ + k, tokens_.size() - 1)]->getType();
+}
+
+template <typename Context>
+Context *PrattParser::make_context(ParserRuleContext *parent) {
+    auto context =
+        make_unique<Context>(parent, atn::ATNState::INVALID_STATE_NUMBER);
+    Context *ctx = context.get();
+    nodes_.push_back(move(context));
+    ctx->start = tokens_[min(next_, tokens_.size() - 1)];
+    return ctx;
+}
+
+template <typename Context>
+Context *PrattParser::make_expr(ParserRuleContext *parent) {
+    // Like CoolParser, copies an unlabeled context into the labeled one.
+    CoolParser::ExprContext expr_ctx(parent,
+                                     atn::ATNState::INVALID_STATE_NUMBER);
+    expr_ctx.start = tokens_[min(next_, tokens_.size() - 1)];
+    auto context = make_unique<Context>(&expr_ctx);
+    Context *ctx = context.get();
+    nodes_.push_back(move(context));
+    return ctx;
+}
+
+void PrattParser::match(ParserRuleContext *ctx, size_t type) {
+    if (la() != type || type == Token::EOF) {
+        throw SyntaxError();
+    }
+    auto node = make_unique<tree::TerminalNodeImpl>(tokens_[next_++]);
+    ctx->addChild(node.get());
+    nodes_.push_back(move(node));
+}
+
+void PrattParser::finish(ParserRuleContext *ctx) {
+    if (next_ > 0) {
+        ctx->stop = tokens_[next_ - 1];
+    }
+}
+
+CoolParser::ProgramContext *PrattParser::program() {
+    auto *ctx = make_context<CoolParser::ProgramContext>(nullptr);
+    // Like CoolParser, stops at the first token that can't start a class,
+    // and leaves the rest of the input alone.
+    do {
+        class_(ctx);
+        match(ctx, CoolParser::SEMI);
+    } while (la() == CoolParser::CLASS);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::ClassContext *PrattParser::class_(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::ClassContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::CLASS);
+    match(ctx, CoolParser::TYPEID);
+    if (la() == CoolParser::INHERITS) {
+        match(ctx, CoolParser::INHERITS);
+        match(ctx, CoolParser::TYPEID);
+    }
+    match(ctx, CoolParser::LBRACE);
+    while (la() == CoolParser::OBJECTID) {
+        feature(ctx);
+        match(ctx, CoolParser::SEMI);
+    }
+    match(ctx, CoolParser::RBRACE);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::FeatureContext *PrattParser::feature(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::FeatureContext>(parent);
+    parent->addChild(ctx);
+    if (la(1) == CoolParser::LPAREN) {
+        method(ctx);
+    } else {
+        attr(ctx);
+    }
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::MethodContext *PrattParser::method(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::MethodContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::LPAREN);
+    if (la() != CoolParser::RPAREN) {
+        formal(ctx);
+        while (la() == CoolParser::COMMA) {
+            match(ctx, CoolParser::COMMA);
+            formal(ctx);
+        }
+    }
+    match(ctx, CoolParser::RPAREN);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    match(ctx, CoolParser::LBRACE);
+    expr(ctx);
+    match(ctx, CoolParser::RBRACE);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::AttrContext *PrattParser::attr(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::AttrContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    if (la() == CoolParser::ASSIGN) {
+        match(ctx, CoolParser::ASSIGN);
+        expr(ctx);
+    }
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::FormalContext *PrattParser::formal(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::FormalContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::Let_bindingContext *
+PrattParser::let_binding(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::Let_bindingContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    if (la() == CoolParser::ASSIGN) {
+        match(ctx, CoolParser::ASSIGN);
+        expr(ctx);
+    }
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::ExprContext *PrattParser::expr(ParserRuleContext *parent,
+                                           int precedence) {
+    CoolParser::ExprContext *ctx = primary(parent);
+    finish(ctx);
+
+    // Each operator wraps the expression parsed so far into a new context, as
+    // the left-recursive alternatives of CoolParser do.
+    for (int op_precedence = infix_precedence(la());
+         op_precedence >= precedence;
+         op_precedence = infix_precedence(la())) {
+        auto *left = ctx;
+        switch (la()) {
+        case CoolParser::AT:
+            ctx = make_expr<CoolParser::StatdispatchContext>(parent);
+            break;
+        case CoolParser::DOT:
+            ctx = make_expr<CoolParser::DispatchContext>(parent);
+            break;
+        case CoolParser::MULT:
+        case CoolParser::DIV:
+            ctx = make_expr<CoolParser::MultdivContext>(parent);
+            break;
+        case CoolParser::PLUS:
+        case CoolParser::MINUS:
+            ctx = make_expr<CoolParser::SubaddContext>(parent);
+            break;
+        default:
+            ctx = make_expr<CoolParser::CompContext>(parent);
+            break;
+        }
+        ctx->start = left->start;
+        left->parent = ctx;
+        ctx->addChild(left);
+
+        if (op_precedence == STATDISPATCH_PRECEDENCE) {
+            match(ctx, CoolParser::AT);
+            match(ctx, CoolParser::TYPEID);
+        }
+        if (op_precedence >= DISPATCH_PRECEDENCE) {
+            match(ctx, CoolParser::DOT);
+            match(ctx, CoolParser::OBJECTID);
+            arguments(ctx);
+        } else {
+            match(ctx, la());
+            expr(ctx, op_precedence + 1);
+        }
+        finish(ctx);
+    }
+
+    parent->addChild(ctx);
+    return ctx;
+}
+
+CoolParser::ExprContext *PrattParser::primary(ParserRuleContext *parent) {
+    CoolParser::ExprContext *ctx;
+    switch (la()) {
+    case CoolParser::NEW:
+        ctx = make_expr<CoolParser::NewContext>(parent);
+        match(ctx, CoolParser::NEW);
+        match(ctx, CoolParser::TYPEID);
+        break;
+    case CoolParser::IF:
+        ctx = make_expr<CoolParser::CondContext>(parent);
+        match(ctx, CoolParser::IF);
+        expr(ctx);
+        match(ctx, CoolParser::THEN);
+        expr(ctx);
+        match(ctx, CoolParser::ELSE);
+        expr(ctx);
+        match(ctx, CoolParser::FI);
+        break;
+    case CoolParser::WHILE:
+        ctx = make_expr<CoolParser::LoopContext>(parent);
+        match(ctx, CoolParser::WHILE);
+        expr(ctx);
+        match(ctx, CoolParser::LOOP);
+        expr(ctx);
+        match(ctx, CoolParser::POOL);
+        break;
+    case CoolParser::LBRACE:
+        ctx = make_expr<CoolParser::BlockContext>(parent);
+        match(ctx, CoolParser::LBRACE);
+        do {
+            expr(ctx);
+            match(ctx, CoolParser::SEMI);
+        } while (la() != CoolParser::RBRACE);
+        match(ctx, CoolParser::RBRACE);
+        break;
+    case CoolParser::CASE:
+        ctx = make_expr<CoolParser::CaseContext>(parent);
+        match(ctx, CoolParser::CASE);
+        expr(ctx);
+        match(ctx, CoolParser::OF);
+        do {
+            match(ctx, CoolParser::OBJECTID);
+            match(ctx, CoolParser::COLON);
+            match(ctx, CoolParser::TYPEID);
+            match(ctx, CoolParser::DARROW);
+            expr(ctx);
+            match(ctx, CoolParser::SEMI);
+        } while (la() == CoolParser::OBJECTID);
+        match(ctx, CoolParser::ESAC);
+        break;
+    case CoolParser::LPAREN:
+        ctx = make_expr<CoolParser::ParenContext>(parent);
+        match(ctx, CoolParser::LPAREN);
+        expr(ctx);
+        match(ctx, CoolParser::RPAREN);
+        break;
+    case CoolParser::OBJECTID:
+        // A variable, an assignment or a dispatch on self, told apart by the
+        // token after the name.
+        ctx = make_expr<CoolParser::IdentifierContext>(parent);
+        match(ctx, CoolParser::OBJECTID);
+        if (la() == CoolParser::LPAREN) {
+            arguments(ctx);
+        } else if (la() == CoolParser::ASSIGN) {
+            match(ctx, CoolParser::ASSIGN);
+            expr(ctx);
+        }
+        break;
+    case CoolParser::INT_CONST:
+        ctx = make_expr<CoolParser::IntContext>(parent);
+        match(ctx, CoolParser::INT_CONST);
+        break;
+    case CoolParser::STR_CONST:
+        ctx = make_expr<CoolParser::StringContext>(parent);
+        match(ctx, CoolParser::STR_CONST);
+        break;
+    case CoolParser::BOOL_CONST:
+        ctx = make_expr<CoolParser::BoolContext>(parent);
+        match(ctx, CoolParser::BOOL_CONST);
+        break;
+    case CoolParser::TILDE:
+        ctx = make_expr<CoolParser::NegContext>(parent);
+        match(ctx, CoolParser::TILDE);
+        expr(ctx, NEG_PRECEDENCE);
+        break;
+    case CoolParser::ISVOID:
+        ctx = make_expr<CoolParser::IsvoidContext>(parent);
+        match(ctx, CoolParser::ISVOID);
+        expr(ctx, ISVOID_PRECEDENCE);
+        break;
+    case CoolParser::NOT:
+        ctx = make_expr<CoolParser::NotContext>(parent);
+        match(ctx, CoolParser::NOT);
+        expr(ctx, NOT_PRECEDENCE);
+        break;
+    case CoolParser::LET:
+        ctx = make_expr<CoolParser::LetContext>(parent);
+        match(ctx, CoolParser::LET);
+        let_binding(ctx);
+        while (la() == CoolParser::COMMA) {
+            match(ctx, CoolParser::COMMA);
+            let_binding(ctx);
+        }
+        match(ctx, CoolParser::IN);
+        expr(ctx, LET_PRECEDENCE);
+        break;
+    default:
+        throw SyntaxError();
+    }
+    return ctx;
+}
+
+void PrattParser::arguments(CoolParser::ExprContext *ctx) {
+    match(ctx, CoolParser::LPAREN);
+    if (la() != CoolParser::RPAREN) {
+        expr(ctx);
+        while (la() == CoolParser::COMMA) {
+            match(ctx, CoolParser::COMMA);
+            expr(ctx);
+        }
+    }
+    match(ctx, CoolParser::RPAREN);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "antlr4-runtime/antlr4-runtime.h"
+
+#include "CoolParser.h"
+
+// A hand-written replacement for the ANTLR generated CoolParser.
+//
+// Classes, features and the other rules of CoolParser.g4 are parsed by plain
+// recursive descent with at most two tokens of lookahead. `expr` is parsed by
+// an operator precedence (Pratt) loop: a primary expression is parsed first,
+// then operators and dispatches are folded into it for as long as they bind
+// at least as tightly as the caller allows. Operator chains are parsed
+// iteratively, so the depth of the recursion only grows with nesting.
+//
+// The parser builds exactly the tree that CoolParser builds for a valid
+// program: the same labeled contexts, with the same children, start and stop
+// tokens, so TreePrinter and ChainedCompVisitor work on it as is. Precedences
+// follow the ones that ANTLR assigns to the alternatives of the left-recursive
+// `expr` rule. Only the invoking states of the contexts are left unset, since
+// there is no ATN behind them.
+//
+// There is no error recovery. On the first syntax error parse() gives up, and
+// the tokens should be parsed again by CoolParser, which reports the errors
+// the usual way.
+class PrattParser {
+  private:
+    // The tokens of the default channel, ending with EOF.
+    std::vector<antlr4::Token *> tokens_;
+    // Index in tokens_ of the next token to be matched.
+    size_t next_ = 0;
+
+    // Contexts don't own their children, so the parser owns every node of
+    // the tree it builds.
+    std::vector<std::unique_ptr<antlr4::tree::ParseTree>> nodes_;
+
+    // Thrown to unwind the parse at the first syntax error.
+    struct SyntaxError {};
+
+    size_t la(size_t k = 0) const;
+
+    template <typename Context>
+    Context *make_context(antlr4::ParserRuleContext *parent);
+    // Makes the context of a labeled alternative of `expr`.
+    template <typename Context>
+    Context *make_expr(antlr4::ParserRuleContext *parent);
+
+    // Consumes the next token into `ctx` if it has type `type`, and throws
+    // SyntaxError otherwise.
+    void match(antlr4::ParserRuleContext *ctx, size_t type);
+    // Sets the stop token of `ctx` to the last consumed token.
+    void finish(antlr4::ParserRuleContext *ctx);
+
+    CoolParser::ProgramContext *program();
+    CoolParser::ClassContext *class_(antlr4::ParserRuleContext *parent);
+    CoolParser::FeatureContext *feature(antlr4::ParserRuleContext *parent);
+    CoolParser::MethodContext *method(antlr4::ParserRuleContext *parent);
+    CoolParser::AttrContext *attr(antlr4::ParserRuleContext *parent);
+    CoolParser::FormalContext *formal(antlr4::ParserRuleContext *parent);
+    CoolParser::Let_bindingContext *
+    let_binding(antlr4::ParserRuleContext *parent);
+
+    // Parses an expression whose operators bind at least as tightly as
+    // `precedence`, and adds it to the children of `parent`.
+    CoolParser::ExprContext *expr(antlr4::ParserRuleContext *parent,
+                                  int precedence = 0);
+    CoolParser::ExprContext *primary(antlr4::ParserRuleContext *parent);
+    // Matches a parenthesized, comma separated list of arguments.
+    void arguments(CoolParser::ExprContext *ctx);
+
+  public:
+    // `tokens` is filled, and is left positioned at its first token.
+    explicit PrattParser(antlr4::BufferedTokenStream *tokens);
+
+    // Parses the whole program. Returns nullptr if the tokens have a syntax
+    // error. The tree lives as long as the parser.
+    CoolParser::ProgramContext *parse();
+};
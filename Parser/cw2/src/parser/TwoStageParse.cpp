@@ -0,0 +1,45 @@
+#include "TwoStageParse.h"
+
+#include <memory>
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// Bails out at the first syntax error like BailErrorStrategy, but leaves it
+// to the LL stage to report the error.
+class SilentBailErrorStrategy : public BailErrorStrategy {
+  public:
+    void reportError(Parser *, const RecognitionException &) override {}
+};
+
+} // namespace
+
+CoolParser::ProgramContext *parse_two_stage(CoolParser &parser,
+                                            TwoStageStats &stats) {
+    auto *interpreter = parser.getInterpreter<atn::ParserATNSimulator>();
+    ++stats.parses;
+
+    interpreter->setPredictionMode(atn::PredictionMode::SLL);
+    parser.setErrorHandler(make_shared<SilentBailErrorStrategy>());
+
+    CoolParser::ProgramContext *program = nullptr;
+    try {
+        program = parser.program();
+    } catch (const ParseCancellationException &) {
+        // Falls back to LL below.
+    }
+
+    interpreter->setPredictionMode(atn::PredictionMode::LL);
+    parser.setErrorHandler(make_shared<DefaultErrorStrategy>());
+
+    if (program != nullptr) {
+        return program;
+    }
+
+    ++stats.ll_fallbacks;
+    // Rewinds the token stream to its first token.
+    parser.reset();
+    return parser.program();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+#include "CoolParser.h"
+
+// Counts how the programs parsed by parse_two_stage() were parsed.
+struct TwoStageStats {
+    size_t parses = 0;
+    // Programs that SLL prediction could not parse, which were parsed again
+    // with full LL prediction.
+    size_t ll_fallbacks = 0;
+};
+
+// Parses the whole program with `parser` in two stages.
+//
+// The first stage uses SLL prediction, which never looks at the full parser
+// context, and gives up at the first syntax error without reporting it. SLL
+// is enough for nearly every valid COOL program, so an error free program is
+// parsed once, without paying for LL prediction. Only if the first stage
+// fails is the token stream rewound and parsed again with full LL prediction
+// and the default error strategy, which reports the errors to the error
+// listeners of `parser` as usual.
+//
+// Leaves `parser` with LL prediction and the default error strategy.
+CoolParser::ProgramContext *parse_two_stage(CoolParser &parser,
+                                            TwoStageStats &stats);
@@ -0,0 +1,217 @@
+#include "TokenFile.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "BufferedWriter.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+constexpr char TOKEN_FILE_MAGIC[4] = {'C', 'T', 'O', 'K'};
+constexpr uint32_t TOKEN_FILE_VERSION = 1;
+
+} // namespace
+
+// ----------------------- TokenTable -------------------------
+
+TokenTable TokenTable::from_lexer(const vector<Token *> &tokens,
+                                  const CoolLexer &lexer, string_view source,
+                                  const string &source_name) {
+    TokenTable table;
+    table.source = source;
+    table.source_name = source_name;
+    table.strings = lexer.string_values;
+
+    table.tokens.reserve(tokens.size());
+    for (Token *token : tokens) {
+        size_t start = token->getStartIndex();
+        // The EOF token stops right before it starts.
+        size_t length = token->getStopIndex() + 1 - start;
+        table.tokens.push_back({
+            static_cast<int32_t>(token->getType()),
+            static_cast<uint32_t>(token->getChannel()),
+            static_cast<uint32_t>(token->getLine()),
+            static_cast<uint32_t>(token->getCharPositionInLine()),
+            static_cast<uint32_t>(start),
+            static_cast<uint32_t>(length),
+            lexer.token_payloads[token->getTokenIndex()],
+        });
+    }
+
+    return table;
+}
+
+bool TokenTable::write(const string &file_path) const {
+    int fd = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool written;
+    {
+        BufferedWriter out(fd);
+
+        TokenFileHeader header = {};
+        memcpy(header.magic, TOKEN_FILE_MAGIC, sizeof(header.magic));
+        header.version = TOKEN_FILE_VERSION;
+        header.token_count = tokens.size();
+        header.string_count = strings.size();
+        header.source_size = source.size();
+        header.source_name_size = source_name.size();
+        out.write(&header, sizeof(header));
+
+        out.write(tokens.data(), tokens.size() * sizeof(TokenRecord));
+
+        uint32_t offset = 0;
+        out.write(&offset, sizeof(offset));
+        for (const auto &str : strings) {
+            offset += str.size();
+            out.write(&offset, sizeof(offset));
+        }
+        for (const auto &str : strings) {
+            out.write(str);
+        }
+
+        out.write(source);
+        out.write(source_name);
+
+        written = out.flush();
+    }
+
+    return close(fd) == 0 && written;
+}
+
+// ----------------------- TokenFile -------------------------
+
+TokenFile::TokenFile(const string &file_path) : file_(file_path) {
+    if (!file_.is_open()) {
+        error_ = "could not open file";
+        return;
+    }
+
+    const char *data = file_.data();
+    size_t size = file_.size();
+    size_t offset = 0;
+
+    // Returns the next `count` bytes of the file, or nullptr if the file ends
+    // before them.
+    auto take = [&](uint64_t count) -> const char * {
+        if (count > size - offset) {
+            return nullptr;
+        }
+        const char *bytes = data + offset;
+        offset += count;
+        return bytes;
+    };
+
+    TokenFileHeader header;
+    const char *header_bytes = take(sizeof(header));
+    if (header_bytes == nullptr) {
+        error_ = "file is too short";
+        return;
+    }
+    memcpy(&header, header_bytes, sizeof(header));
+    if (memcmp(header.magic, TOKEN_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        error_ = "not a token file";
+        return;
+    }
+    if (header.version != TOKEN_FILE_VERSION) {
+        error_ = "unsupported token file version";
+        return;
+    }
+
+    if (header.token_count > size / sizeof(TokenRecord) ||
+        header.string_count >= size / sizeof(uint32_t)) {
+        error_ = "file is truncated";
+        return;
+    }
+
+    const char *token_bytes = take(header.token_count * sizeof(TokenRecord));
+    const char *offset_bytes =
+        take((header.string_count + 1) * sizeof(uint32_t));
+    if (token_bytes == nullptr || offset_bytes == nullptr) {
+        error_ = "file is truncated";
+        return;
+    }
+
+    table_.tokens.resize(header.token_count);
+    memcpy(table_.tokens.data(), token_bytes,
+           header.token_count * sizeof(TokenRecord));
+
+    vector<uint32_t> string_offsets(header.string_count + 1);
+    memcpy(string_offsets.data(), offset_bytes,
+           string_offsets.size() * sizeof(uint32_t));
+    const char *string_bytes = take(string_offsets.back());
+    const char *source = take(header.source_size);
+    const char *source_name = take(header.source_name_size);
+    if (string_bytes == nullptr || source == nullptr ||
+        source_name == nullptr) {
+        error_ = "file is truncated";
+        return;
+    }
+
+    table_.strings.reserve(header.string_count);
+    for (size_t i = 0; i < header.string_count; ++i) {
+        if (string_offsets[i] > string_offsets[i + 1]) {
+            error_ = "corrupt string table";
+            return;
+        }
+        table_.strings.emplace_back(string_bytes + string_offsets[i],
+                                    string_offsets[i + 1] - string_offsets[i]);
+    }
+
+    table_.source = string_view(source, header.source_size);
+    table_.source_name.assign(source_name, header.source_name_size);
+
+    for (const auto &token : table_.tokens) {
+        bool is_string = token.type == CoolLexer::STR_CONST;
+        if (token.start + uint64_t(token.length) > header.source_size ||
+            (is_string && uint32_t(token.payload) >= header.string_count)) {
+            error_ = "corrupt token";
+            return;
+        }
+    }
+}
+
+// ----------------------- TokenTableSource -------------------------
+
+TokenTableSource::TokenTableSource(const TokenTable &table)
+    : table_(table), factory_(CommonTokenFactory::DEFAULT.get()) {}
+
+unique_ptr<Token> TokenTableSource::nextToken() {
+    // Past the end, the last token, i.e. EOF, is repeated.
+    if (table_.tokens.empty()) {
+        return factory_->create({this, nullptr}, Token::EOF, "",
+                                Token::DEFAULT_CHANNEL, 0, 0, 1, 0);
+    }
+    const TokenRecord &token =
+        table_.tokens[min(next_, table_.tokens.size() - 1)];
+    if (next_ < table_.tokens.size()) {
+        ++next_;
+    }
+
+    size_t type = token.type < 0 ? Token::EOF : token.type;
+    return factory_->create({this, nullptr}, type,
+                            string(table_.text(token)), token.channel,
+                            token.start, token.start + token.length - 1,
+                            token.line, token.column);
+}
+
+size_t TokenTableSource::getLine() const {
+    if (next_ >= table_.tokens.size()) {
+        return table_.tokens.empty() ? 1 : table_.tokens.back().line;
+    }
+    return table_.tokens[next_].line;
+}
+
+size_t TokenTableSource::getCharPositionInLine() {
+    if (next_ >= table_.tokens.size()) {
+        return table_.tokens.empty() ? 0 : table_.tokens.back().column;
+    }
+    return table_.tokens[next_].column;
+}
@@ -1,25 +1,69 @@
 #include "TreePrinter.h"
-#include <iostream>
 #include "CoolLexer.h"
 #include "CoolParser.h"
 
 using namespace std;
 
-void TreePrinter::print_indent() { cout << string(indent_, ' '); }
+void TreePrinter::print_indent() { out_.indent(indent_); }
 
-TreePrinter::TreePrinter(CoolLexer *lexer, CoolParser *parser, const string &file_name)
-    : lexer_(lexer), parser_(parser), file_name_(file_name) {}
+string_view TreePrinter::text(antlr4::tree::TerminalNode *node) const {
+    return tokens_.text(tokens_.tokens[node->getSymbol()->getTokenIndex()]);
+}
 
-void TreePrinter::print() { visitProgram(parser_->program()); }
+TreePrinter::TreePrinter(const TokenTable &tokens, CoolParser *parser, const string &file_name,
+                         ThreadPool *pool)
+    : tokens_(tokens), parser_(parser), file_name_(file_name), pool_(pool) {}
+
+void TreePrinter::render(CoolParser::ProgramContext *program, ErrorPrinter *error_printer) {
+    visitProgram(program);
+
+    if (error_printer) {
+        auto report = [&](const vector<antlr4::Token *> &offender_tokens) {
+            for (auto *offender_token : offender_tokens) {
+                error_printer->syntaxError(nullptr, offender_token, offender_token->getLine(),
+                                           offender_token->getCharPositionInLine(),
+                                           "syntax error", nullptr);
+            }
+        };
+        report(chained_comparisons_);
+        for (const auto &class_printer : class_printers_) {
+            report(class_printer->chained_comparisons_);
+        }
+    }
+}
+
+void TreePrinter::write(BufferedWriter &out) const {
+    out.write(out_.view());
+    for (const auto &class_printer : class_printers_) {
+        out.write(class_printer->out_.view());
+    }
+}
 
 std::any TreePrinter::visit(antlr4::tree::ParseTree *tree) { return tree->accept(this); }
 
 std::any TreePrinter::visitProgram(CoolParser::ProgramContext *ctx) {
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     // rules that are not labels support dynamic names
-    cout << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << endl;
+    out_ << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << '\n';
     indent_ += 2;
-    visitChildren(ctx);
+
+    // Classes don't depend on each other, so each is rendered by a printer of
+    // its own, possibly on another thread, and their texts are written out in
+    // order.
+    auto classes = ctx->class_();
+    class_printers_.clear();
+    for (size_t i = 0; i < classes.size(); ++i) {
+        class_printers_.push_back(make_unique<TreePrinter>(tokens_, parser_, file_name_));
+        class_printers_.back()->indent_ = indent_;
+    }
+    auto render_class = [&](size_t i) { class_printers_[i]->visit(classes[i]); };
+    if (pool_ && classes.size() > 1) {
+        pool_->run(classes.size(), render_class);
+    } else {
+        for (size_t i = 0; i < classes.size(); ++i) {
+            render_class(i);
+        }
+    }
 
     indent_ -= 2;
     return std::any{};
@@ -27,59 +71,59 @@ std::any TreePrinter::visitProgram(CoolParser::ProgramContext *ctx) {
 
 std::any TreePrinter::visitClass(CoolParser::ClassContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     print_indent();
     // rules that are not labels support dynamic names
-    cout << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << endl;
+    out_ << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << ctx->TYPEID(0)->getText() << endl;
+    out_ << text(ctx->TYPEID(0)) << '\n';
 
     print_indent();
     if (ctx->INHERITS()) {
-        cout << ctx->TYPEID(1)->getText() << endl;
+        out_ << text(ctx->TYPEID(1)) << '\n';
     } else {
-        cout << "Object" << endl;
+        out_ << "Object" << '\n';
     }
 
     print_indent();
-    cout << "\"" << file_name_ << "\"" << endl;
+    out_ << "\"" << file_name_ << "\"" << '\n';
     print_indent();
-    cout << "(" << endl;
+    out_ << "(" << '\n';
 
     for (auto feature_ctx : ctx->feature()) {
         visit(feature_ctx);
     }
 
     print_indent();
-    cout << ")" << endl;
+    out_ << ")" << '\n';
     indent_ -= 2;
     return std::any{};
 }
 
 std::any TreePrinter::visitAttr(CoolParser::AttrContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
     // rules that are not labels support dynamic names
-    cout << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << endl;
+    out_ << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
     print_indent();
-    cout << ctx->TYPEID()->getText() << endl;
+    out_ << text(ctx->TYPEID()) << '\n';
 
     if (ctx->expr()) {
         visit(ctx->expr());
     } else {
         print_indent();
-        cout << '#' << ctx->getStart()->getLine() << endl;
+        out_ << '#' << ctx->getStart()->getLine() << '\n';
         print_indent();
-        cout << "_no_expr" << endl;
+        out_ << "_no_expr" << '\n';
         print_indent();
-        cout << ": _no_type" << endl;
+        out_ << ": _no_type" << '\n';
     }
     indent_ -= 2;
     return std::any{};
@@ -87,56 +131,56 @@ std::any TreePrinter::visitAttr(CoolParser::AttrContext *ctx) {
 
 std::any TreePrinter::visitFormal(CoolParser::FormalContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
     // rules that are not labels support dynamic names
-    cout << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << endl;
+    out_ << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
     print_indent();
-    cout << ctx->TYPEID()->getText() << endl;
+    out_ << text(ctx->TYPEID()) << '\n';
 
     indent_ -= 2;
     return std::any{};
 }
 
-std::any TreePrinter::visitAssign(CoolParser::AssignContext *ctx) {
+std::any TreePrinter::visitAssign(CoolParser::IdentifierContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_assign" << endl;
+    out_ << "_assign" << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
 
-    visit(ctx->expr());
+    visit(ctx->expr(0));
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitMethod(CoolParser::MethodContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     print_indent();
     // rules that are not labels support dynamic names
-    cout << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << endl;
+    out_ << "_" << parser_->getRuleNames()[ctx->getRuleIndex()] << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
 
     for (auto formal_ctx : ctx->formal()) {
         visit(formal_ctx);
     }
 
     print_indent();
-    cout << ctx->TYPEID()->getText() << endl;
+    out_ << text(ctx->TYPEID()) << '\n';
 
     visit(ctx->expr());
 
@@ -144,74 +188,92 @@ std::any TreePrinter::visitMethod(CoolParser::MethodContext *ctx) {
     return std::any{};
 }
 
-std::any TreePrinter::visitObject(CoolParser::ObjectContext *ctx) {
+std::any TreePrinter::visitIdentifier(CoolParser::IdentifierContext *ctx) {
+    if (ctx->ASSIGN()) {
+        return visitAssign(ctx);
+    }
+    if (ctx->LPAREN()) {
+        return visitSelfdispatch(ctx);
+    }
+    return visitObject(ctx);
+}
+
+std::any TreePrinter::visitObject(CoolParser::IdentifierContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_object" << endl;
+    out_ << "_object" << '\n';
     indent_ += 2;
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitInt(CoolParser::IntContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_int" << endl;
+    out_ << "_int" << '\n';
     indent_ += 2;
     print_indent();
-    cout << ctx->INT_CONST()->getText() << endl;
+    out_ << text(ctx->INT_CONST()) << '\n';
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitString(CoolParser::StringContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_string" << endl;
+    out_ << "_string" << '\n';
     indent_ += 2;
     print_indent();
-    cout << "\"" << lexer_->get_string_value(ctx->STR_CONST()->getSymbol()->getStartIndex()) << "\"" << endl;
+    out_ << "\"" << tokens_.get_string_value(ctx->STR_CONST()->getSymbol()->getTokenIndex()) << "\"" << '\n';
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitBool(CoolParser::BoolContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_bool" << endl;
+    out_ << "_bool" << '\n';
     indent_ += 2;
     print_indent();
-    cout << (lexer_->get_bool_value(ctx->BOOL_CONST()->getSymbol()->getStartIndex()) ? "1" : "0") << endl;
+    out_ << (tokens_.get_bool_value(ctx->BOOL_CONST()->getSymbol()->getTokenIndex()) ? "1" : "0") << '\n';
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitMultdiv(CoolParser::MultdivContext *ctx) {
-    string opName = ctx->MULT() ? "_mul" : "_divide";
+    string_view opName = ctx->MULT() ? "_mul" : "_divide";
     return visitBinaryOp(ctx, opName);
 }
 
 std::any TreePrinter::visitSubadd(CoolParser::SubaddContext *ctx) {
-    string opName = ctx->PLUS() ? "_plus" : "_sub";
+    string_view opName = ctx->PLUS() ? "_plus" : "_sub";
     return visitBinaryOp(ctx, opName);
 }
 
 std::any TreePrinter::visitComp(CoolParser::CompContext *ctx) {
-    string opName;
+    // Same check as ChainedCompVisitor, before the operands are visited so
+    // that the errors come out in the same order.
+    if (dynamic_cast<CoolParser::CompContext *>(ctx->expr(0))) {
+        chained_comparisons_.push_back(ctx->LT()   ? ctx->LT()->getSymbol()
+                                       : ctx->LE() ? ctx->LE()->getSymbol()
+                                                   : ctx->EQ()->getSymbol());
+    }
+
+    string_view opName;
     if (ctx->LT())
         opName = "_lt";
     else if (ctx->LE())
@@ -233,93 +295,93 @@ std::any TreePrinter::visitParen(CoolParser::ParenContext *ctx) {
 
 std::any TreePrinter::visitStatdispatch(CoolParser::StatdispatchContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_static_dispatch" << endl;
+    out_ << "_static_dispatch" << '\n';
     indent_ += 2;
 
     visit(ctx->expr(0));
 
     if (ctx->AT()) {
         print_indent();
-        cout << ctx->TYPEID()->getText() << endl;
+        out_ << text(ctx->TYPEID()) << '\n';
     }
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
 
     print_indent();
-    cout << "(" << endl;
+    out_ << "(" << '\n';
     for (size_t i = 1; i < ctx->expr().size(); ++i) {
         visit(ctx->expr(i));
     }
     print_indent();
-    cout << ")" << endl;
+    out_ << ")" << '\n';
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitDispatch(CoolParser::DispatchContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_dispatch" << endl;
+    out_ << "_dispatch" << '\n';
     indent_ += 2;
 
     visit(ctx->expr(0));
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
 
     print_indent();
-    cout << "(" << endl;
+    out_ << "(" << '\n';
     for (size_t i = 1; i < ctx->expr().size(); ++i) {
         visit(ctx->expr(i));
     }
     print_indent();
-    cout << ")" << endl;
+    out_ << ")" << '\n';
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
-std::any TreePrinter::visitSelfdispatch(CoolParser::SelfdispatchContext *ctx) {
+std::any TreePrinter::visitSelfdispatch(CoolParser::IdentifierContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_dispatch" << endl;
+    out_ << "_dispatch" << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_object" << endl;
+    out_ << "_object" << '\n';
     indent_ += 2;
     print_indent();
-    cout << "self" << endl;
+    out_ << "self" << '\n';
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
 
     print_indent();
-    cout << ctx->OBJECTID()->getText() << endl;
+    out_ << text(ctx->OBJECTID()) << '\n';
 
     print_indent();
-    cout << "(" << endl;
+    out_ << "(" << '\n';
     for (auto expr_ctx : ctx->expr()) {
         visit(expr_ctx);
     }
     print_indent();
-    cout << ")" << endl;
+    out_ << ")" << '\n';
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
@@ -327,9 +389,9 @@ std::any TreePrinter::visitSelfdispatch(CoolParser::SelfdispatchContext *ctx) {
 
 std::any TreePrinter::visitCond(CoolParser::CondContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     print_indent();
-    cout << "_cond" << endl;
+    out_ << "_cond" << '\n';
     indent_ += 2;
     
     // visit the condition, then and else expressions
@@ -339,15 +401,15 @@ std::any TreePrinter::visitCond(CoolParser::CondContext *ctx) {
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitLoop(CoolParser::LoopContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     print_indent();
-    cout << "_loop" << endl;
+    out_ << "_loop" << '\n';
     indent_ += 2;
     
     // visit the condition and body expressions
@@ -356,7 +418,7 @@ std::any TreePrinter::visitLoop(CoolParser::LoopContext *ctx) {
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
@@ -364,9 +426,9 @@ std::any TreePrinter::visitLoop(CoolParser::LoopContext *ctx) {
 
 std::any TreePrinter::visitBlock(CoolParser::BlockContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     print_indent();
-    cout << "_block" << endl;
+    out_ << "_block" << '\n';
     indent_ += 2;
 
     for (auto expr_ctx : ctx->expr()) {
@@ -375,7 +437,7 @@ std::any TreePrinter::visitBlock(CoolParser::BlockContext *ctx) {
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
@@ -384,16 +446,16 @@ void TreePrinter::visitLetRecursion(const vector<CoolParser::Let_bindingContext
     auto binding_ctx = bindings[index];
 
     print_indent();
-    cout << '#' << let_index << endl;
+    out_ << '#' << let_index << '\n';
     print_indent();
-    cout << "_let" << endl;
+    out_ << "_let" << '\n';
     indent_ += 2;
 
     // printing current binding info
     print_indent();
-    cout << binding_ctx->OBJECTID()->getText() << endl;
+    out_ << text(binding_ctx->OBJECTID()) << '\n';
     print_indent();
-    cout << binding_ctx->TYPEID()->getText() << endl;
+    out_ << text(binding_ctx->TYPEID()) << '\n';
 
     // visit the initialization expression if exists
     if (binding_ctx->expr()) {
@@ -401,11 +463,11 @@ void TreePrinter::visitLetRecursion(const vector<CoolParser::Let_bindingContext
     // no initialization expression
     } else {
         print_indent();
-        cout << '#' << binding_ctx->OBJECTID()->getSymbol()->getLine() << endl;
+        out_ << '#' << binding_ctx->OBJECTID()->getSymbol()->getLine() << '\n';
         print_indent();
-        cout << "_no_expr" << endl;
+        out_ << "_no_expr" << '\n';
         print_indent();
-        cout << ": _no_type" << endl;
+        out_ << ": _no_type" << '\n';
     }
 
     // if there are more bindings, recurse
@@ -418,7 +480,7 @@ void TreePrinter::visitLetRecursion(const vector<CoolParser::Let_bindingContext
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
 }
 
 std::any TreePrinter::visitLet(CoolParser::LetContext *ctx) {
@@ -440,9 +502,9 @@ std::any TreePrinter::visitLet(CoolParser::LetContext *ctx) {
 
 std::any TreePrinter::visitCase(CoolParser::CaseContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStop()->getLine() << endl;
+    out_ << '#' << ctx->getStop()->getLine() << '\n';
     print_indent();
-    cout << "_typcase" << endl;
+    out_ << "_typcase" << '\n';
     indent_ += 2;
 
     // visit the case variable
@@ -451,15 +513,15 @@ std::any TreePrinter::visitCase(CoolParser::CaseContext *ctx) {
     // visit each branch
     for (size_t i = 0; i < ctx->OBJECTID().size(); ++i) {
         print_indent();
-        cout << '#' << ctx->OBJECTID(i)->getSymbol()->getLine() << endl;
+        out_ << '#' << ctx->OBJECTID(i)->getSymbol()->getLine() << '\n';
         print_indent();
-        cout << "_branch" << endl;
+        out_ << "_branch" << '\n';
         indent_ += 2;
 
         print_indent();
-        cout << ctx->OBJECTID(i)->getText() << endl;
+        out_ << text(ctx->OBJECTID(i)) << '\n';
         print_indent();
-        cout << ctx->TYPEID(i)->getText() << endl;
+        out_ << text(ctx->TYPEID(i)) << '\n';
 
         // visit branch expression
         visit(ctx->expr(i + 1));
@@ -469,23 +531,23 @@ std::any TreePrinter::visitCase(CoolParser::CaseContext *ctx) {
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
 std::any TreePrinter::visitNew(CoolParser::NewContext *ctx) {
     print_indent();
-    cout << '#' << ctx->getStart()->getLine() << endl;
+    out_ << '#' << ctx->getStart()->getLine() << '\n';
     print_indent();
-    cout << "_new" << endl;
+    out_ << "_new" << '\n';
     indent_ += 2;
 
     print_indent();
-    cout << ctx->TYPEID()->getText() << endl;
+    out_ << text(ctx->TYPEID()) << '\n';
 
     indent_ -= 2;
     print_indent();
-    cout << ": _no_type" << endl;
+    out_ << ": _no_type" << '\n';
     return std::any{};
 }
 
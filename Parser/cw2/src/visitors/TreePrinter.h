@@ -6,8 +6,16 @@
 #include "CoolLexer.h"
 #include "CoolParser.h"
 #include "CoolParserBaseVisitor.h"
+#include "BufferedWriter.h"
+#include "ErrorPrinter.h"
+#include "TextBuffer.h"
+#include "ThreadPool.h"
+#include "TokenFile.h"
 #include <string>
+#include <string_view>
 #include <any>
+#include <memory>
+#include <vector>
 
 using namespace std;
 using namespace antlr4;
@@ -15,17 +23,41 @@ using namespace antlr4::tree;
 
 class TreePrinter : public CoolParserBaseVisitor {
 private:
-    CoolLexer *lexer_;
+    const TokenTable &tokens_;
     CoolParser *parser_;
     std::string file_name_;
+    // Renders the classes in parallel, if set.
+    ThreadPool *pool_;
+    // The text rendered by this printer.
+    TextBuffer out_;
+    // The operators of the chained comparisons met while rendering, in order.
+    std::vector<antlr4::Token *> chained_comparisons_;
+    // A printer per class of the program, each rendering its own text, which
+    // follows out_ in the output.
+    std::vector<std::unique_ptr<TreePrinter>> class_printers_;
     int indent_ = 0;
 
     void print_indent();
+    // The text of a token, straight from the source.
+    std::string_view text(antlr4::tree::TerminalNode *node) const;
 
 public:
-    TreePrinter(CoolLexer *lexer, CoolParser *parser, const std::string &file_name);
+    /**
+     * @brief Tokens are looked up in `tokens`, which must hold the tokens the
+     * tree was parsed from. If `pool` is given, classes are rendered on it.
+     */
+    TreePrinter(const TokenTable &tokens, CoolParser *parser, const std::string &file_name,
+                ThreadPool *pool = nullptr);
 
-    void print();
+    /**
+     * @brief Render a tree that is already built, by CoolParser or PrattParser
+     * Chained comparisons are found during the same traversal and, if
+     * `error_printer` is given, reported to it in the order ChainedCompVisitor
+     * would report them, so a separate walk is not needed.
+     */
+    void render(CoolParser::ProgramContext *program, ErrorPrinter *error_printer = nullptr);
+    // Writes the rendered tree to `out`.
+    void write(BufferedWriter &out) const;
 
     /**
      * @brief Visit parse tree and print in indented format
@@ -37,9 +69,8 @@ public:
     std::any visitClass(CoolParser::ClassContext *ctx) override;
     std::any visitAttr(CoolParser::AttrContext *ctx) override;
     std::any visitFormal(CoolParser::FormalContext *ctx) override;
-    std::any visitAssign(CoolParser::AssignContext *ctx) override;
     std::any visitMethod(CoolParser::MethodContext *ctx) override;
-    std::any visitObject(CoolParser::ObjectContext *ctx) override;
+    std::any visitIdentifier(CoolParser::IdentifierContext *ctx) override;
     std::any visitInt(CoolParser::IntContext *ctx) override;
     std::any visitString(CoolParser::StringContext *ctx) override;
     std::any visitBool(CoolParser::BoolContext *ctx) override;
@@ -52,7 +83,6 @@ public:
     std::any visitParen(CoolParser::ParenContext *ctx) override;
     std::any visitStatdispatch(CoolParser::StatdispatchContext *ctx) override;
     std::any visitDispatch(CoolParser::DispatchContext *ctx) override;
-    std::any visitSelfdispatch(CoolParser::SelfdispatchContext *ctx) override;
     std::any visitCond(CoolParser::CondContext *ctx) override;
     std::any visitLoop(CoolParser::LoopContext *ctx) override;
     std::any visitBlock(CoolParser::BlockContext *ctx) override;
@@ -62,33 +92,38 @@ public:
     std::any visitChildren(antlr4::tree::ParseTree *node) override;
 
 private:
+    // The three forms of the `identifier` alternative
+    std::any visitObject(CoolParser::IdentifierContext *ctx);
+    std::any visitAssign(CoolParser::IdentifierContext *ctx);
+    std::any visitSelfdispatch(CoolParser::IdentifierContext *ctx);
+
     // Helper methods for common patterns
     template <typename T>
-    std::any visitBinaryOp(T *ctx, const string &opName) {
+    std::any visitBinaryOp(T *ctx, std::string_view opName) {
         print_indent();
-        cout << '#' << ctx->getStart()->getLine() << endl;
+        out_ << '#' << ctx->getStart()->getLine() << '\n';
         print_indent();
-        cout << opName << endl;
+        out_ << opName << '\n';
         indent_ += 2;
         visit(ctx->expr(0));
         visit(ctx->expr(1));
         indent_ -= 2;
         print_indent();
-        cout << ": _no_type" << endl;
+        out_ << ": _no_type" << '\n';
         return std::any{};
     }
     
     template <typename T>
-    std::any visitUnaryOp(T *ctx, const string &opName) {
+    std::any visitUnaryOp(T *ctx, std::string_view opName) {
         print_indent();
-        cout << '#' << ctx->getStart()->getLine() << endl;
+        out_ << '#' << ctx->getStart()->getLine() << '\n';
         print_indent();
-        cout << opName << endl;
+        out_ << opName << '\n';
         indent_ += 2;
         visit(ctx->expr());
         indent_ -= 2;
         print_indent();
-        cout << ": _no_type" << endl;
+        out_ << ": _no_type" << '\n';
         return std::any{};
     }
 
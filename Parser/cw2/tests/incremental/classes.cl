@@ -0,0 +1,22 @@
+(* Several classes, so that an edit to the first leaves the others to be
+   shifted rather than parsed again. *)
+class A {
+    a : Int <- 1;
+
+    get() : Int { a };
+};
+
+class B inherits A {
+    b : String <- "b";
+
+    name() : String { b.concat("!") };
+};
+
+class Main inherits IO {
+    main() : Object {
+        let x : B <- new B in {
+            out_int(x.get());
+            if x.get() < 2 then out_string(x.name()) else abort() fi;
+        }
+    };
+};
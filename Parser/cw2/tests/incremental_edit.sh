@@ -0,0 +1,67 @@
+#!/bin/sh
+# Checks that a source parsed in slices and then edited prints the same tree
+# as the edited source parsed in one go. The edits are made to the first
+# class, so the classes after it keep their tokens and subtrees, and are only
+# shifted to their new lines.
+#
+# Usage: tests/incremental_edit.sh <driver>
+#
+# where <driver> is a built ParserDriver, which makes the edit with
+# --edit OFFSET LENGTH TEXT FILE. The trees of each edit are diffed, and the
+# script fails if any of them differ.
+
+set -eu
+
+if [ $# -ne 1 ]; then
+    echo "usage: $0 <driver>" >&2
+    exit 2
+fi
+
+driver=$1
+corpus=$(dirname "$0")/incremental
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+# The byte offset of the first match of <pattern> in <file>.
+offset_of() {
+    grep -bo "$2" "$1" | head -n 1 | cut -d: -f1
+}
+
+failed=0
+
+# check <file> <offset> <length> <text>
+check() {
+    # The edited copy keeps the name of the file, which the tree prints.
+    edited=$tmp/$(basename "$1")
+    {
+        head -c "$2" "$1"
+        printf '%s' "$4"
+        tail -c +$(($2 + $3 + 1)) "$1"
+    } > "$edited"
+
+    "$driver" "$edited" > "$tmp/expected" 2>&1 || true
+    "$driver" --edit "$2" "$3" "$4" "$1" > "$tmp/actual" 2>&1 || true
+    if ! diff -u "$tmp/expected" "$tmp/actual"; then
+        echo "Edit at $2 of $1 prints a different tree" >&2
+        failed=$((failed + 1))
+    fi
+}
+
+file=$corpus/classes.cl
+feature=$(offset_of "$file" 'get() : Int')
+
+# New lines push the later classes down.
+check "$file" "$feature" 0 '
+    c : Bool <- true;
+
+'
+# Removed lines pull them up.
+check "$file" "$(offset_of "$file" '    a : Int')" 18 ''
+# A comment grows the edited region if it spans lines, and an unclosed one
+# leaves an error for the parse in one go to report.
+check "$file" "$feature" 0 '(* two
+   lines *) '
+check "$file" "$feature" 0 '(*'
+
+echo "Trees differ for $failed edits"
+[ "$failed" -eq 0 ]
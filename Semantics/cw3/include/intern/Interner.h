@@ -0,0 +1,66 @@
+#ifndef INTERN_INTERNER_H_
+#define INTERN_INTERNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// The id of an interned string. Equal strings get equal symbols, so names can
+// be compared and hashed as plain integers.
+using Symbol = uint32_t;
+
+// Hands out symbols for the identifiers and string constants of a program.
+//
+// The driver creates one interner and shares it with every stage of the
+// compiler, from the lexer to codegen, so the text of each name is stored once
+// and is never copied again. The text lives in an arena of blocks that never
+// move, so the views returned by name() stay valid as long as the interner.
+class Interner {
+  public:
+    // Names that the compiler refers to by itself are interned up front, with
+    // fixed symbols.
+    static constexpr Symbol OBJECT = 0;
+    static constexpr Symbol IO = 1;
+    static constexpr Symbol INT = 2;
+    static constexpr Symbol STRING = 3;
+    static constexpr Symbol BOOL = 4;
+    static constexpr Symbol SELF_TYPE = 5;
+    static constexpr Symbol SELF = 6;
+
+  private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    // The unused tail of the last block.
+    char *free_ = nullptr;
+    size_t free_size_ = 0;
+
+    std::vector<std::string_view> names_;
+    std::unordered_map<std::string_view, Symbol> symbols_;
+
+    // Copies `text` into the arena.
+    std::string_view store(std::string_view text);
+
+  public:
+    Interner();
+
+    Interner(const Interner &) = delete;
+    Interner &operator=(const Interner &) = delete;
+
+    // Returns the symbol of `text`, interning it if it is new.
+    Symbol intern(std::string_view text);
+
+    // Returns the symbol of `text`, if it has been interned.
+    std::optional<Symbol> find(std::string_view text) const;
+
+    std::string_view name(Symbol symbol) const { return names_[symbol]; }
+
+    // The number of distinct strings interned so far.
+    size_t size() const { return names_.size(); }
+};
+
+#endif
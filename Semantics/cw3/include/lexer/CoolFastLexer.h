@@ -0,0 +1,133 @@
+#ifndef LEXER_COOL_FAST_LEXER_H_
+#define LEXER_COOL_FAST_LEXER_H_
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+#include "lexer/StructuralIndex.h"
+
+// A hand-written replacement for the ANTLR generated CoolLexer.
+//
+// The default mode is recognized by a precomputed DFA over a table of
+// character classes, and keywords are told apart from identifiers with a
+// perfect hash instead of one ATN path per keyword. Strings and comments are
+// scanned by tight loops, without calling an action per character.
+//
+// The lexer produces exactly the same tokens as CoolLexer (types, indexes,
+// lines and columns), and the same side data as PayloadLexer: boolean values,
+// symbols of identifiers and string constants and error codes, indexed by
+// token index. Being a TokenSource, it can be plugged into CommonTokenStream
+// and CoolParser as is.
+//
+// Given a StructuralIndex of the source, whitespace and comments are skipped
+// in bulk instead of being scanned one char at a time.
+class CoolFastLexer : public antlr4::TokenSource {
+  public:
+    using ErrorCode = CoolLexer::ErrorCode;
+
+  private:
+    MappedCharStream *input_;
+    const StructuralIndex *index_;
+    std::pair<antlr4::TokenSource *, antlr4::CharStream *> source_;
+    antlr4::TokenFactory<antlr4::CommonToken> *factory_;
+
+    const char *data_;
+    size_t size_;
+
+    // Index of the next char to be lexed and its position in the source.
+    size_t p_ = 0;
+    size_t line_ = 1;
+    size_t column_ = 0;
+
+    // Maximum length of a constant string literal, same as in CoolLexer.
+    static constexpr size_t MAX_STR_CONST = 1024;
+    // Stores the current string literal as it's being built.
+    std::string string_buffer_;
+
+    // One payload per emitted token, laid out as in PayloadLexer.
+    std::vector<int> token_payloads_;
+    // Same as in PayloadLexer.
+    int last_payload_ = 0;
+    bool keep_token_payloads_ = true;
+
+    // Same as in PayloadLexer.
+    Interner own_interner_;
+    Interner *interner_ = &own_interner_;
+
+    // Moves p_ to `end`, keeping track of lines and columns.
+    void advance_to(size_t end);
+    // Same as advance_to, but counts the lines with the index.
+    void jump_to(size_t end);
+
+    std::unique_ptr<antlr4::Token> make_token(size_t type, size_t start,
+                                              size_t stop, size_t line,
+                                              size_t column, int payload = 0);
+
+    // Returns the keyword type of the identifier in [start, end) or
+    // `identifier_type` if it isn't a keyword.
+    size_t keyword_type(size_t start, size_t end, size_t identifier_type) const;
+
+    // Each of these is called with p_ right after the opening sequence and
+    // returns nullptr if the source ends before a token is produced.
+    std::unique_ptr<antlr4::Token> lex_string(size_t start);
+    std::unique_ptr<antlr4::Token> lex_invalid_string(ErrorCode error_code);
+    std::unique_ptr<antlr4::Token> lex_comment();
+    void skip_line_comment();
+
+    // Returns the symbol of the string buffer.
+    Symbol intern_string();
+
+  public:
+    // The index, if any, must be built from the data of `input` and outlive
+    // the lexer.
+    explicit CoolFastLexer(MappedCharStream *input,
+                           const StructuralIndex *index = nullptr);
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override { return line_; }
+    size_t getCharPositionInLine() override { return column_; }
+    antlr4::CharStream *getInputStream() override { return input_; }
+    std::string getSourceName() override { return input_->getSourceName(); }
+    antlr4::TokenFactory<antlr4::CommonToken> *getTokenFactory() override {
+        return factory_;
+    }
+
+    // The side data accessors mirror the ones in PayloadLexer.
+
+    void set_interner(Interner *shared_interner) {
+        interner_ = shared_interner;
+    }
+
+    const std::vector<int> &get_token_payloads() const {
+        return token_payloads_;
+    }
+
+    const int &get_last_payload() const { return last_payload_; }
+
+    void set_keep_token_payloads(bool keep) { keep_token_payloads_ = keep; }
+
+    bool get_bool_value(size_t token_index) const {
+        return token_payloads_[token_index] != 0;
+    }
+
+    Symbol get_symbol(size_t token_index) const {
+        return token_payloads_[token_index];
+    }
+
+    std::string_view get_csl_text(size_t token_index) const {
+        return interner_->name(get_symbol(token_index));
+    }
+
+    ErrorCode get_error_code(size_t token_index) const {
+        return static_cast<ErrorCode>(token_payloads_[token_index]);
+    }
+};
+
+#endif
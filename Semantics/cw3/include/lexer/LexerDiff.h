@@ -0,0 +1,17 @@
+#ifndef LEXER_LEXER_DIFF_H_
+#define LEXER_LEXER_DIFF_H_
+
+#include <ostream>
+#include <string>
+
+// Lexes the file at `file_path` with both CoolLexer (through PayloadLexer) and
+// CoolFastLexer (which skips blanks with a StructuralIndex) and checks that
+// they produce the same tokens, with the same side data. Each lexer is also
+// run with its payload table off, to check that the payloads it streams, as
+// TokenWindow reads them, are the ones it would have kept.
+//
+// The first difference found is described on `out`. Returns whether the two
+// token streams are equal.
+bool diff_lexers(const std::string &file_path, std::ostream &out);
+
+#endif
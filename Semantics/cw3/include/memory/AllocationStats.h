@@ -0,0 +1,56 @@
+#ifndef MEMORY_ALLOCATION_STATS_H_
+#define MEMORY_ALLOCATION_STATS_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Counts of the calls to the global operator new and operator delete, which
+// AllocationStats.cpp replaces for the whole program. Array and nothrow forms
+// are counted too, since by default they call the plain forms.
+struct AllocationCounts {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytes_allocated = 0;
+    // The bytes of the blocks that are allocated and not yet freed, as
+    // malloc_usable_size() counts them, and the most there have been since the
+    // start of the program or the last reset_peak_bytes_live().
+    size_t bytes_live = 0;
+    size_t peak_bytes_live = 0;
+};
+
+// The counts since the start of the program.
+AllocationCounts allocation_counts();
+
+// Restarts the peak of the live bytes from the current live bytes, so that the
+// peak of a single phase can be read at its end.
+void reset_peak_bytes_live();
+
+// Splits the allocations of a run into named phases, e.g. lexing, parsing and
+// teardown, and reports how many each phase made. A phase that is begun again,
+// e.g. once per file, adds to the counts it already has.
+class AllocationPhases {
+  private:
+    struct Phase {
+        std::string name;
+        AllocationCounts counts;
+    };
+    std::vector<Phase> phases_;
+
+    // Index in phases_ of the current phase, or -1 if there is none.
+    int current_ = -1;
+    AllocationCounts current_start_;
+
+    void end_current();
+
+  public:
+    // Ends the current phase, if any, and starts the one called `name`.
+    void begin(const std::string &name);
+    // Ends the current phase.
+    void end();
+
+    void report(std::ostream &out);
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef MEMORY_ARENA_H_
+#define MEMORY_ARENA_H_
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A bump allocator for objects that all die together, like the nodes of a
+// parse tree.
+//
+// Objects are placed one after the other in large chunks, so making one costs
+// a pointer bump instead of a call to malloc. They are not freed one by one:
+// release() runs the destructors that are not trivial in one sweep, in reverse
+// order of construction, and frees the chunks. The destructor of the arena
+// calls release().
+class Arena {
+  private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    // The unused tail of the last chunk.
+    std::byte *free_ = nullptr;
+    size_t free_size_ = 0;
+
+    struct Destructor {
+        void (*destroy)(void *);
+        void *object;
+    };
+    std::vector<Destructor> destructors_;
+
+    size_t bytes_used_ = 0;
+    size_t object_count_ = 0;
+
+    // Returns `size` bytes aligned to `alignment`, from a new chunk if the
+    // current one is too full.
+    void *allocate(size_t size, size_t alignment);
+
+  public:
+    Arena() = default;
+    ~Arena() { release(); }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // Constructs a T in the arena. It lives until release().
+    template <typename T, typename... Args> T *make(Args &&...args) {
+        void *memory = allocate(sizeof(T), alignof(T));
+        T *object = new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back(
+                {[](void *p) { static_cast<T *>(p)->~T(); }, object});
+        }
+        ++object_count_;
+        return object;
+    }
+
+    // Copies `items` into the arena, e.g. to keep a list that was collected
+    // in a scratch vector. The copies live until release().
+    template <typename T> std::span<T> copy(std::span<const T> items) {
+        static_assert(std::is_trivially_copyable_v<T> &&
+                      std::is_trivially_destructible_v<T>);
+        if (items.empty()) {
+            return {};
+        }
+        T *copies =
+            static_cast<T *>(allocate(items.size_bytes(), alignof(T)));
+        std::memcpy(copies, items.data(), items.size_bytes());
+        object_count_ += items.size();
+        return {copies, items.size()};
+    }
+
+    // Destroys every object of the arena and frees its memory. The arena can
+    // be used again afterwards.
+    void release();
+
+    // The number of objects made since the last release().
+    size_t object_count() const { return object_count_; }
+    // The bytes taken by those objects, including padding.
+    size_t bytes_used() const { return bytes_used_; }
+    size_t chunk_count() const { return chunks_.size(); }
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef PARSER_SYNTAX_PARSER_H_
+#define PARSER_SYNTAX_PARSER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "antlr4-runtime.h"
+
+#include "memory/Arena.h"
+#include "parser/TokenWindow.h"
+#include "semantics/untyped-ast/Syntax.h"
+
+// Parses the tokens straight into the untyped AST of untyped-ast/Syntax.h,
+// without the parse tree in between.
+//
+// The grammar, the lookahead and the precedences are those of PrattParser,
+// but where PrattParser makes a context for every rule and a terminal node
+// for every token, this parser makes one node per expression, class or
+// feature, and keeps only their names, types and lines. Lists are collected
+// in scratch stacks that are reused across the whole parse, and copied into
+// the arena once they are complete.
+//
+// The AST keeps no reference to the tokens, so they are read through a
+// TokenWindow, which can take them straight from the lexer and drop them once
+// they are consumed.
+//
+// There is no error recovery either: on the first syntax error parse() gives
+// up, and the tokens should be parsed again by CoolParser, which reports the
+// errors the usual way.
+class SyntaxParser {
+  private:
+    TokenWindow window_;
+
+    Arena &arena_;
+
+    // The lists being collected, innermost last. Each rule remembers the size
+    // of the stack it pushes to, and pops what it pushed when it copies the
+    // list into the arena.
+    std::vector<ExprSyntax *> operands_;
+    std::vector<VardeclSyntax> vardecls_;
+    std::vector<CaseBranchSyntax> branches_;
+    std::vector<FormalSyntax> formals_;
+    std::vector<AttrSyntax> attributes_;
+    std::vector<MethodSyntax> methods_;
+    std::vector<ClassSyntax> classes_;
+
+    // Thrown to unwind the parse at the first syntax error.
+    struct SyntaxError {};
+
+    size_t la(size_t k = 0);
+    int line();
+
+    // Consumes the next token if it has type `type`, and throws SyntaxError
+    // otherwise. Returns the consumed token.
+    WindowToken match(size_t type);
+    // Like match(), and returns the symbol of the token.
+    Symbol match_symbol(size_t type);
+
+    // Moves the items of `stack` from `start` on into the arena.
+    template <typename T>
+    std::span<T> take(std::vector<T> &stack, size_t start);
+
+    const ProgramSyntax *program();
+    void class_();
+    void method();
+    void attr();
+    void formal();
+    void vardecl();
+
+    // Parses an expression whose operators bind at least as tightly as
+    // `precedence`.
+    ExprSyntax *expr(int precedence = 0);
+    ExprSyntax *primary();
+    // Matches a parenthesized, comma separated list of arguments, and pushes
+    // them to operands_.
+    void arguments();
+
+    ExprSyntax *make_expr(ExprSyntax::Kind kind, int line);
+
+  public:
+    // `tokens` is filled, and is left positioned at its first token.
+    // `token_payloads` are the payloads of the lexer that produced them. The
+    // nodes of the AST are made in `arena`.
+    SyntaxParser(antlr4::BufferedTokenStream *tokens,
+                 const std::vector<int> &token_payloads, Arena &arena);
+    // Reads the tokens from `lexer` as it makes them, and keeps none of those
+    // it consumed. `last_payload` is as for TokenWindow.
+    SyntaxParser(antlr4::TokenSource *lexer, const int &last_payload,
+                 Arena &arena);
+
+    // Parses the whole program. Returns nullptr if the tokens have a syntax
+    // error. The AST lives until the arena is released.
+    const ProgramSyntax *parse();
+
+    const TokenWindow &window() const { return window_; }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef PARSER_TOKEN_WINDOW_H_
+#define PARSER_TOKEN_WINDOW_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "antlr4-runtime.h"
+
+// A token as SyntaxParser reads it. Only what the AST keeps of a token is
+// copied, so the token itself can be freed as soon as it is read.
+struct WindowToken {
+    size_t type;
+    int line;
+    // The payload of the lexer, except for INT_CONST and BOOL_CONST, whose
+    // value is read from the text, the way TypeChecker reads it.
+    int payload;
+};
+
+// The tokens of the default channel, seen through a window of the next few.
+//
+// CommonTokenStream keeps every token of the file until the parse is over,
+// and the lexer keeps a payload per token next to it, so both grow with the
+// input. Read straight from a lexer, the window instead pulls a token only
+// once it is looked at, copies it into a WindowToken and frees it, and keeps
+// nothing of the tokens that were consumed. The lexer should be told not to
+// keep its payloads either, and the window reads the payload of each token as
+// it is emitted.
+//
+// The window can also read a filled token stream, so that the same parser
+// works on both.
+class TokenWindow {
+  public:
+    // SyntaxParser looks at most two tokens ahead.
+    static constexpr size_t CAPACITY = 4;
+
+  private:
+    // Either the lexer or the token stream is set.
+    antlr4::TokenSource *lexer_ = nullptr;
+    const int *last_payload_ = nullptr;
+    antlr4::BufferedTokenStream *tokens_ = nullptr;
+    const std::vector<int> *token_payloads_ = nullptr;
+    // Index in tokens_ of the next token to be read.
+    size_t next_token_ = 0;
+
+    // The tokens read but not consumed, in a ring indexed by the number of
+    // tokens before them.
+    std::array<WindowToken, CAPACITY> ring_;
+    size_t consumed_ = 0;
+    size_t read_ = 0;
+    // The EOF token, which is read again once the input is over.
+    bool at_eof_ = false;
+    WindowToken eof_;
+
+    size_t max_lookahead_ = 0;
+
+    WindowToken read();
+
+  public:
+    // Reads the tokens of `lexer` as it makes them. `last_payload` is the
+    // payload of the token that `lexer` made last, e.g.
+    // PayloadLexer::get_last_payload().
+    TokenWindow(antlr4::TokenSource *lexer, const int &last_payload);
+    // Reads the tokens of `tokens`, whose payloads are `token_payloads`.
+    TokenWindow(antlr4::BufferedTokenStream *tokens,
+                const std::vector<int> &token_payloads);
+
+    // The token `k` tokens after the next one to be consumed, for k below
+    // CAPACITY. Past the end of the input, this is EOF.
+    const WindowToken &peek(size_t k = 0);
+    // Consumes the next token.
+    WindowToken consume();
+
+    // How many tokens the window held at most, i.e. the lookahead that the
+    // parser used.
+    size_t max_lookahead() const { return max_lookahead_; }
+    size_t consumed() const { return consumed_; }
+};
+
+#endif
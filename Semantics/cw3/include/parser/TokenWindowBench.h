@@ -0,0 +1,19 @@
+#ifndef PARSER_TOKEN_WINDOW_BENCH_H_
+#define PARSER_TOKEN_WINDOW_BENCH_H_
+
+#include <ostream>
+#include <string>
+
+// Measures what the file at `file_path` needs of its tokens to be parsed.
+//
+// CoolParser is profiled to find how many tokens ahead its decisions look at
+// most. Then SyntaxParser parses the file twice, from a filled
+// CommonTokenStream and through a TokenWindow fed by the lexer, and the peak
+// of the bytes live on the heap is reported for each, along with the bytes of
+// the AST, which both keep.
+//
+// Returns whether the file could be read, has no syntax errors and both
+// parses agree.
+bool bench_token_window(const std::string &file_path, std::ostream &out);
+
+#endif
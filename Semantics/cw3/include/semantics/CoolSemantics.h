@@ -5,38 +5,53 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <map>
-#include <set>
 
-#include "CoolLexer.h"
 #include "CoolParser.h"
+#include "intern/Interner.h"
+#include "TypeTable.h"
 #include "typed-ast/Methods.h"
 #include "typed-ast/Attributes.h"
+#include "untyped-ast/Syntax.h"
 
-struct MethodInfo {
-    std::string return_type;
-    std::vector<std::string> arg_types;
-    CoolParser::MethodContext* ctx;
-    bool error = false;
-};
+// Reads the symbols that the lexer interned for the OBJECTID, TYPEID and
+// STR_CONST tokens of the parse tree, so that names are never copied out of
+// the tokens.
+class TokenSymbols {
+  private:
+    Interner &interner_;
+    // The payloads of the lexer, indexed by token index.
+    const std::vector<int> &token_payloads_;
 
-struct AttributeInfo {
-    std::string type;
-    CoolParser::AttrContext* ctx;
-};
+  public:
+    TokenSymbols(Interner &interner, const std::vector<int> &token_payloads)
+        : interner_(interner), token_payloads_(token_payloads) {}
 
-struct ClassInfo {
-    std::string name;
-    std::string parent;
-    std::map<std::string, MethodInfo> methods;
-    std::map<std::string, AttributeInfo> attributes;
-    CoolParser::ClassContext* ctx;
-    int depth = -1;
+    Symbol symbol(antlr4::tree::TerminalNode *node) const {
+        // Tokens that CoolParser conjures up while recovering from a syntax
+        // error, e.g. the missing TYPEID in `class A inherits {`, never came
+        // from the lexer and have no payload. Their text is interned instead.
+        size_t index = node->getSymbol()->getTokenIndex();
+        if (index >= token_payloads_.size()) {
+            return interner_.intern(node->getText());
+        }
+        return token_payloads_[index];
+    }
+
+    std::string_view name(Symbol symbol) const {
+        return interner_.name(symbol);
+    }
+
+    std::string_view name(antlr4::tree::TerminalNode *node) const {
+        return name(symbol(node));
+    }
+
+    // Copies the name, e.g. for an error message.
+    std::string str(Symbol symbol) const { return std::string(name(symbol)); }
 };
 
 struct TypedClass {
-    std::string name;
-    std::string parent;
+    Symbol name;
+    Symbol parent;
     std::string filename;
     int line;
     Attributes attributes;
@@ -49,15 +64,26 @@ struct TypedProgram {
 
 class CoolSemantics {
   private:
-    CoolLexer *lexer_;
-    CoolParser *parser_;
-    std::map<std::string, ClassInfo> classes_;
-    std::map<std::string, int> type_ids_;
-    std::vector<std::string> type_names_;
+    TokenSymbols symbols_;
+    CoolParser::ProgramContext *program_ = nullptr;
+    const ProgramSyntax *program_syntax_ = nullptr;
+    TypeTable types_;
 
   public:
-    CoolSemantics(CoolLexer *lexer, CoolParser *parser)
-        : lexer_(lexer), parser_(parser) {}
+    // `program` is the tree of the whole program, from CoolParser or
+    // PrattParser. `token_payloads` are the payloads of the lexer that produced
+    // its tokens, which interns into `interner`.
+    CoolSemantics(Interner &interner,
+                  const std::vector<int> &token_payloads,
+                  CoolParser::ProgramContext *program)
+        : symbols_(interner, token_payloads), program_(program) {}
+
+    // `program` is the untyped AST of the whole program, from SyntaxParser.
+    // It is checked by TypeAnnotator instead of TypeChecker.
+    CoolSemantics(Interner &interner,
+                  const std::vector<int> &token_payloads,
+                  const ProgramSyntax *program)
+        : symbols_(interner, token_payloads), program_syntax_(program) {}
 
     // Runs semantic analysis and returns the typed AST generated in the
     // process
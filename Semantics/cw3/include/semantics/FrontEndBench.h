@@ -0,0 +1,17 @@
+#ifndef SEMANTICS_FRONT_END_BENCH_H_
+#define SEMANTICS_FRONT_END_BENCH_H_
+
+#include <ostream>
+#include <string>
+
+// Lexes the file at `file_path` once, then times parsing plus semantic
+// analysis of its tokens with each front end: CoolParser and PrattParser with
+// TypeChecker, and SyntaxParser with TypeAnnotator. Reports on `out` the best
+// of a few runs of each, the nodes and bytes that the hand-written parsers
+// put in their arenas, and whether the three agree on the result.
+//
+// Returns whether the file could be read, has no syntax errors and the front
+// ends agree.
+bool bench_front_ends(const std::string &file_path, std::ostream &out);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef SEMANTICS_TYPE_TABLE_H_
+#define SEMANTICS_TYPE_TABLE_H_
+
+#include <cstddef>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "CoolParser.h"
+#include "intern/Interner.h"
+#include "untyped-ast/Syntax.h"
+
+// The type index of a name that is not a type, e.g. of an undefined class.
+constexpr int NO_TYPE = -1;
+
+struct MethodInfo {
+    // The types as declared, which may be undefined, so that the errors can
+    // name them.
+    Symbol return_type;
+    std::vector<Symbol> arg_types;
+    CoolParser::MethodContext* ctx;
+    bool error = false;
+};
+
+struct AttributeInfo {
+    Symbol name;
+    int type;
+    CoolParser::AttrContext* ctx;
+};
+
+struct ClassInfo {
+    Symbol name;
+    // NO_TYPE for Object and for a class whose parent is undefined.
+    int parent = NO_TYPE;
+    // Keyed by the interned names, which outlive the table.
+    std::map<std::string_view, MethodInfo> methods;
+    std::map<std::string_view, AttributeInfo> attributes;
+    CoolParser::ClassContext* ctx;
+    int depth = -1;
+    // One past the type index of the last heir of the class, once the classes
+    // are numbered depth-first.
+    int subtree_end = -1;
+    // Set instead of ctx when the program comes from SyntaxParser.
+    const ClassSyntax* syntax = nullptr;
+};
+
+// The classes of a program, by type index.
+//
+// The type indices are dense: the classes take the first ones, and SELF_TYPE
+// the one after the last class. They are the type ids of the typed AST, so a
+// type is checked as a plain int and only named when an error is reported.
+//
+// Once the hierarchy is known to be a tree, the classes are numbered in the
+// depth-first order of the hierarchy, Object first and every class followed
+// by its heirs. The heirs of a class then have the indices up to its
+// subtree_end, and whether a class inherits from another takes two
+// comparisons, however deep the hierarchy. The least upper bound of two
+// classes is the parent of the shallowest class with an index after the
+// first of them, up to the second, which a sparse table finds in constant
+// time too.
+class TypeTable {
+  private:
+    std::vector<ClassInfo> classes_;
+    // The type index of each symbol, NO_TYPE for the symbols that name no
+    // type. The symbols past its end name no type either.
+    std::vector<int> indices_;
+    int object_ = NO_TYPE;
+    // A sparse table over the depth-first order: shallowest_[k][i] is the
+    // shallowest class among those with the indices i to i + 2^k - 1.
+    std::vector<std::vector<int>> shallowest_;
+
+    void index_least_upper_bounds();
+
+  public:
+    TypeTable() = default;
+    // `classes` are in the order of their type indices.
+    explicit TypeTable(std::vector<ClassInfo> classes);
+
+    // The type index of the class or SELF_TYPE called `name`, or NO_TYPE.
+    int index(Symbol name) const {
+        return name < indices_.size() ? indices_[name] : NO_TYPE;
+    }
+    Symbol name(int type) const {
+        return type == self_type() ? Interner::SELF_TYPE : classes_[type].name;
+    }
+
+    int self_type() const { return static_cast<int>(classes_.size()); }
+    bool is_class(int type) const { return type >= 0 && type < self_type(); }
+    size_t class_count() const { return classes_.size(); }
+
+    ClassInfo &at(int type) { return classes_[type]; }
+    const ClassInfo &at(int type) const { return classes_[type]; }
+
+    // Numbers the classes depth-first, the heirs of a class in the order of
+    // their current indices, and computes their depths, subtree ends and the
+    // index of least upper bounds. The parents must form a tree. Returns the
+    // new index of each class, by its old one.
+    std::vector<int> number_depth_first();
+
+    // Whether the class `type` is `ancestor` or one of its heirs. Requires
+    // number_depth_first().
+    bool is_subclass(int type, int ancestor) const {
+        return ancestor <= type && type < classes_[ancestor].subtree_end;
+    }
+
+    // Whether `type1` conforms to `type2`, SELF_TYPE standing for
+    // `self_class`, the class being checked.
+    bool conforms(int type1, int type2, int self_class) const;
+    // The least upper bound of `type1` and `type2`. Requires
+    // number_depth_first().
+    int lub(int type1, int type2, int self_class) const;
+    // Returns the method called `method_name` of the class `type` or of its
+    // nearest ancestor that has one, or nullptr if there is none.
+    const MethodInfo *find_method(int type,
+                                  std::string_view method_name) const;
+};
+
+#endif
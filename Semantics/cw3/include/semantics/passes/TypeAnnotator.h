@@ -0,0 +1,83 @@
+#ifndef SEMANTICS_PASSES_TYPE_ANNOTATOR_H_
+#define SEMANTICS_PASSES_TYPE_ANNOTATOR_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "semantics/CoolSemantics.h"
+#include "semantics/ScopedSymbolTable.h"
+#include "semantics/passes/TypeChecker.h"
+#include "semantics/typed-ast/Attribute.h"
+#include "semantics/typed-ast/Expr.h"
+#include "semantics/typed-ast/Method.h"
+#include "semantics/untyped-ast/Syntax.h"
+
+// The TypeChecker of the untyped AST that SyntaxParser builds.
+//
+// It applies the same rules as TypeChecker, in the same order, so it reports
+// the same errors and builds the same typed AST; only the input differs. Each
+// node already says what kind of expression it is, so the annotator switches
+// on the kind, where TypeChecker has to tell the alternatives of `expr` apart
+// by their tokens.
+class TypeAnnotator {
+  private:
+    std::vector<ErrorMessagePrinter> errors;
+
+    const TokenSymbols &symbols;
+    const TypeTable &types;
+    // the types that the rules refer to by name
+    const int object_type;
+    const int int_type;
+    const int string_type;
+    const int bool_type;
+    const int self_type;
+
+    // the objects in scope, with their types
+    ScopedSymbolTable symbol_table;
+
+    int current_class = NO_TYPE;
+
+    TypedProgram typed_program;
+
+    void annotateClass(const ClassSyntax &syntax);
+    // Return nullptr if the declared types are undefined.
+    std::unique_ptr<Method> annotateMethod(const MethodSyntax &syntax);
+    std::unique_ptr<Attribute> annotateAttr(const AttrSyntax &syntax);
+    std::unique_ptr<Expr> annotateExpr(const ExprSyntax &syntax);
+    // Self, dynamic and static dispatch.
+    std::unique_ptr<Expr> annotateDispatch(const ExprSyntax &syntax);
+
+    // Checks the arguments of a call to `method` against its signature.
+    void checkArguments(const MethodInfo &method, Symbol method_name,
+                        int lookup_type,
+                        const std::vector<std::unique_ptr<Expr>> &args);
+
+    // helper methods
+    void enterScope();
+    void exitScope();
+    void addSymbol(Symbol name, int type);
+    // NO_TYPE if `name` is not in scope
+    int lookupSymbol(Symbol name);
+    bool conform(int type1, int type2);
+    int lub(int type1, int type2);
+    // Copies the name of `type`, for an error message.
+    std::string typeName(int type) const;
+
+  public:
+    TypeAnnotator(const TokenSymbols &symbols, const TypeTable &types)
+        : symbols(symbols), types(types),
+          object_type(types.index(Interner::OBJECT)),
+          int_type(types.index(Interner::INT)),
+          string_type(types.index(Interner::STRING)),
+          bool_type(types.index(Interner::BOOL)),
+          self_type(types.self_type()) {}
+
+    // Typechecks the untyped AST and returns a list of errors, if any
+    std::vector<std::string> annotate(const ProgramSyntax &program);
+
+    TypedProgram getTypedProgram() { return std::move(typed_program); }
+};
+
+#endif
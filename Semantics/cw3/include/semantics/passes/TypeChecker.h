@@ -1,7 +1,6 @@
 #ifndef SEMANTICS_PASSES_TYPE_CHECKER_H_
 #define SEMANTICS_PASSES_TYPE_CHECKER_H_
 
-#include <any>
 #include <string>
 #include <vector>
 #include <map>
@@ -9,9 +8,12 @@
 #include <variant>
 
 #include "CoolParser.h"
-#include "CoolParserBaseVisitor.h"
+#include "semantics/typed-ast/Arithmetic.h"
+#include "semantics/typed-ast/Attribute.h"
 #include "semantics/typed-ast/Expr.h"
+#include "semantics/typed-ast/Method.h"
 #include "semantics/CoolSemantics.h"
+#include "semantics/ScopedSymbolTable.h"
 
 struct ErrorMessagePrinter {
   enum class MethodError {
@@ -71,51 +73,79 @@ struct ErrorMessagePrinter {
   std::string to_string() const;
 };
 
-class TypeChecker : public CoolParserBaseVisitor {
+// Typechecks the parse tree and builds the typed AST from it.
+//
+// Each visit method returns what it builds, e.g. the typed expression of an
+// `expr`, rather than going through the std::any of a CoolParserVisitor.
+class TypeChecker {
   private:
     // all errors
     std::vector<ErrorMessagePrinter> errors;
 
-    const std::map<std::string, ClassInfo>& classes;
-    const std::map<std::string, int>& type_ids;
-    const std::vector<std::string>& type_names;
+    const TokenSymbols& symbols;
+    const TypeTable& types;
+    // the types that the rules refer to by name
+    const int object_type;
+    const int int_type;
+    const int string_type;
+    const int bool_type;
+    const int self_type;
     
-    // symbol table for every scope
-    std::vector<std::map<std::string, std::string>> symbol_table;
+    // the objects in scope, with their types
+    ScopedSymbolTable symbol_table;
 
-    // to bypass any
-    std::stack<std::unique_ptr<Expr>> scratchpad;
-    
     // track current class
-    std::string current_class;
+    int current_class = NO_TYPE;
     
     TypedProgram typed_program;
 
-    // override necessary visitor methods
-    std::any visitProgram(CoolParser::ProgramContext *ctx) override;
-    std::any visitClass(CoolParser::ClassContext *ctx) override;
-    std::any visitMethod(CoolParser::MethodContext *ctx) override;
-    std::any visitAttr(CoolParser::AttrContext *ctx) override;
-    std::any visitFormal(CoolParser::FormalContext *ctx) override;
-    std::any visitExpr(CoolParser::ExprContext *ctx) override;
+    void visitProgram(CoolParser::ProgramContext *ctx);
+    void visitClass(CoolParser::ClassContext *ctx);
+    // Return nullptr if the declared types are undefined.
+    std::unique_ptr<Method> visitMethod(CoolParser::MethodContext *ctx);
+    std::unique_ptr<Attribute> visitAttr(CoolParser::AttrContext *ctx);
+    // Dispatches on the alternative of `expr`, which all share ExprContext.
+    std::unique_ptr<Expr> visitExpr(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitInt(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitString(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitBool(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitObject(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitAssignment(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitSelfDispatch(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitNew(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitCond(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitLoop(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitBlock(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitLet(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitCase(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitDispatch(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitArithmetic(CoolParser::ExprContext *ctx,
+                                          Arithmetic::Kind op);
+    std::unique_ptr<Expr> visitCompare(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitNot(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitNeg(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitIsvoid(CoolParser::ExprContext *ctx);
+    std::unique_ptr<Expr> visitParen(CoolParser::ExprContext *ctx);
 
     // helper methods
     void enterScope();
     void exitScope();
-    void addSymbol(std::string name, std::string type);
-    std::string lookupSymbol(std::string name);
-    bool conform(std::string type1, std::string type2);
-    std::string lub(std::string type1, std::string type2);
-    std::string get_parent(std::string type);
-    
-    // method for scratchpad
-    std::unique_ptr<Expr> visitExprAndAssertOk(CoolParser::ExprContext *ctx);
+    void addSymbol(Symbol name, int type);
+    // NO_TYPE if `name` is not in scope
+    int lookupSymbol(Symbol name);
+    bool conform(int type1, int type2);
+    int lub(int type1, int type2);
+    // Copies the name of `type`, for an error message.
+    std::string typeName(int type) const;
 
   public:
-    TypeChecker(const std::map<std::string, ClassInfo>& classes,
-                const std::map<std::string, int>& type_ids,
-                const std::vector<std::string>& type_names) 
-        : classes(classes), type_ids(type_ids), type_names(type_names) {}
+    TypeChecker(const TokenSymbols& symbols, const TypeTable& types)
+        : symbols(symbols), types(types),
+          object_type(types.index(Interner::OBJECT)),
+          int_type(types.index(Interner::INT)),
+          string_type(types.index(Interner::STRING)),
+          bool_type(types.index(Interner::BOOL)),
+          self_type(types.self_type()) {}
 
     // Typechecks the AST that the parser produces and returns a list of errors,
     // if any
@@ -2,25 +2,24 @@
 #define SEMANTICS_TYPED_AST_ATTRIBUTE_H_
 
 #include <memory>
-#include <string>
 #include <utility>
 #include <vector>
 
 #include "Expr.h"
+#include "intern/Interner.h"
 
 class Attribute {
   private:
-    std::string name_;
+    Symbol name_;
     int type_;
     std::unique_ptr<Expr> initializer_;
 
   public:
-    Attribute(std::string name, int type)
-        : name_(std::move(name)), type_(std::move(type)) {}
+    Attribute(Symbol name, int type) : name_(name), type_(type) {}
 
     const int &get_type() const { return type_; }
 
-    const std::string &get_name() const { return name_; }
+    Symbol get_name() const { return name_; }
 
     const Expr *get_initializer() const { return initializer_.get(); }
 
@@ -2,9 +2,9 @@
 #define SEMANTICS_TYPED_AST_CASE_OF_ESAC_H_
 
 #include "Expr.h"
+#include "intern/Interner.h"
 
 #include <memory>
-#include <string>
 #include <utility>
 #include <vector>
 
@@ -12,15 +12,15 @@ class CaseOfEsac : public Expr {
   public:
     class Case {
       private:
-        std::string name_;
+        Symbol name_;
         int type_;
         std::unique_ptr<Expr> expr_;
 
       public:
-        Case(std::string name, int type, std::unique_ptr<Expr> expr)
-            : name_(std::move(name)), type_(type), expr_(std::move(expr)) {}
+        Case(Symbol name, int type, std::unique_ptr<Expr> expr)
+            : name_(name), type_(type), expr_(std::move(expr)) {}
 
-        const std::string &get_name() const { return name_; }
+        Symbol get_name() const { return name_; }
         int get_type() const { return type_; }
         const Expr *get_expr() const { return expr_.get(); }
     };
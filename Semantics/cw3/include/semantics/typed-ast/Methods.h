@@ -3,7 +3,6 @@
 
 #include <memory>
 #include <optional>
-#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -14,26 +13,26 @@ class Methods {
     // This design keeps the order of the methods the same as their order of
     // being added to the class, while allowing quick lookup by name.
     std::vector<Method> methods_;
-    std::unordered_map<std::string, int> method_name_to_index_;
+    std::unordered_map<Symbol, int> method_name_to_index_;
 
   public:
     std::optional<std::vector<int>>
-    get_signature(const std::string &method_name);
+    get_signature(Symbol method_name);
 
     void add_method(Method &&method);
 
-    bool contains(const std::string &method_name);
+    bool contains(Symbol method_name);
 
-    std::vector<std::string> get_names();
+    std::vector<Symbol> get_names();
 
-    void set_argument_names(const std::string &method_name,
-                            std::vector<std::string> argument_names);
+    void set_argument_names(Symbol method_name,
+                            std::vector<Symbol> argument_names);
 
-    std::vector<std::string> get_argument_names(const std::string &method_name);
+    std::vector<Symbol> get_argument_names(Symbol method_name);
 
-    void set_body(const std::string &method_name, std::unique_ptr<Expr> &&body);
+    void set_body(Symbol method_name, std::unique_ptr<Expr> &&body);
 
-    const Expr *get_body(const std::string &method_name);
+    const Expr *get_body(Symbol method_name);
 };
 
 #endif
@@ -2,19 +2,16 @@
 #define SEMANTICS_TYPED_AST_OBJECT_REFERENCE_H_
 
 #include "Expr.h"
-
-#include <string>
-#include <utility>
+#include "intern/Interner.h"
 
 class ObjectReference : public Expr {
   private:
-    std::string name_;
+    Symbol name_;
 
   public:
-    ObjectReference(std::string name, int type)
-        : Expr(type), name_(std::move(name)) {}
+    ObjectReference(Symbol name, int type) : Expr(type), name_(name) {}
 
-    const std::string &get_name() const { return name_; }
+    Symbol get_name() const { return name_; }
 };
 
 #endif
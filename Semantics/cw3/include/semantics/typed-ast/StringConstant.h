@@ -2,19 +2,17 @@
 #define SEMANTICS_TYPED_AST_STRING_CONSTANT_H_
 
 #include "Expr.h"
-
-#include <string>
-#include <utility>
+#include "intern/Interner.h"
 
 class StringConstant : public Expr {
   private:
-    std::string value_;
+    // The symbol of the decoded contents of the literal.
+    Symbol value_;
 
   public:
-    StringConstant(std::string value, int type)
-        : Expr(type), value_(std::move(value)) {}
+    StringConstant(Symbol value, int type) : Expr(type), value_(value) {}
 
-    const std::string &get_value() const { return value_; }
+    Symbol get_value() const { return value_; }
 };
 
 #endif
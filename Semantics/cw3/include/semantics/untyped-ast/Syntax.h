@@ -0,0 +1,113 @@
+#ifndef SEMANTICS_UNTYPED_AST_SYNTAX_H_
+#define SEMANTICS_UNTYPED_AST_SYNTAX_H_
+
+#include <span>
+
+#include "intern/Interner.h"
+
+// The untyped AST that SyntaxParser builds straight from the tokens, for
+// TypeAnnotator to turn into the typed AST.
+//
+// It holds what the typed AST needs and nothing of the parse tree: no tokens,
+// no terminal nodes, only symbols and the lines that end up in the output.
+// Every node lives in the Arena of the parser, and lists are spans into it,
+// so the nodes are plain structs without destructors.
+
+struct VardeclSyntax;
+struct CaseBranchSyntax;
+
+struct ExprSyntax {
+    enum class Kind {
+        Object,
+        IntConstant,
+        StringConstant,
+        BoolConstant,
+        Assignment,
+        // A dispatch without a target, to self.
+        SelfDispatch,
+        DynamicDispatch,
+        StaticDispatch,
+        NewObject,
+        IfThenElseFi,
+        WhileLoopPool,
+        Sequence,
+        LetIn,
+        CaseOfEsac,
+        Addition,
+        Subtraction,
+        Multiplication,
+        Division,
+        LessThan,
+        LessThanEqual,
+        Equal,
+        BooleanNegation,
+        IntegerNegation,
+        IsVoid,
+        Parenthesized
+    };
+
+    Kind kind;
+    // The line of the first token.
+    int line;
+    // The variable of Object and Assignment, the method of a dispatch, and the
+    // string of StringConstant.
+    Symbol name = 0;
+    // The type of NewObject and the static type of StaticDispatch.
+    Symbol type = 0;
+    // The value of IntConstant and BoolConstant.
+    int value = 0;
+    // The subexpressions, in source order. A dispatch has its target first,
+    // then its arguments; LetIn has its body, and CaseOfEsac the expression
+    // it examines.
+    std::span<ExprSyntax *> operands;
+    std::span<VardeclSyntax> vardecls;
+    std::span<CaseBranchSyntax> branches;
+};
+
+struct VardeclSyntax {
+    Symbol name;
+    Symbol type;
+    // Null if there is none.
+    ExprSyntax *initializer;
+};
+
+struct CaseBranchSyntax {
+    Symbol name;
+    Symbol type;
+    ExprSyntax *body;
+};
+
+struct FormalSyntax {
+    Symbol name;
+    Symbol type;
+};
+
+struct MethodSyntax {
+    Symbol name;
+    std::span<FormalSyntax> formals;
+    Symbol return_type;
+    ExprSyntax *body;
+};
+
+struct AttrSyntax {
+    Symbol name;
+    Symbol type;
+    // Null if there is none.
+    ExprSyntax *initializer;
+};
+
+struct ClassSyntax {
+    Symbol name;
+    Symbol parent;
+    int line;
+    // Attributes and methods are kept apart, each in source order, which is
+    // all that semantic analysis looks at.
+    std::span<AttrSyntax> attributes;
+    std::span<MethodSyntax> methods;
+};
+
+struct ProgramSyntax {
+    std::span<ClassSyntax> classes;
+};
+
+#endif
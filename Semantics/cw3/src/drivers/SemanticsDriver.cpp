@@ -1,5 +1,6 @@
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,7 +9,24 @@
 #include "CoolLexer.h"
 #include "CoolParser.h"
 
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+#include "lexer/CoolFastLexer.h"
+#include "lexer/LexerDiff.h"
+#include "lexer/PayloadLexer.h"
+#include "lexer/StructuralIndex.h"
+#include "lexer/StructureScan.h"
+#include "memory/AllocationStats.h"
+#include "memory/Arena.h"
+#include "parser/ParseProfile.h"
+#include "parser/ParserDiff.h"
+#include "parser/PrattParser.h"
+#include "parser/SyntaxParser.h"
+#include "parser/TokenWindowBench.h"
+#include "parser/TwoStageParse.h"
 #include "semantics/CoolSemantics.h"
+#include "semantics/FrontEndBench.h"
+#include "semantics/HierarchyBench.h"
 
 using namespace std;
 using namespace antlr4;
@@ -19,30 +37,246 @@ namespace fs = filesystem;
 constexpr bool debug = false;
 
 int main(int argc, const char *argv[]) {
-    if (argc != 2) {
+    vector<string> args(argv + 1, argv + argc);
+
+    // --diff-lexers checks that CoolFastLexer and CoolLexer produce the same
+    // tokens for each of the given files.
+    if (!args.empty() && args[0] == "--diff-lexers") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!diff_lexers(args[i], cerr)) {
+                ++failed;
+            }
+        }
+        cout << "Lexers differ on " << failed << " of " << args.size() - 1
+             << " files" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --scan reports the structural errors of each of the given files and how
+    // fast their StructuralIndex is built.
+    if (!args.empty() && args[0] == "--scan") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!scan_structure(args[i], cout)) {
+                ++failed;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --diff-parsers checks that PrattParser and CoolParser build the same
+    // tree for each of the given files.
+    if (!args.empty() && args[0] == "--diff-parsers") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!diff_parsers(args[i], cerr)) {
+                ++failed;
+            }
+        }
+        cout << "Parsers differ on " << failed << " of " << args.size() - 1
+             << " files" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --bench-front-ends times parsing plus semantic analysis of each of the
+    // given files with every parser, including SyntaxParser.
+    if (!args.empty() && args[0] == "--bench-front-ends") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!bench_front_ends(args[i], cout)) {
+                ++failed;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --bench-hierarchy times subtype tests on deep and wide made-up class
+    // hierarchies.
+    if (!args.empty() && args[0] == "--bench-hierarchy") {
+        bench_hierarchy(cout);
+        return 0;
+    }
+
+    // --bench-token-window measures the lookahead of the parsers on each of the
+    // given files, and the memory that SyntaxParser needs with and without a
+    // TokenWindow.
+    if (!args.empty() && args[0] == "--bench-token-window") {
+        size_t failed = 0;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!bench_token_window(args[i], cout)) {
+                ++failed;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --profile-parser profiles the decisions of CoolParser on each of the
+    // given files, and writes the profiles as a JSON array.
+    if (!args.empty() && args[0] == "--profile-parser") {
+        size_t failed = 0;
+        cout << "[";
+        for (size_t i = 1; i < args.size(); ++i) {
+            cout << (i == 1 ? "\n" : ",\n");
+            if (!profile_parser(args[i], cout)) {
+                ++failed;
+            }
+        }
+        cout << "\n]" << endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // --fast-lexer selects CoolFastLexer instead of CoolLexer, and --pratt
+    // selects PrattParser instead of CoolParser. --ast selects SyntaxParser,
+    // which skips the parse tree and builds the untyped AST that TypeAnnotator
+    // checks. With --window, SyntaxParser reads the tokens as they are lexed,
+    // and keeps none of them. --sll makes CoolParser parse
+    // in two stages, SLL then LL, and --parse-stats reports how often the LL
+    // stage was needed. --alloc-stats reports the allocations of each phase of
+    // the run.
+    bool use_fast_lexer = false;
+    bool use_pratt_parser = false;
+    bool use_syntax_parser = false;
+    bool use_token_window = false;
+    bool use_two_stage = false;
+    bool print_parse_stats = false;
+    bool print_alloc_stats = false;
+    for (; !args.empty(); args.erase(args.begin())) {
+        if (args[0] == "--fast-lexer") {
+            use_fast_lexer = true;
+        } else if (args[0] == "--pratt") {
+            use_pratt_parser = true;
+        } else if (args[0] == "--ast") {
+            use_syntax_parser = true;
+        } else if (args[0] == "--window") {
+            use_token_window = true;
+        } else if (args[0] == "--sll") {
+            use_two_stage = true;
+        } else if (args[0] == "--parse-stats") {
+            print_parse_stats = true;
+        } else if (args[0] == "--alloc-stats") {
+            print_alloc_stats = true;
+        } else {
+            break;
+        }
+    }
+
+    if (args.size() != 1) {
         cerr << "Expecting exactly one argument: name of input file" << endl;
         return 1;
     }
 
-    auto file_path = argv[1];
-    ifstream fin(file_path);
+    auto file_path = args[0];
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        cerr << "Could not open input file: " << file_path << endl;
+        return 1;
+    }
 
     auto file_name = fs::path(file_path).filename().string();
 
-    ANTLRInputStream input(fin);
-    CoolLexer lexer(&input);
+    // Every name and string constant of the program is interned here, for
+    // both lexers alike.
+    Interner interner;
+
+    unique_ptr<StructuralIndex> index;
+    unique_ptr<TokenSource> lexer;
+    const vector<int> *token_payloads;
+    const int *last_payload;
+    // Starts a lexer at the start of the input.
+    auto start_lexer = [&](bool keep_token_payloads) {
+        input.seek(0);
+        if (use_fast_lexer) {
+            if (!index) {
+                index =
+                    make_unique<StructuralIndex>(input.data(), input.size());
+            }
+            auto fast_lexer = make_unique<CoolFastLexer>(&input, index.get());
+            fast_lexer->set_interner(&interner);
+            fast_lexer->set_keep_token_payloads(keep_token_payloads);
+            token_payloads = &fast_lexer->get_token_payloads();
+            last_payload = &fast_lexer->get_last_payload();
+            lexer = move(fast_lexer);
+        } else {
+            auto cool_lexer = make_unique<PayloadLexer>(&input);
+            cool_lexer->set_interner(&interner);
+            cool_lexer->set_keep_token_payloads(keep_token_payloads);
+            token_payloads = &cool_lexer->get_token_payloads();
+            last_payload = &cool_lexer->get_last_payload();
+            lexer = move(cool_lexer);
+        }
+    };
+
+    // PrattParser and SyntaxParser give up at the first syntax error, and
+    // leave it to CoolParser to report the errors. Their trees are made in
+    // parse_arena, and freed in one go once semantics are done with them.
+    AllocationPhases phases;
+    Arena parse_arena;
+    const ProgramSyntax *program_syntax = nullptr;
+
+    // Through a TokenWindow, lexing and parsing are one phase. If the window
+    // meets a syntax error, the input is lexed again below.
+    if (use_syntax_parser && use_token_window) {
+        phases.begin("parse");
+        start_lexer(false);
+        SyntaxParser syntax_parser(lexer.get(), *last_payload, parse_arena);
+        program_syntax = syntax_parser.parse();
+    }
+
+    unique_ptr<CommonTokenStream> tokenStream;
+    unique_ptr<CoolParser> parser;
+    CoolParser::ProgramContext *program = nullptr;
+    TwoStageStats parse_stats;
+    if (program_syntax == nullptr) {
+        phases.begin("lex");
+        start_lexer(true);
+        tokenStream = make_unique<CommonTokenStream>(lexer.get());
+        tokenStream->fill();
 
-    // Silence console error reporting.
-    // lexer.removeErrorListener(&ConsoleErrorListener::INSTANCE);
+        phases.begin("parse");
+        if (use_syntax_parser && !use_token_window) {
+            SyntaxParser syntax_parser(tokenStream.get(), *token_payloads,
+                                       parse_arena);
+            program_syntax = syntax_parser.parse();
+        }
 
-    CommonTokenStream tokenStream(&lexer);
+        if (use_pratt_parser && program_syntax == nullptr) {
+            PrattParser pratt_parser(tokenStream.get(), parse_arena);
+            program = pratt_parser.parse();
+        }
+
+        parser = make_unique<CoolParser>(tokenStream.get());
+        if (program == nullptr && program_syntax == nullptr) {
+            program = use_two_stage ? parse_two_stage(*parser, parse_stats)
+                                    : parser->program();
+        }
+    }
 
-    CoolParser parser(&tokenStream);
+    if (print_parse_stats) {
+        cerr << "Two-stage parses: " << parse_stats.parses
+             << ", LL fallbacks: " << parse_stats.ll_fallbacks << endl;
+    }
 
-    CoolSemantics semantics(&lexer, &parser);
+    phases.begin("semantics");
+    auto semantics =
+        program_syntax
+            ? CoolSemantics(interner, *token_payloads, program_syntax)
+            : CoolSemantics(interner, *token_payloads, program);
 
     auto run_result = semantics.run();
 
+    if (print_alloc_stats) {
+        cerr << "Parse arena: " << parse_arena.object_count() << " nodes, "
+             << parse_arena.bytes_used() << " bytes in "
+             << parse_arena.chunk_count() << " chunks" << endl;
+    }
+    phases.begin("teardown");
+    parse_arena.release();
+    phases.end();
+    if (print_alloc_stats) {
+        phases.report(cerr);
+    }
+
     if (!run_result.has_value()) {
         auto errors = run_result.error();
         cout << "Semantic check failed with " << errors.size()
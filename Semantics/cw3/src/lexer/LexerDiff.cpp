@@ -0,0 +1,142 @@
+#include "lexer/LexerDiff.h"
+
+#include <memory>
+
+#include "CoolLexer.h"
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+#include "lexer/CoolFastLexer.h"
+#include "lexer/PayloadLexer.h"
+#include "lexer/StructuralIndex.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+string describe(PayloadLexer &lexer, Token *token) {
+    return lexer.lexer().getVocabulary().getSymbolicName(token->getType()) +
+           " '" + token->getText() + "' at " + to_string(token->getLine()) +
+           ":" + to_string(token->getCharPositionInLine()) + " [" +
+           to_string(token->getStartIndex()) + ", " +
+           to_string(token->getStopIndex()) + "]";
+}
+
+bool same_side_data(PayloadLexer &lexer, CoolFastLexer &fast_lexer,
+                    Token *token, size_t token_index) {
+    switch (token->getType()) {
+    case CoolLexer::BOOL_CONST:
+        return lexer.get_bool_value(token_index) ==
+               fast_lexer.get_bool_value(token_index);
+    case CoolLexer::OBJECTID:
+    case CoolLexer::TYPEID:
+    case CoolLexer::STR_CONST:
+        // Both lexers share an interner, so equal text means equal symbols.
+        return lexer.get_symbol(token_index) ==
+               fast_lexer.get_symbol(token_index);
+    case CoolLexer::ERROR:
+        return lexer.get_error_code(token_index) ==
+               fast_lexer.get_error_code(token_index);
+    default:
+        return true;
+    }
+}
+
+// Reads the tokens of `kept`, which keeps its payload table, and of
+// `streamed`, a lexer of the same kind over the same source, which doesn't.
+// TokenWindow reads the payload of each token from such a lexer as it is made.
+// Returns whether the payload streamed for each token is the one in the table.
+template <typename Lexer>
+bool same_streamed_payloads(Lexer &kept, Lexer &streamed,
+                            const string &file_path, const string &lexer_name,
+                            ostream &out) {
+    streamed.set_keep_token_payloads(false);
+    for (size_t token_index = 0;; ++token_index) {
+        unique_ptr<Token> token = kept.nextToken();
+        streamed.nextToken();
+        if (streamed.get_last_payload() !=
+            kept.get_token_payloads()[token_index]) {
+            out << file_path << ": " << lexer_name
+                << " streams a different payload for token " << token_index
+                << endl;
+            return false;
+        }
+
+        if (token->getType() == Token::EOF) {
+            return true;
+        }
+    }
+}
+
+} // namespace
+
+bool diff_lexers(const string &file_path, ostream &out) {
+    // Each lexer gets its own stream, so that neither observes the position
+    // of the other.
+    MappedCharStream input(file_path);
+    MappedCharStream fast_input(file_path);
+    if (!input.is_open() || !fast_input.is_open()) {
+        out << file_path << ": could not open file" << endl;
+        return false;
+    }
+
+    PayloadLexer lexer(&input);
+    StructuralIndex index(fast_input.data(), fast_input.size());
+    CoolFastLexer fast_lexer(&fast_input, &index);
+
+    Interner interner;
+    lexer.set_interner(&interner);
+    fast_lexer.set_interner(&interner);
+
+    for (size_t token_index = 0;; ++token_index) {
+        unique_ptr<Token> expected = lexer.nextToken();
+        unique_ptr<Token> actual = fast_lexer.nextToken();
+
+        bool same_token =
+            expected->getType() == actual->getType() &&
+            expected->getChannel() == actual->getChannel() &&
+            expected->getStartIndex() == actual->getStartIndex() &&
+            expected->getStopIndex() == actual->getStopIndex() &&
+            expected->getLine() == actual->getLine() &&
+            expected->getCharPositionInLine() ==
+                actual->getCharPositionInLine() &&
+            input.get_view(*expected) == fast_input.get_view(*actual);
+
+        if (!same_token) {
+            out << file_path << ": token " << token_index << " differs"
+                << endl
+                << "  CoolLexer:     " << describe(lexer, expected.get())
+                << endl
+                << "  CoolFastLexer: " << describe(lexer, actual.get())
+                << endl;
+            return false;
+        }
+
+        if (!same_side_data(lexer, fast_lexer, expected.get(), token_index)) {
+            out << file_path << ": side data of token " << token_index
+                << " differs: " << describe(lexer, expected.get()) << endl;
+            return false;
+        }
+
+        if (expected->getType() == Token::EOF) {
+            break;
+        }
+    }
+
+    // CoolFastLexer never moves its stream, so its lexers can share one.
+    MappedCharStream kept_input(file_path);
+    MappedCharStream streamed_input(file_path);
+    PayloadLexer kept_lexer(&kept_input);
+    PayloadLexer streamed_lexer(&streamed_input);
+    CoolFastLexer kept_fast_lexer(&fast_input, &index);
+    CoolFastLexer streamed_fast_lexer(&fast_input, &index);
+    kept_lexer.set_interner(&interner);
+    streamed_lexer.set_interner(&interner);
+    kept_fast_lexer.set_interner(&interner);
+    streamed_fast_lexer.set_interner(&interner);
+
+    return same_streamed_payloads(kept_lexer, streamed_lexer, file_path,
+                                  "CoolLexer", out) &&
+           same_streamed_payloads(kept_fast_lexer, streamed_fast_lexer,
+                                  file_path, "CoolFastLexer", out);
+}
@@ -0,0 +1,86 @@
+#include "lexer/StructureScan.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "input/MappedCharStream.h"
+#include "lexer/StructuralIndex.h"
+
+using namespace std;
+
+namespace {
+
+// The index is built repeatedly over about this many bytes in total, so that
+// small files are timed too.
+constexpr size_t BENCHMARK_BYTES = size_t(256) << 20;
+constexpr size_t MAX_BENCHMARK_RUNS = 10000;
+
+string describe(StructuralIndex::ErrorKind kind) {
+    switch (kind) {
+    case StructuralIndex::ErrorKind::UNMATCHED_COMMENT_END:
+        return "Unmatched *)";
+    case StructuralIndex::ErrorKind::COMMENT_CONTAINS_EOF:
+        return "EOF in comment";
+    case StructuralIndex::ErrorKind::STR_CONTAINS_EOF:
+        return "EOF in string constant";
+    }
+    return "Unknown structural error";
+}
+
+// Returns a timestamp in cycles where a cycle counter is available and in
+// nanoseconds elsewhere.
+uint64_t timestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(
+               chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+constexpr const char *TIME_UNIT =
+#if defined(__x86_64__) || defined(__i386__)
+    "cycle";
+#else
+    "ns";
+#endif
+
+} // namespace
+
+bool scan_structure(const string &file_path, ostream &out) {
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        out << file_path << ": could not open file" << endl;
+        return false;
+    }
+
+    const char *data = input.data();
+    size_t size = input.size();
+
+    size_t runs = clamp<size_t>(BENCHMARK_BYTES / max<size_t>(size, 1), 1,
+                                MAX_BENCHMARK_RUNS);
+    uint64_t begin = timestamp();
+    for (size_t run = 1; run < runs; ++run) {
+        StructuralIndex index(data, size);
+    }
+    StructuralIndex index(data, size);
+    uint64_t elapsed = max<uint64_t>(timestamp() - begin, 1);
+
+    out << file_path << ": " << size << " bytes, " << index.class_ends().size()
+        << " classes, " << fixed << setprecision(3)
+        << double(size) * runs / elapsed << " bytes/" << TIME_UNIT << endl;
+
+    for (const auto &error : index.errors()) {
+        out << file_path << ":" << index.line_of(error.char_index) << ": "
+            << describe(error.kind) << endl;
+    }
+
+    return index.errors().empty();
+}
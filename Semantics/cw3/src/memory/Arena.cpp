@@ -0,0 +1,37 @@
+#include "memory/Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+void *Arena::allocate(size_t size, size_t alignment) {
+    size_t padding = -reinterpret_cast<uintptr_t>(free_) & (alignment - 1);
+    if (free_ == nullptr || padding + size > free_size_) {
+        // Objects larger than a chunk get a chunk of their own. new[] aligns
+        // for every fundamental type, which is as much as a node needs.
+        size_t chunk_size = max(size, CHUNK_SIZE);
+        chunks_.emplace_back(new byte[chunk_size]);
+        free_ = chunks_.back().get();
+        free_size_ = chunk_size;
+        padding = 0;
+    }
+
+    void *memory = free_ + padding;
+    free_ += padding + size;
+    free_size_ -= padding + size;
+    bytes_used_ += padding + size;
+    return memory;
+}
+
+void Arena::release() {
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+        it->destroy(it->object);
+    }
+    destructors_.clear();
+    chunks_.clear();
+    free_ = nullptr;
+    free_size_ = 0;
+    bytes_used_ = 0;
+    object_count_ = 0;
+}
@@ -0,0 +1,109 @@
+#include "parser/ParserDiff.h"
+
+#include "CoolLexer.h"
+#include "CoolParser.h"
+#include "input/MappedCharStream.h"
+#include "parser/PrattParser.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+string describe(CoolParser &parser, tree::ParseTree *node) {
+    if (auto *terminal = dynamic_cast<tree::TerminalNode *>(node)) {
+        Token *token = terminal->getSymbol();
+        return parser.getVocabulary().getSymbolicName(token->getType()) +
+               " '" + token->getText() + "' at " +
+               to_string(token->getLine()) + ":" +
+               to_string(token->getCharPositionInLine());
+    }
+
+    auto *ctx = dynamic_cast<ParserRuleContext *>(node);
+    auto token_index = [](Token *token) {
+        return token ? to_string(token->getTokenIndex()) : string("-");
+    };
+    return parser.getRuleNames()[ctx->getRuleIndex()] + " [" +
+           token_index(ctx->start) + ", " + token_index(ctx->stop) + "] with " +
+           to_string(ctx->children.size()) + " children";
+}
+
+// Compares the subtrees at `expected` and `actual`, and describes the first
+// difference on `out`. `path` names the file and the ancestors of the
+// subtrees.
+bool same_trees(CoolParser &parser, tree::ParseTree *expected,
+                tree::ParseTree *actual, const string &path, ostream &out) {
+    auto differ = [&]() {
+        out << path << ": trees differ" << endl
+            << "  CoolParser:  " << describe(parser, expected) << endl
+            << "  PrattParser: " << describe(parser, actual) << endl;
+        return false;
+    };
+
+    auto *expected_terminal = dynamic_cast<tree::TerminalNode *>(expected);
+    auto *actual_terminal = dynamic_cast<tree::TerminalNode *>(actual);
+    if (expected_terminal || actual_terminal) {
+        if (!expected_terminal || !actual_terminal ||
+            expected_terminal->getSymbol() != actual_terminal->getSymbol()) {
+            return differ();
+        }
+        return true;
+    }
+
+    auto *expected_ctx = dynamic_cast<ParserRuleContext *>(expected);
+    auto *actual_ctx = dynamic_cast<ParserRuleContext *>(actual);
+    if (expected_ctx->getRuleIndex() != actual_ctx->getRuleIndex() ||
+        expected_ctx->start != actual_ctx->start ||
+        expected_ctx->stop != actual_ctx->stop ||
+        expected_ctx->children.size() != actual_ctx->children.size()) {
+        return differ();
+    }
+
+    string child_path =
+        path + " > " + parser.getRuleNames()[actual_ctx->getRuleIndex()];
+    for (size_t i = 0; i < actual_ctx->children.size(); ++i) {
+        if (actual_ctx->children[i]->parent != actual_ctx) {
+            out << child_path << ": child " << i << " has the wrong parent"
+                << endl;
+            return false;
+        }
+        if (!same_trees(parser, expected_ctx->children[i],
+                        actual_ctx->children[i], child_path, out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool diff_parsers(const string &file_path, ostream &out) {
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        out << file_path << ": could not open file" << endl;
+        return false;
+    }
+
+    CoolLexer lexer(&input);
+    CommonTokenStream tokens(&lexer);
+
+    Arena arena;
+    PrattParser pratt_parser(&tokens, arena);
+    CoolParser::ProgramContext *actual = pratt_parser.parse();
+
+    tokens.seek(0);
+    CoolParser parser(&tokens);
+    parser.removeErrorListeners();
+    CoolParser::ProgramContext *expected = parser.program();
+
+    bool expected_valid = parser.getNumberOfSyntaxErrors() == 0;
+    if (expected_valid != (actual != nullptr)) {
+        out << file_path << ": "
+            << (expected_valid ? "only CoolParser" : "only PrattParser")
+            << " accepts the program" << endl;
+        return false;
+    }
+
+    return actual == nullptr ||
+           same_trees(parser, expected, actual, file_path, out);
+}
@@ -0,0 +1,325 @@
+#include "parser/PrattParser.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// ANTLR gives the n-th of the 20 alternatives of `expr` precedence 21 - n.
+// A prefix operator parses its operand at its own precedence, and a binary
+// operator (all of them are left associative) parses its right operand at one
+// above its own.
+constexpr int DISPATCH_PRECEDENCE = 20;
+constexpr int NEG_PRECEDENCE = 12;
+constexpr int ISVOID_PRECEDENCE = 11;
+constexpr int MULT_PRECEDENCE = 10;
+constexpr int ADD_PRECEDENCE = 9;
+constexpr int COMPARE_PRECEDENCE = 8;
+constexpr int NOT_PRECEDENCE = 7;
+constexpr int ASSIGN_PRECEDENCE = 6;
+constexpr int LET_PRECEDENCE = 5;
+
+// Returns the precedence of the operator or member invocation that `type`
+// starts, or -1 if it does not continue an expression.
+int infix_precedence(size_t type) {
+    switch (type) {
+    case CoolParser::AT:
+    case CoolParser::DOT:
+        return DISPATCH_PRECEDENCE;
+    case CoolParser::STAR:
+    case CoolParser::SLASH:
+        return MULT_PRECEDENCE;
+    case CoolParser::PLUS:
+    case CoolParser::MINUS:
+        return ADD_PRECEDENCE;
+    case CoolParser::LT:
+    case CoolParser::EQ:
+    case CoolParser::LE:
+        return COMPARE_PRECEDENCE;
+    default:
+        return -1;
+    }
+}
+
+} // namespace
+
+PrattParser::PrattParser(BufferedTokenStream *tokens, Arena &arena)
+    : arena_(arena) {
+    tokens->fill();
+    for (Token *token : tokens->getTokens()) {
+        if (token->getChannel() == Token::DEFAULT_CHANNEL) {
+            tokens_.push_back(token);
+        }
+    }
+}
+
+CoolParser::ProgramContext *PrattParser::parse() {
+    next_ = 0;
+    try {
+        return program();
+    } catch (const SyntaxError &) {
+        return nullptr;
+    }
+}
+
+size_t PrattParser::la(size_t k) const {
+    // The last token is EOF, which is never consumed.
+    return tokens_[min(next_ + k, tokens_.size() - 1)]->getType();
+}
+
+template <typename Context>
+Context *PrattParser::make_context(ParserRuleContext *parent) {
+    auto *ctx =
+        arena_.make<Context>(parent, atn::ATNState::INVALID_STATE_NUMBER);
+    ctx->start = tokens_[min(next_, tokens_.size() - 1)];
+    return ctx;
+}
+
+void PrattParser::match(ParserRuleContext *ctx, size_t type) {
+    if (la() != type || type == Token::EOF) {
+        throw SyntaxError();
+    }
+    ctx->addChild(arena_.make<tree::TerminalNodeImpl>(tokens_[next_++]));
+}
+
+void PrattParser::finish(ParserRuleContext *ctx) {
+    if (next_ > 0) {
+        ctx->stop = tokens_[next_ - 1];
+    }
+}
+
+CoolParser::ProgramContext *PrattParser::program() {
+    auto *ctx = make_context<CoolParser::ProgramContext>(nullptr);
+    // Like CoolParser, stops at the first token that can't start a class,
+    // and leaves the rest of the input alone.
+    do {
+        class_(ctx);
+        match(ctx, CoolParser::SEMI);
+    } while (la() == CoolParser::CLASS);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::ClassContext *PrattParser::class_(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::ClassContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::CLASS);
+    match(ctx, CoolParser::TYPEID);
+    if (la() == CoolParser::INHERITS) {
+        match(ctx, CoolParser::INHERITS);
+        match(ctx, CoolParser::TYPEID);
+    }
+    match(ctx, CoolParser::OCURLY);
+    while (la() == CoolParser::OBJECTID) {
+        if (la(1) == CoolParser::OPAREN) {
+            method(ctx);
+        } else {
+            attr(ctx);
+        }
+        match(ctx, CoolParser::SEMI);
+    }
+    match(ctx, CoolParser::CCURLY);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::MethodContext *PrattParser::method(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::MethodContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::OPAREN);
+    if (la() != CoolParser::CPAREN) {
+        formal(ctx);
+        while (la() == CoolParser::COMMA) {
+            match(ctx, CoolParser::COMMA);
+            formal(ctx);
+        }
+    }
+    match(ctx, CoolParser::CPAREN);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    match(ctx, CoolParser::OCURLY);
+    expr(ctx);
+    match(ctx, CoolParser::CCURLY);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::AttrContext *PrattParser::attr(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::AttrContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    if (la() == CoolParser::ASSIGN) {
+        match(ctx, CoolParser::ASSIGN);
+        expr(ctx);
+    }
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::FormalContext *PrattParser::formal(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::FormalContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::VardeclContext *PrattParser::vardecl(ParserRuleContext *parent) {
+    auto *ctx = make_context<CoolParser::VardeclContext>(parent);
+    parent->addChild(ctx);
+    match(ctx, CoolParser::OBJECTID);
+    match(ctx, CoolParser::COLON);
+    match(ctx, CoolParser::TYPEID);
+    if (la() == CoolParser::ASSIGN) {
+        match(ctx, CoolParser::ASSIGN);
+        expr(ctx);
+    }
+    finish(ctx);
+    return ctx;
+}
+
+CoolParser::ExprContext *PrattParser::expr(ParserRuleContext *parent,
+                                           int precedence) {
+    auto *ctx = make_context<CoolParser::ExprContext>(parent);
+    primary(ctx);
+    finish(ctx);
+
+    // Each operator wraps the expression parsed so far into a new context, as
+    // the left-recursive alternatives of CoolParser do.
+    for (int op_precedence = infix_precedence(la());
+         op_precedence >= precedence;
+         op_precedence = infix_precedence(la())) {
+        auto *left = ctx;
+        ctx = make_context<CoolParser::ExprContext>(parent);
+        ctx->start = left->start;
+        left->parent = ctx;
+        ctx->addChild(left);
+
+        if (op_precedence == DISPATCH_PRECEDENCE) {
+            if (la() == CoolParser::AT) {
+                match(ctx, CoolParser::AT);
+                match(ctx, CoolParser::TYPEID);
+            }
+            match(ctx, CoolParser::DOT);
+            match(ctx, CoolParser::OBJECTID);
+            arguments(ctx);
+        } else {
+            match(ctx, la());
+            expr(ctx, op_precedence + 1);
+        }
+        finish(ctx);
+    }
+
+    parent->addChild(ctx);
+    return ctx;
+}
+
+void PrattParser::primary(CoolParser::ExprContext *ctx) {
+    switch (la()) {
+    case CoolParser::OBJECTID:
+        if (la(1) == CoolParser::OPAREN) {
+            match(ctx, CoolParser::OBJECTID);
+            arguments(ctx);
+        } else if (la(1) == CoolParser::ASSIGN) {
+            match(ctx, CoolParser::OBJECTID);
+            match(ctx, CoolParser::ASSIGN);
+            expr(ctx, ASSIGN_PRECEDENCE);
+        } else {
+            match(ctx, CoolParser::OBJECTID);
+        }
+        break;
+    case CoolParser::INT_CONST:
+    case CoolParser::STR_CONST:
+    case CoolParser::BOOL_CONST:
+        match(ctx, la());
+        break;
+    case CoolParser::IF:
+        match(ctx, CoolParser::IF);
+        expr(ctx);
+        match(ctx, CoolParser::THEN);
+        expr(ctx);
+        match(ctx, CoolParser::ELSE);
+        expr(ctx);
+        match(ctx, CoolParser::FI);
+        break;
+    case CoolParser::WHILE:
+        match(ctx, CoolParser::WHILE);
+        expr(ctx);
+        match(ctx, CoolParser::LOOP);
+        expr(ctx);
+        match(ctx, CoolParser::POOL);
+        break;
+    case CoolParser::OCURLY:
+        match(ctx, CoolParser::OCURLY);
+        do {
+            expr(ctx);
+            match(ctx, CoolParser::SEMI);
+        } while (la() != CoolParser::CCURLY);
+        match(ctx, CoolParser::CCURLY);
+        break;
+    case CoolParser::CASE:
+        match(ctx, CoolParser::CASE);
+        expr(ctx);
+        match(ctx, CoolParser::OF);
+        do {
+            match(ctx, CoolParser::OBJECTID);
+            match(ctx, CoolParser::COLON);
+            match(ctx, CoolParser::TYPEID);
+            match(ctx, CoolParser::DARROW);
+            expr(ctx);
+            match(ctx, CoolParser::SEMI);
+        } while (la() == CoolParser::OBJECTID);
+        match(ctx, CoolParser::ESAC);
+        break;
+    case CoolParser::NEW:
+        match(ctx, CoolParser::NEW);
+        match(ctx, CoolParser::TYPEID);
+        break;
+    case CoolParser::OPAREN:
+        match(ctx, CoolParser::OPAREN);
+        expr(ctx);
+        match(ctx, CoolParser::CPAREN);
+        break;
+    case CoolParser::TILDE:
+        match(ctx, CoolParser::TILDE);
+        expr(ctx, NEG_PRECEDENCE);
+        break;
+    case CoolParser::ISVOID:
+        match(ctx, CoolParser::ISVOID);
+        expr(ctx, ISVOID_PRECEDENCE);
+        break;
+    case CoolParser::NOT:
+        match(ctx, CoolParser::NOT);
+        expr(ctx, NOT_PRECEDENCE);
+        break;
+    case CoolParser::LET:
+        match(ctx, CoolParser::LET);
+        vardecl(ctx);
+        while (la() == CoolParser::COMMA) {
+            match(ctx, CoolParser::COMMA);
+            vardecl(ctx);
+        }
+        match(ctx, CoolParser::IN);
+        expr(ctx, LET_PRECEDENCE);
+        break;
+    default:
+        throw SyntaxError();
+    }
+}
+
+void PrattParser::arguments(CoolParser::ExprContext *ctx) {
+    match(ctx, CoolParser::OPAREN);
+    if (la() != CoolParser::CPAREN) {
+        expr(ctx);
+        while (la() == CoolParser::COMMA) {
+            match(ctx, CoolParser::COMMA);
+            expr(ctx);
+        }
+    }
+    match(ctx, CoolParser::CPAREN);
+}
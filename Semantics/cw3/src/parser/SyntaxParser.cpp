@@ -0,0 +1,375 @@
+#include "parser/SyntaxParser.h"
+
+#include <string>
+
+#include "CoolParser.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// The precedences of PrattParser, which follow the ones that ANTLR assigns to
+// the alternatives of `expr`.
+constexpr int DISPATCH_PRECEDENCE = 20;
+constexpr int NEG_PRECEDENCE = 12;
+constexpr int ISVOID_PRECEDENCE = 11;
+constexpr int MULT_PRECEDENCE = 10;
+constexpr int ADD_PRECEDENCE = 9;
+constexpr int COMPARE_PRECEDENCE = 8;
+constexpr int NOT_PRECEDENCE = 7;
+constexpr int ASSIGN_PRECEDENCE = 6;
+constexpr int LET_PRECEDENCE = 5;
+
+// Returns the precedence of the operator or member invocation that `type`
+// starts, or -1 if it does not continue an expression.
+int infix_precedence(size_t type) {
+    switch (type) {
+    case CoolParser::AT:
+    case CoolParser::DOT:
+        return DISPATCH_PRECEDENCE;
+    case CoolParser::STAR:
+    case CoolParser::SLASH:
+        return MULT_PRECEDENCE;
+    case CoolParser::PLUS:
+    case CoolParser::MINUS:
+        return ADD_PRECEDENCE;
+    case CoolParser::LT:
+    case CoolParser::EQ:
+    case CoolParser::LE:
+        return COMPARE_PRECEDENCE;
+    default:
+        return -1;
+    }
+}
+
+ExprSyntax::Kind binary_kind(size_t type) {
+    switch (type) {
+    case CoolParser::STAR:
+        return ExprSyntax::Kind::Multiplication;
+    case CoolParser::SLASH:
+        return ExprSyntax::Kind::Division;
+    case CoolParser::PLUS:
+        return ExprSyntax::Kind::Addition;
+    case CoolParser::MINUS:
+        return ExprSyntax::Kind::Subtraction;
+    case CoolParser::LT:
+        return ExprSyntax::Kind::LessThan;
+    case CoolParser::LE:
+        return ExprSyntax::Kind::LessThanEqual;
+    default:
+        return ExprSyntax::Kind::Equal;
+    }
+}
+
+} // namespace
+
+SyntaxParser::SyntaxParser(BufferedTokenStream *tokens,
+                           const vector<int> &token_payloads, Arena &arena)
+    : window_(tokens, token_payloads), arena_(arena) {}
+
+SyntaxParser::SyntaxParser(TokenSource *lexer, const int &last_payload,
+                           Arena &arena)
+    : window_(lexer, last_payload), arena_(arena) {}
+
+const ProgramSyntax *SyntaxParser::parse() {
+    try {
+        return program();
+    } catch (const SyntaxError &) {
+        operands_.clear();
+        vardecls_.clear();
+        branches_.clear();
+        formals_.clear();
+        attributes_.clear();
+        methods_.clear();
+        classes_.clear();
+        return nullptr;
+    }
+}
+
+size_t SyntaxParser::la(size_t k) { return window_.peek(k).type; }
+
+int SyntaxParser::line() { return window_.peek().line; }
+
+WindowToken SyntaxParser::match(size_t type) {
+    // EOF is never consumed.
+    if (la() != type || type == Token::EOF) {
+        throw SyntaxError();
+    }
+    return window_.consume();
+}
+
+Symbol SyntaxParser::match_symbol(size_t type) { return match(type).payload; }
+
+template <typename T>
+span<T> SyntaxParser::take(vector<T> &stack, size_t start) {
+    span<T> items = arena_.copy(span<const T>(stack).subspan(start));
+    stack.erase(stack.begin() + start, stack.end());
+    return items;
+}
+
+ExprSyntax *SyntaxParser::make_expr(ExprSyntax::Kind kind, int line) {
+    return arena_.make<ExprSyntax>(kind, line);
+}
+
+const ProgramSyntax *SyntaxParser::program() {
+    // Like CoolParser, stops at the first token that can't start a class,
+    // and leaves the rest of the input alone.
+    size_t start = classes_.size();
+    do {
+        class_();
+        match(CoolParser::SEMI);
+    } while (la() == CoolParser::CLASS);
+    return arena_.make<ProgramSyntax>(take(classes_, start));
+}
+
+void SyntaxParser::class_() {
+    int class_line = line();
+    match(CoolParser::CLASS);
+    Symbol name = match_symbol(CoolParser::TYPEID);
+    Symbol parent = Interner::OBJECT;
+    if (la() == CoolParser::INHERITS) {
+        match(CoolParser::INHERITS);
+        parent = match_symbol(CoolParser::TYPEID);
+    }
+
+    size_t attributes_start = attributes_.size();
+    size_t methods_start = methods_.size();
+    match(CoolParser::OCURLY);
+    while (la() == CoolParser::OBJECTID) {
+        if (la(1) == CoolParser::OPAREN) {
+            method();
+        } else {
+            attr();
+        }
+        match(CoolParser::SEMI);
+    }
+    match(CoolParser::CCURLY);
+
+    classes_.push_back({name, parent, class_line,
+                        take(attributes_, attributes_start),
+                        take(methods_, methods_start)});
+}
+
+void SyntaxParser::method() {
+    Symbol name = match_symbol(CoolParser::OBJECTID);
+    size_t formals_start = formals_.size();
+    match(CoolParser::OPAREN);
+    if (la() != CoolParser::CPAREN) {
+        formal();
+        while (la() == CoolParser::COMMA) {
+            match(CoolParser::COMMA);
+            formal();
+        }
+    }
+    match(CoolParser::CPAREN);
+    match(CoolParser::COLON);
+    Symbol return_type = match_symbol(CoolParser::TYPEID);
+    match(CoolParser::OCURLY);
+    ExprSyntax *body = expr();
+    match(CoolParser::CCURLY);
+
+    methods_.push_back(
+        {name, take(formals_, formals_start), return_type, body});
+}
+
+void SyntaxParser::attr() {
+    Symbol name = match_symbol(CoolParser::OBJECTID);
+    match(CoolParser::COLON);
+    Symbol type = match_symbol(CoolParser::TYPEID);
+    ExprSyntax *initializer = nullptr;
+    if (la() == CoolParser::ASSIGN) {
+        match(CoolParser::ASSIGN);
+        initializer = expr();
+    }
+    attributes_.push_back({name, type, initializer});
+}
+
+void SyntaxParser::formal() {
+    Symbol name = match_symbol(CoolParser::OBJECTID);
+    match(CoolParser::COLON);
+    Symbol type = match_symbol(CoolParser::TYPEID);
+    formals_.push_back({name, type});
+}
+
+void SyntaxParser::vardecl() {
+    Symbol name = match_symbol(CoolParser::OBJECTID);
+    match(CoolParser::COLON);
+    Symbol type = match_symbol(CoolParser::TYPEID);
+    ExprSyntax *initializer = nullptr;
+    if (la() == CoolParser::ASSIGN) {
+        match(CoolParser::ASSIGN);
+        initializer = expr();
+    }
+    vardecls_.push_back({name, type, initializer});
+}
+
+ExprSyntax *SyntaxParser::expr(int precedence) {
+    ExprSyntax *left = primary();
+
+    // Each operator wraps the expression parsed so far into a new node, as
+    // the left-recursive alternatives of CoolParser do.
+    for (int op_precedence = infix_precedence(la());
+         op_precedence >= precedence;
+         op_precedence = infix_precedence(la())) {
+        size_t operands_start = operands_.size();
+        operands_.push_back(left);
+
+        ExprSyntax *node;
+        if (op_precedence == DISPATCH_PRECEDENCE) {
+            node = make_expr(ExprSyntax::Kind::DynamicDispatch, left->line);
+            if (la() == CoolParser::AT) {
+                match(CoolParser::AT);
+                node->kind = ExprSyntax::Kind::StaticDispatch;
+                node->type = match_symbol(CoolParser::TYPEID);
+            }
+            match(CoolParser::DOT);
+            node->name = match_symbol(CoolParser::OBJECTID);
+            arguments();
+        } else {
+            node = make_expr(binary_kind(la()), left->line);
+            match(la());
+            operands_.push_back(expr(op_precedence + 1));
+        }
+        node->operands = take(operands_, operands_start);
+        left = node;
+    }
+
+    return left;
+}
+
+ExprSyntax *SyntaxParser::primary() {
+    ExprSyntax *node;
+    size_t operands_start = operands_.size();
+    switch (la()) {
+    case CoolParser::OBJECTID:
+        if (la(1) == CoolParser::OPAREN) {
+            node = make_expr(ExprSyntax::Kind::SelfDispatch, line());
+            node->name = match_symbol(CoolParser::OBJECTID);
+            arguments();
+        } else if (la(1) == CoolParser::ASSIGN) {
+            node = make_expr(ExprSyntax::Kind::Assignment, line());
+            node->name = match_symbol(CoolParser::OBJECTID);
+            match(CoolParser::ASSIGN);
+            operands_.push_back(expr(ASSIGN_PRECEDENCE));
+        } else {
+            node = make_expr(ExprSyntax::Kind::Object, line());
+            node->name = match_symbol(CoolParser::OBJECTID);
+        }
+        break;
+    case CoolParser::INT_CONST:
+        node = make_expr(ExprSyntax::Kind::IntConstant, line());
+        node->value = match(CoolParser::INT_CONST).payload;
+        break;
+    case CoolParser::STR_CONST:
+        node = make_expr(ExprSyntax::Kind::StringConstant, line());
+        node->name = match_symbol(CoolParser::STR_CONST);
+        break;
+    case CoolParser::BOOL_CONST:
+        node = make_expr(ExprSyntax::Kind::BoolConstant, line());
+        node->value = match(CoolParser::BOOL_CONST).payload;
+        break;
+    case CoolParser::IF:
+        node = make_expr(ExprSyntax::Kind::IfThenElseFi, line());
+        match(CoolParser::IF);
+        operands_.push_back(expr());
+        match(CoolParser::THEN);
+        operands_.push_back(expr());
+        match(CoolParser::ELSE);
+        operands_.push_back(expr());
+        match(CoolParser::FI);
+        break;
+    case CoolParser::WHILE:
+        node = make_expr(ExprSyntax::Kind::WhileLoopPool, line());
+        match(CoolParser::WHILE);
+        operands_.push_back(expr());
+        match(CoolParser::LOOP);
+        operands_.push_back(expr());
+        match(CoolParser::POOL);
+        break;
+    case CoolParser::OCURLY:
+        node = make_expr(ExprSyntax::Kind::Sequence, line());
+        match(CoolParser::OCURLY);
+        do {
+            operands_.push_back(expr());
+            match(CoolParser::SEMI);
+        } while (la() != CoolParser::CCURLY);
+        match(CoolParser::CCURLY);
+        break;
+    case CoolParser::CASE: {
+        node = make_expr(ExprSyntax::Kind::CaseOfEsac, line());
+        match(CoolParser::CASE);
+        operands_.push_back(expr());
+        match(CoolParser::OF);
+        size_t branches_start = branches_.size();
+        do {
+            Symbol name = match_symbol(CoolParser::OBJECTID);
+            match(CoolParser::COLON);
+            Symbol type = match_symbol(CoolParser::TYPEID);
+            match(CoolParser::DARROW);
+            ExprSyntax *body = expr();
+            match(CoolParser::SEMI);
+            branches_.push_back({name, type, body});
+        } while (la() == CoolParser::OBJECTID);
+        match(CoolParser::ESAC);
+        node->branches = take(branches_, branches_start);
+        break;
+    }
+    case CoolParser::NEW:
+        node = make_expr(ExprSyntax::Kind::NewObject, line());
+        match(CoolParser::NEW);
+        node->type = match_symbol(CoolParser::TYPEID);
+        break;
+    case CoolParser::OPAREN:
+        node = make_expr(ExprSyntax::Kind::Parenthesized, line());
+        match(CoolParser::OPAREN);
+        operands_.push_back(expr());
+        match(CoolParser::CPAREN);
+        break;
+    case CoolParser::TILDE:
+        node = make_expr(ExprSyntax::Kind::IntegerNegation, line());
+        match(CoolParser::TILDE);
+        operands_.push_back(expr(NEG_PRECEDENCE));
+        break;
+    case CoolParser::ISVOID:
+        node = make_expr(ExprSyntax::Kind::IsVoid, line());
+        match(CoolParser::ISVOID);
+        operands_.push_back(expr(ISVOID_PRECEDENCE));
+        break;
+    case CoolParser::NOT:
+        node = make_expr(ExprSyntax::Kind::BooleanNegation, line());
+        match(CoolParser::NOT);
+        operands_.push_back(expr(NOT_PRECEDENCE));
+        break;
+    case CoolParser::LET: {
+        node = make_expr(ExprSyntax::Kind::LetIn, line());
+        match(CoolParser::LET);
+        size_t vardecls_start = vardecls_.size();
+        vardecl();
+        while (la() == CoolParser::COMMA) {
+            match(CoolParser::COMMA);
+            vardecl();
+        }
+        match(CoolParser::IN);
+        node->vardecls = take(vardecls_, vardecls_start);
+        operands_.push_back(expr(LET_PRECEDENCE));
+        break;
+    }
+    default:
+        throw SyntaxError();
+    }
+    node->operands = take(operands_, operands_start);
+    return node;
+}
+
+void SyntaxParser::arguments() {
+    match(CoolParser::OPAREN);
+    if (la() != CoolParser::CPAREN) {
+        operands_.push_back(expr());
+        while (la() == CoolParser::COMMA) {
+            match(CoolParser::COMMA);
+            operands_.push_back(expr());
+        }
+    }
+    match(CoolParser::CPAREN);
+}
@@ -0,0 +1,72 @@
+#include "parser/TokenWindow.h"
+
+#include <cassert>
+#include <string>
+
+#include "CoolParser.h"
+
+using namespace std;
+using namespace antlr4;
+
+TokenWindow::TokenWindow(TokenSource *lexer, const int &last_payload)
+    : lexer_(lexer), last_payload_(&last_payload) {}
+
+TokenWindow::TokenWindow(BufferedTokenStream *tokens,
+                         const vector<int> &token_payloads)
+    : tokens_(tokens), token_payloads_(&token_payloads) {
+    tokens_->fill();
+}
+
+WindowToken TokenWindow::read() {
+    if (at_eof_) {
+        return eof_;
+    }
+
+    // The token is only owned when it comes from the lexer, and is freed on
+    // return.
+    unique_ptr<Token> owned;
+    Token *token;
+    int payload;
+    do {
+        if (lexer_ != nullptr) {
+            owned = lexer_->nextToken();
+            token = owned.get();
+            payload = *last_payload_;
+        } else {
+            token = tokens_->get(next_token_++);
+            payload = (*token_payloads_)[token->getTokenIndex()];
+        }
+    } while (token->getChannel() != Token::DEFAULT_CHANNEL);
+
+    switch (token->getType()) {
+    case CoolParser::INT_CONST:
+        payload = stoi(token->getText());
+        break;
+    case CoolParser::BOOL_CONST:
+        payload = token->getText() == "true";
+        break;
+    }
+
+    WindowToken window_token{token->getType(),
+                             static_cast<int>(token->getLine()), payload};
+    if (window_token.type == Token::EOF) {
+        at_eof_ = true;
+        eof_ = window_token;
+    }
+    return window_token;
+}
+
+const WindowToken &TokenWindow::peek(size_t k) {
+    assert(k < CAPACITY);
+    while (read_ - consumed_ <= k) {
+        ring_[read_++ % CAPACITY] = read();
+    }
+    max_lookahead_ = max(max_lookahead_, k + 1);
+    return ring_[(consumed_ + k) % CAPACITY];
+}
+
+WindowToken TokenWindow::consume() {
+    WindowToken token = peek();
+    ++consumed_;
+    return token;
+}
@@ -0,0 +1,132 @@
+#include "parser/TokenWindowBench.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "antlr4-runtime.h"
+
+#include "CoolLexer.h"
+#include "CoolParser.h"
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+#include "lexer/PayloadLexer.h"
+#include "memory/AllocationStats.h"
+#include "memory/Arena.h"
+#include "parser/SyntaxParser.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+// What a parse through SyntaxParser kept live at most, beyond what was live
+// before it.
+struct PeakMemory {
+    size_t peak_bytes = 0;
+    size_t arena_bytes = 0;
+    // Zero if the parse failed.
+    size_t classes = 0;
+};
+
+// Runs `parse` with a fresh lexer on `input`, and measures the bytes live at
+// its peak. The lexer is destroyed before `parse` returns, so everything the
+// parse needed is counted.
+template <typename Parse>
+PeakMemory measure_parse(MappedCharStream &input, Parse parse) {
+    PeakMemory memory;
+    size_t bytes_before = allocation_counts().bytes_live;
+    reset_peak_bytes_live();
+    {
+        input.seek(0);
+        Interner interner;
+        Arena arena;
+        PayloadLexer lexer(&input);
+        lexer.set_interner(&interner);
+        const ProgramSyntax *program = parse(lexer, arena);
+        memory.classes = program ? program->classes.size() : 0;
+        memory.arena_bytes = arena.bytes_used();
+    }
+    memory.peak_bytes = allocation_counts().peak_bytes_live - bytes_before;
+    return memory;
+}
+
+} // namespace
+
+bool bench_token_window(const string &file_path, ostream &out) {
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        out << file_path << ": could not open file" << endl;
+        return false;
+    }
+
+    out << file_path << ":" << endl;
+
+    // ANTLR counts the lookahead of each decision when the parser profiles.
+    // The deepest SLL or LL prediction is the window that CoolParser would
+    // need.
+    size_t token_count;
+    {
+        CoolLexer lexer(&input);
+        CommonTokenStream tokens(&lexer);
+        CoolParser parser(&tokens);
+        parser.removeErrorListeners();
+        parser.setProfile(true);
+        parser.program();
+        if (parser.getNumberOfSyntaxErrors() > 0) {
+            out << "  syntax error, not measured" << endl;
+            return false;
+        }
+        token_count = tokens.size();
+
+        const auto &decisions =
+            parser.getInterpreter<atn::ProfilingATNSimulator>()
+                ->getDecisionInfo();
+        long long max_look = 0;
+        size_t max_decision = 0;
+        for (size_t i = 0; i < decisions.size(); ++i) {
+            long long look =
+                max(decisions[i].SLL_MaxLook, decisions[i].LL_MaxLook);
+            if (look > max_look) {
+                max_look = look;
+                max_decision = i;
+            }
+        }
+        size_t rule = parser.getATN().getDecisionState(max_decision)->ruleIndex;
+        out << "  CoolParser looks ahead at most " << max_look
+            << " tokens, in decision " << max_decision << " of rule "
+            << parser.getRuleNames()[rule] << endl;
+    }
+
+    size_t max_lookahead = 0;
+    PeakMemory buffered =
+        measure_parse(input, [&](PayloadLexer &lexer, Arena &arena) {
+            CommonTokenStream tokens(&lexer);
+            SyntaxParser parser(&tokens, lexer.get_token_payloads(), arena);
+            return parser.parse();
+        });
+    PeakMemory windowed =
+        measure_parse(input, [&](PayloadLexer &lexer, Arena &arena) {
+            lexer.set_keep_token_payloads(false);
+            SyntaxParser parser(&lexer, lexer.get_last_payload(), arena);
+            const ProgramSyntax *program = parser.parse();
+            max_lookahead = parser.window().max_lookahead();
+            return program;
+        });
+
+    out << "  SyntaxParser looks ahead at most " << max_lookahead
+        << " tokens" << endl
+        << "  " << token_count << " tokens, AST of " << windowed.arena_bytes
+        << " bytes" << endl
+        << "  Peak heap, CommonTokenStream: " << setw(12) << buffered.peak_bytes
+        << " bytes" << endl
+        << "  Peak heap, TokenWindow:       " << setw(12) << windowed.peak_bytes
+        << " bytes (" << fixed << setprecision(1)
+        << 100.0 * windowed.peak_bytes / max<size_t>(buffered.peak_bytes, 1)
+        << "%)" << endl;
+
+    if (buffered.classes == 0 || buffered.classes != windowed.classes) {
+        out << "  parses differ" << endl;
+        return false;
+    }
+    return true;
+}
@@ -2,11 +2,14 @@
 
 #include <expected>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <set>
 #include <algorithm>
 #include <sstream>
 
+#include "passes/TypeAnnotator.h"
 #include "passes/TypeChecker.h"
 
 using namespace std;
@@ -16,97 +19,131 @@ string print_inheritance_loops_error(vector<vector<string>> inheritance_loops);
 expected<TypedProgram, vector<string>> CoolSemantics::run() {
     vector<string> errors;
 
-    // collect classes
-    classes_.clear();
-    vector<string> processing_order;
+    // collect classes, in the order they are declared, with the names of
+    // their parents
+    vector<ClassInfo> declared;
+    vector<Symbol> parent_names;
+    set<Symbol> defined;
     bool fatal_error = false;
 
     // Add basic classes
-    classes_["Object"] = {"Object", "", {}, {}, nullptr, 0};
-    processing_order.push_back("Object");
-    classes_["IO"] = {"IO", "Object", {}, {}, nullptr};
-    processing_order.push_back("IO");
-    classes_["Int"] = {"Int", "Object", {}, {}, nullptr};
-    processing_order.push_back("Int");
-    classes_["String"] = {"String", "Object", {}, {}, nullptr};
-    processing_order.push_back("String");
-    classes_["Bool"] = {"Bool", "Object", {}, {}, nullptr};
-    processing_order.push_back("Bool");
-
-    auto program = parser_->program();
-    for (auto class_ctx : program->class_()) {
-        string name = class_ctx->TYPEID(0)->getText();
-        string parent = "Object";
-        if (class_ctx->INHERITS()) {
-            parent = class_ctx->TYPEID(1)->getText();
-        }
+    for (Symbol name : {Interner::OBJECT, Interner::IO, Interner::INT,
+                        Interner::STRING, Interner::BOOL}) {
+        declared.push_back({name, NO_TYPE, {}, {}, nullptr});
+        parent_names.push_back(Interner::OBJECT);
+        defined.insert(name);
+    }
 
-        if (classes_.contains(name)) {
-            errors.push_back("Type `" + name + "` already defined");
+    // Exactly one of class_ctx and class_syntax is set, depending on which
+    // parser the program comes from.
+    auto add_class = [&](Symbol name, Symbol parent,
+                         CoolParser::ClassContext *class_ctx,
+                         const ClassSyntax *class_syntax) {
+        if (defined.contains(name)) {
+            errors.push_back("Type `" + symbols_.str(name) + "` already defined");
             fatal_error = true;
-            continue;
+            return;
         }
         
-        if (name == "SELF_TYPE") {
+        if (name == Interner::SELF_TYPE) {
              errors.push_back("Redefinition of basic class SELF_TYPE.");
              fatal_error = true;
-             continue;
+             return;
+        }
+
+        defined.insert(name);
+        declared.push_back({name, NO_TYPE, {}, {}, class_ctx, -1, -1, class_syntax});
+        parent_names.push_back(parent);
+    };
+
+    if (program_syntax_) {
+        for (const auto &class_syntax : program_syntax_->classes) {
+            add_class(class_syntax.name, class_syntax.parent, nullptr,
+                      &class_syntax);
+        }
+    } else {
+        for (auto class_ctx : program_->class_()) {
+            Symbol name = symbols_.symbol(class_ctx->TYPEID(0));
+            Symbol parent = Interner::OBJECT;
+            if (class_ctx->INHERITS()) {
+                parent = symbols_.symbol(class_ctx->TYPEID(1));
+            }
+            add_class(name, parent, class_ctx, nullptr);
         }
+    }
 
-        classes_[name] = {name, parent, {}, {}, class_ctx};
-        processing_order.push_back(name);
+    // Assign type indices, in the order of the names for now, so that the
+    // numbering does not depend on the order the classes are declared in.
+    // processing_order holds the type indices in the order of declaration.
+    vector<size_t> by_name(declared.size());
+    for (size_t i = 0; i < by_name.size(); ++i) by_name[i] = i;
+    sort(by_name.begin(), by_name.end(), [&](size_t a, size_t b) {
+        return symbols_.name(declared[a].name) <
+               symbols_.name(declared[b].name);
+    });
+    vector<ClassInfo> classes;
+    vector<int> processing_order(declared.size());
+    for (size_t i = 0; i < by_name.size(); ++i) {
+        processing_order[by_name[i]] = static_cast<int>(i);
+        classes.push_back(move(declared[by_name[i]]));
     }
+    types_ = TypeTable(move(classes));
+    int object_type = types_.index(Interner::OBJECT);
 
     // build inheritance graph
     // Check for undefined parents and inheritance from basic classes
-    for (const auto& name : processing_order) {
-        if (name == "Object") continue;
-        auto& info = classes_[name];
-
-        if (!classes_.contains(info.parent)) {
-            errors.push_back(name + " inherits from undefined class " + info.parent);
+    for (size_t i = 0; i < processing_order.size(); ++i) {
+        int type = processing_order[i];
+        if (type == object_type) continue;
+        auto& info = types_.at(type);
+        Symbol parent_name = parent_names[i];
+
+        int parent = types_.index(parent_name);
+        if (!types_.is_class(parent)) {
+            errors.push_back(symbols_.str(info.name) + " inherits from undefined class " + symbols_.str(parent_name));
             fatal_error = true;
             continue;
         }
+        info.parent = parent;
 
-        if (info.parent == "Int" || info.parent == "String" || info.parent == "Bool" || info.parent == "SELF_TYPE") {
-            errors.push_back("`" + name + "` inherits from `" + info.parent + "` which is an error");
+        if (parent_name == Interner::INT || parent_name == Interner::STRING || parent_name == Interner::BOOL) {
+            errors.push_back("`" + symbols_.str(info.name) + "` inherits from `" + symbols_.str(parent_name) + "` which is an error");
             fatal_error = true;
         }
     }
 
     // check inheritance graph is a tree
     vector<vector<string>> inheritance_loops;
-    set<string> checked;
+    vector<bool> checked(types_.class_count());
     
-    for (const auto& name : processing_order) {
-        if (checked.contains(name)) continue;
+    for (int type : processing_order) {
+        if (checked[type]) continue;
         
-        vector<string> path;
-        string curr = name;
-        while (curr != "Object" && classes_.contains(curr)) {
+        vector<int> path;
+        int curr = type;
+        while (curr != object_type && curr != NO_TYPE) {
             // Check if curr is already in path
             auto it = find(path.begin(), path.end(), curr);
             if (it != path.end()) {
                 // Cycle detected
                 vector<string> loop;
                 for (auto k = it; k != path.end(); ++k) {
-                    loop.push_back(*k);
+                    loop.push_back(symbols_.str(types_.name(*k)));
                 }
                 inheritance_loops.push_back(loop);
                 break;
             }
             
-            if (checked.contains(curr)) {
+            if (checked[curr]) {
                 break;
             }
             
             path.push_back(curr);
-            curr = classes_[curr].parent;
+            curr = types_.at(curr).parent;
         }
         
-        for (const auto& p : path) {
-            checked.insert(p);
+        for (int p : path) {
+            checked[p] = true;
         }
     }
 
@@ -119,146 +156,154 @@ expected<TypedProgram, vector<string>> CoolSemantics::run() {
         return unexpected(errors);
     }
 
+    // The hierarchy is a tree, so the classes can be numbered depth-first
+    vector<int> new_index = types_.number_depth_first();
+    for (int &type : processing_order) {
+        type = new_index[type];
+    }
+    object_type = types_.index(Interner::OBJECT);
+
     // collect features
     // Add built-in methods
     // Object
-    classes_["Object"].methods["abort"] = {"Object", {}, nullptr};
-    classes_["Object"].methods["type_name"] = {"String", {}, nullptr};
-    classes_["Object"].methods["copy"] = {"SELF_TYPE", {}, nullptr};
+    auto &object_methods = types_.at(object_type).methods;
+    object_methods["abort"] = {Interner::OBJECT, {}, nullptr};
+    object_methods["type_name"] = {Interner::STRING, {}, nullptr};
+    object_methods["copy"] = {Interner::SELF_TYPE, {}, nullptr};
     
     // IO
-    classes_["IO"].methods["out_string"] = {"SELF_TYPE", {"String"}, nullptr};
-    classes_["IO"].methods["out_int"] = {"SELF_TYPE", {"Int"}, nullptr};
-    classes_["IO"].methods["in_string"] = {"String", {}, nullptr};
-    classes_["IO"].methods["in_int"] = {"Int", {}, nullptr};
+    auto &io_methods = types_.at(types_.index(Interner::IO)).methods;
+    io_methods["out_string"] = {Interner::SELF_TYPE, {Interner::STRING}, nullptr};
+    io_methods["out_int"] = {Interner::SELF_TYPE, {Interner::INT}, nullptr};
+    io_methods["in_string"] = {Interner::STRING, {}, nullptr};
+    io_methods["in_int"] = {Interner::INT, {}, nullptr};
     
     // String
-    classes_["String"].methods["length"] = {"Int", {}, nullptr};
-    classes_["String"].methods["concat"] = {"String", {"String"}, nullptr};
-    classes_["String"].methods["substr"] = {"String", {"Int", "Int"}, nullptr};
-
-    for (const auto& name : processing_order) {
-        auto& info = classes_[name];
-        if (info.ctx == nullptr) continue;
-
-        for (auto method : info.ctx->method()) {
-            string mname = method->OBJECTID()->getText();
+    auto &string_methods = types_.at(types_.index(Interner::STRING)).methods;
+    string_methods["length"] = {Interner::INT, {}, nullptr};
+    string_methods["concat"] = {Interner::STRING, {Interner::STRING}, nullptr};
+    string_methods["substr"] = {Interner::STRING, {Interner::INT, Interner::INT}, nullptr};
+
+    for (int type : processing_order) {
+        auto& info = types_.at(type);
+        if (info.ctx == nullptr && info.syntax == nullptr) continue;
+
+        auto add_method = [&](Symbol msymbol, vector<Symbol> arg_types,
+                              Symbol return_type,
+                              CoolParser::MethodContext *method) {
+            string_view mname = symbols_.name(msymbol);
             if (info.methods.contains(mname)) {
-                errors.push_back("Method `" + mname + "` already defined for class `" + name + "`");
-                continue;
+                errors.push_back("Method `" + string(mname) + "` already defined for class `" + symbols_.str(info.name) + "`");
+                return;
             }
             
-            vector<string> arg_types;
-            for (auto formal : method->formal()) {
-                 arg_types.push_back(formal->TYPEID()->getText());
-            }
-            string return_type = method->TYPEID()->getText();
-            
-            info.methods[mname] = {return_type, arg_types, method};
-        }
+            info.methods[mname] = {return_type, move(arg_types), method};
+        };
 
-        for (auto attr : info.ctx->attr()) {
-            string aname = attr->OBJECTID()->getText();
-            string type = attr->TYPEID()->getText();
+        auto add_attr = [&](Symbol asymbol, Symbol type_symbol,
+                            CoolParser::AttrContext *attr) {
+            string_view aname = symbols_.name(asymbol);
 
-            bool type_exists = classes_.contains(type) || type == "SELF_TYPE";
-            if (!type_exists) {
-                 errors.push_back("Attribute `" + aname + "` in class `" + name + "` declared to have type `" + type + "` which is undefined");
-                 continue;
+            int type = types_.index(type_symbol);
+            if (type == NO_TYPE) {
+                 errors.push_back("Attribute `" + string(aname) + "` in class `" + symbols_.str(info.name) + "` declared to have type `" + symbols_.str(type_symbol) + "` which is undefined");
+                 return;
             }
 
             if (info.attributes.contains(aname)) {
-                errors.push_back("Attribute `" + aname + "` already defined for class `" + name + "`");
-                continue;
+                errors.push_back("Attribute `" + string(aname) + "` already defined for class `" + symbols_.str(info.name) + "`");
+                return;
             }
             
-            info.attributes[aname] = {type, attr};
+            info.attributes[aname] = {asymbol, type, attr};
+        };
+
+        if (info.syntax) {
+            for (const auto &method : info.syntax->methods) {
+                vector<Symbol> arg_types;
+                for (const auto &formal : method.formals) {
+                     arg_types.push_back(formal.type);
+                }
+                add_method(method.name, move(arg_types), method.return_type,
+                           nullptr);
+            }
+
+            for (const auto &attr : info.syntax->attributes) {
+                add_attr(attr.name, attr.type, nullptr);
+            }
+            continue;
+        }
+
+        for (auto method : info.ctx->method()) {
+            vector<Symbol> arg_types;
+            for (auto formal : method->formal()) {
+                 arg_types.push_back(symbols_.symbol(formal->TYPEID()));
+            }
+            add_method(symbols_.symbol(method->OBJECTID()), move(arg_types),
+                       symbols_.symbol(method->TYPEID()), method);
+        }
+
+        for (auto attr : info.ctx->attr()) {
+            add_attr(symbols_.symbol(attr->OBJECTID()),
+                     symbols_.symbol(attr->TYPEID()), attr);
         }
     }
 
     // check methods are overridden correctly
-    for (const auto& name : processing_order) {
-        auto& info = classes_[name];
-        if (info.ctx == nullptr) continue;
+    for (int type : processing_order) {
+        auto& info = types_.at(type);
+        if (info.ctx == nullptr && info.syntax == nullptr) continue;
 
         // Check attributes
         for (auto& [aname, ainfo] : info.attributes) {
-            string curr = info.parent;
-            while (curr != "" && classes_.contains(curr)) {
-                if (classes_[curr].attributes.contains(aname)) {
-                    errors.push_back("Attribute `" + aname + "` in class `" + name + "` redefines attribute with the same name in ancestor `" + curr + "` (earliest ancestor that defines this attribute)");
+            for (int curr = info.parent; curr != NO_TYPE; curr = types_.at(curr).parent) {
+                if (types_.at(curr).attributes.contains(aname)) {
+                    errors.push_back("Attribute `" + string(aname) + "` in class `" + symbols_.str(info.name) + "` redefines attribute with the same name in ancestor `" + symbols_.str(types_.name(curr)) + "` (earliest ancestor that defines this attribute)");
                     break;
                 }
-                curr = classes_[curr].parent;
             }
         }
 
         // Check methods
         for (auto& [mname, minfo] : info.methods) {
-            string curr = info.parent;
-            string earliest_mismatch_ancestor = "";
-
-            while (curr != "" && classes_.contains(curr)) {
-                if (classes_[curr].methods.contains(mname)) {
-                    // Check signature
-                    auto& parent_method = classes_[curr].methods[mname];
-                    
-                    if (parent_method.error) {
-                        curr = classes_[curr].parent;
-                        continue;
-                    }
-
-                    bool match = true;
-                    if (minfo.return_type != parent_method.return_type) match = false;
-                    if (minfo.arg_types.size() != parent_method.arg_types.size()) match = false;
-                    else {
-                        for (size_t i = 0; i < minfo.arg_types.size(); ++i) {
-                            if (minfo.arg_types[i] != parent_method.arg_types[i]) {
-                                match = false;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    if (!match) {
-                        earliest_mismatch_ancestor = curr;
-                    }
+            int earliest_mismatch_ancestor = NO_TYPE;
+
+            for (int curr = info.parent; curr != NO_TYPE; curr = types_.at(curr).parent) {
+                auto parent_method = types_.at(curr).methods.find(mname);
+                if (parent_method == types_.at(curr).methods.end() ||
+                    parent_method->second.error) {
+                    continue;
+                }
+
+                // Check signature
+                if (minfo.return_type != parent_method->second.return_type ||
+                    minfo.arg_types != parent_method->second.arg_types) {
+                    earliest_mismatch_ancestor = curr;
                 }
-                curr = classes_[curr].parent;
             }
 
-            if (!earliest_mismatch_ancestor.empty()) {
-                errors.push_back("Override for method " + mname + " in class " + name + " has different signature than method in ancestor " + earliest_mismatch_ancestor + " (earliest ancestor that mismatches)");
+            if (earliest_mismatch_ancestor != NO_TYPE) {
+                errors.push_back("Override for method " + string(mname) + " in class " + symbols_.str(info.name) + " has different signature than method in ancestor " + symbols_.str(types_.name(earliest_mismatch_ancestor)) + " (earliest ancestor that mismatches)");
                 minfo.error = true;
             }
         }
     }
 
-    // Assign type IDs
-    type_ids_.clear();
-    type_names_.clear();
-    int id_counter = 0;
-    for (auto& [name, info] : classes_) {
-        type_ids_[name] = id_counter++;
-        type_names_.push_back(name);
-    }
-    // Add SELF_TYPE
-    type_ids_["SELF_TYPE"] = id_counter;
-    type_names_.push_back("SELF_TYPE");
-
-    // Compute depths
-    for (auto& [name, info] : classes_) {
-        int d = 0;
-        string curr = name;
-        while (curr != "Object" && classes_.contains(curr)) {
-            d++;
-            curr = classes_[curr].parent;
+    if (program_syntax_) {
+        TypeAnnotator annotator(symbols_, types_);
+        for (const auto &error : annotator.annotate(*program_syntax_)) {
+            errors.push_back(error);
         }
-        info.depth = d;
+
+        if (!errors.empty()) {
+            return unexpected(errors);
+        }
+
+        return annotator.getTypedProgram();
     }
 
-    TypeChecker checker(classes_, type_ids_, type_names_);
-    for (const auto &error : checker.check(program)) {
+    TypeChecker checker(symbols_, types_);
+    for (const auto &error : checker.check(program_)) {
         errors.push_back(error);
     }
 
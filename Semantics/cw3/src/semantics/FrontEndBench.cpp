@@ -0,0 +1,147 @@
+#include "semantics/FrontEndBench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <expected>
+#include <functional>
+#include <iomanip>
+#include <vector>
+
+#include "antlr4-runtime.h"
+
+#include "CoolParser.h"
+#include "input/MappedCharStream.h"
+#include "intern/Interner.h"
+#include "lexer/PayloadLexer.h"
+#include "memory/Arena.h"
+#include "parser/PrattParser.h"
+#include "parser/SyntaxParser.h"
+#include "semantics/CoolSemantics.h"
+
+using namespace std;
+using namespace antlr4;
+
+namespace {
+
+constexpr int BENCHMARK_RUNS = 5;
+
+using RunResult = expected<TypedProgram, vector<string>>;
+
+struct FrontEndTiming {
+    const char *name;
+    double best_ms = 0;
+    RunResult result;
+    size_t arena_objects = 0;
+    size_t arena_bytes = 0;
+};
+
+// Runs `front_end` BENCHMARK_RUNS times with a fresh arena, and keeps the
+// fastest time and the result of the last run.
+FrontEndTiming time_front_end(const char *name,
+                              const function<RunResult(Arena &)> &front_end) {
+    FrontEndTiming timing{name};
+    for (int run = 0; run < BENCHMARK_RUNS; ++run) {
+        Arena arena;
+        auto begin = chrono::steady_clock::now();
+        RunResult result = front_end(arena);
+        chrono::duration<double, milli> elapsed =
+            chrono::steady_clock::now() - begin;
+        if (run == 0 || elapsed.count() < timing.best_ms) {
+            timing.best_ms = elapsed.count();
+        }
+        timing.result = move(result);
+        timing.arena_objects = arena.object_count();
+        timing.arena_bytes = arena.bytes_used();
+    }
+    return timing;
+}
+
+// The result of a front end whose parser rejects the program.
+RunResult syntax_error() {
+    return unexpected(vector<string>{"Syntax error"});
+}
+
+bool same_results(const RunResult &expected, const RunResult &actual) {
+    if (expected.has_value() != actual.has_value()) {
+        return false;
+    }
+    if (!expected.has_value()) {
+        return expected.error() == actual.error();
+    }
+    return expected->classes.size() == actual->classes.size();
+}
+
+} // namespace
+
+bool bench_front_ends(const string &file_path, ostream &out) {
+    MappedCharStream input(file_path);
+    if (!input.is_open()) {
+        out << file_path << ": could not open file" << endl;
+        return false;
+    }
+
+    Interner interner;
+    PayloadLexer lexer(&input);
+    lexer.set_interner(&interner);
+    CommonTokenStream tokens(&lexer);
+    tokens.fill();
+    const vector<int> &token_payloads = lexer.get_token_payloads();
+
+    {
+        CoolParser parser(&tokens);
+        parser.removeErrorListeners();
+        parser.program();
+        if (parser.getNumberOfSyntaxErrors() > 0) {
+            out << file_path << ": syntax error, not timed" << endl;
+            return false;
+        }
+    }
+
+    auto cool_parser = time_front_end("CoolParser", [&](Arena &) {
+        tokens.seek(0);
+        CoolParser parser(&tokens);
+        parser.removeErrorListeners();
+        auto *program = parser.program();
+        if (parser.getNumberOfSyntaxErrors() > 0) {
+            return syntax_error();
+        }
+        return CoolSemantics(interner, token_payloads, program).run();
+    });
+
+    auto pratt_parser = time_front_end("PrattParser", [&](Arena &arena) {
+        PrattParser parser(&tokens, arena);
+        auto *program = parser.parse();
+        if (program == nullptr) {
+            return syntax_error();
+        }
+        return CoolSemantics(interner, token_payloads, program).run();
+    });
+
+    auto syntax_parser = time_front_end("SyntaxParser", [&](Arena &arena) {
+        SyntaxParser parser(&tokens, token_payloads, arena);
+        const ProgramSyntax *program = parser.parse();
+        if (program == nullptr) {
+            return syntax_error();
+        }
+        return CoolSemantics(interner, token_payloads, program).run();
+    });
+
+    bool agree = true;
+    out << file_path << ":" << endl << fixed << setprecision(3);
+    for (const auto *timing : {&cool_parser, &pratt_parser, &syntax_parser}) {
+        out << "  " << left << setw(13) << timing->name << right << setw(10)
+            << timing->best_ms << " ms, " << setprecision(2) << setw(6)
+            << cool_parser.best_ms / max(timing->best_ms, 1e-9) << "x"
+            << setprecision(3);
+        if (timing != &cool_parser) {
+            out << ", " << timing->arena_objects << " nodes in "
+                << timing->arena_bytes << " bytes";
+            if (!same_results(cool_parser.result, timing->result)) {
+                out << ", results differ from CoolParser";
+                agree = false;
+            }
+        }
+        out << endl;
+    }
+    return agree;
+}
@@ -0,0 +1,121 @@
+#include "semantics/HierarchyBench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "intern/Interner.h"
+#include "semantics/TypeTable.h"
+
+using namespace std;
+
+namespace {
+
+constexpr int BENCHMARK_RUNS = 5;
+constexpr size_t QUERIES = 1 << 20;
+// Walking takes time linear in the depth, so it gets as many tests as fit
+// into about this many steps.
+constexpr size_t WALK_STEPS = 1 << 24;
+
+// Object and `size` classes, each of which inherits from the one before if
+// `deep`, or from Object otherwise.
+TypeTable make_hierarchy(Interner &interner, int size, bool deep) {
+    vector<ClassInfo> classes;
+    classes.push_back({Interner::OBJECT, NO_TYPE, {}, {}, nullptr});
+    for (int i = 1; i <= size; ++i) {
+        Symbol name = interner.intern("C" + to_string(i));
+        classes.push_back({name, deep ? i - 1 : 0, {}, {}, nullptr});
+    }
+    TypeTable types(move(classes));
+    types.number_depth_first();
+    return types;
+}
+
+bool conforms_by_walking(const TypeTable &types, int type, int ancestor) {
+    for (int curr = type; curr != NO_TYPE; curr = types.at(curr).parent) {
+        if (curr == ancestor) return true;
+    }
+    return false;
+}
+
+int lub_by_climbing(const TypeTable &types, int type1, int type2) {
+    while (types.at(type1).depth > types.at(type2).depth) {
+        type1 = types.at(type1).parent;
+    }
+    while (types.at(type2).depth > types.at(type1).depth) {
+        type2 = types.at(type2).parent;
+    }
+    while (type1 != type2) {
+        type1 = types.at(type1).parent;
+        type2 = types.at(type2).parent;
+    }
+    return type1;
+}
+
+// Returns the best time per query over BENCHMARK_RUNS runs, in nanoseconds.
+template <typename Query>
+double time_queries(const vector<pair<int, int>> &pairs, Query query) {
+    double best_ns = 0;
+    // Keeps the queries from being optimized away.
+    volatile size_t sink = 0;
+    for (int run = 0; run < BENCHMARK_RUNS; ++run) {
+        size_t sum = 0;
+        auto begin = chrono::steady_clock::now();
+        for (auto [type1, type2] : pairs) {
+            sum += query(type1, type2);
+        }
+        chrono::duration<double, nano> elapsed =
+            chrono::steady_clock::now() - begin;
+        sink = sink + sum;
+        double ns = elapsed.count() / pairs.size();
+        if (run == 0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    return best_ns;
+}
+
+} // namespace
+
+void bench_hierarchy(ostream &out) {
+    Interner interner;
+    mt19937 random(42);
+
+    out << fixed << setprecision(2);
+    for (bool deep : {true, false}) {
+        for (int size : {10, 100, 1000, 10000}) {
+            TypeTable types = make_hierarchy(interner, size, deep);
+            uniform_int_distribution<int> any_class(0, size);
+            vector<pair<int, int>> pairs(QUERIES);
+            for (auto &pair : pairs) {
+                pair = {any_class(random), any_class(random)};
+            }
+            int object_type = types.index(Interner::OBJECT);
+
+            double conforms_ns = time_queries(pairs, [&](int a, int b) {
+                return types.conforms(a, b, object_type);
+            });
+            double lub_ns = time_queries(pairs, [&](int a, int b) {
+                return types.lub(a, b, object_type);
+            });
+            size_t walks = max<size_t>(WALK_STEPS / (deep ? size : 1), 1024);
+            pairs.resize(min(walks, pairs.size()));
+            double walk_ns = time_queries(pairs, [&](int a, int b) {
+                return conforms_by_walking(types, a, b);
+            });
+            double climb_ns = time_queries(pairs, [&](int a, int b) {
+                return lub_by_climbing(types, a, b);
+            });
+
+            out << (deep ? "deep " : "wide ") << setw(6) << size
+                << " classes: conforms " << setw(6) << conforms_ns
+                << " ns (walking " << setw(9) << walk_ns << " ns), lub "
+                << setw(6) << lub_ns << " ns (climbing " << setw(9)
+                << climb_ns << " ns)" << endl;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "semantics/TypeTable.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+using namespace std;
+
+TypeTable::TypeTable(vector<ClassInfo> classes) : classes_(move(classes)) {
+    Symbol max_symbol = Interner::SELF_TYPE;
+    for (const auto &info : classes_) {
+        max_symbol = max(max_symbol, info.name);
+    }
+    indices_.assign(max_symbol + 1, NO_TYPE);
+    for (int type = 0; type < self_type(); ++type) {
+        indices_[classes_[type].name] = type;
+    }
+    indices_[Interner::SELF_TYPE] = self_type();
+    object_ = index(Interner::OBJECT);
+}
+
+vector<int> TypeTable::number_depth_first() {
+    int count = self_type();
+    vector<vector<int>> children(count);
+    for (int type = 0; type < count; ++type) {
+        if (classes_[type].parent != NO_TYPE) {
+            children[classes_[type].parent].push_back(type);
+        }
+    }
+
+    // Walks the tree with a stack rather than by recursion, since a
+    // hierarchy may be thousands of classes deep. Each entry is a class and
+    // how many of its children have been numbered.
+    vector<int> new_index(count, NO_TYPE);
+    vector<int> old_index;
+    old_index.reserve(count);
+    vector<pair<int, size_t>> stack;
+    for (int root = 0; root < count; ++root) {
+        if (classes_[root].parent != NO_TYPE) continue;
+
+        stack.push_back({root, 0});
+        new_index[root] = static_cast<int>(old_index.size());
+        old_index.push_back(root);
+        while (!stack.empty()) {
+            auto &[type, next_child] = stack.back();
+            if (next_child == children[type].size()) {
+                classes_[type].subtree_end = static_cast<int>(old_index.size());
+                stack.pop_back();
+                continue;
+            }
+            int child = children[type][next_child++];
+            classes_[child].depth = static_cast<int>(stack.size());
+            new_index[child] = static_cast<int>(old_index.size());
+            old_index.push_back(child);
+            stack.push_back({child, 0});
+        }
+        classes_[root].depth = 0;
+    }
+
+    vector<ClassInfo> numbered;
+    numbered.reserve(count);
+    for (int type : old_index) {
+        ClassInfo &info = classes_[type];
+        if (info.parent != NO_TYPE) {
+            info.parent = new_index[info.parent];
+        }
+        for (auto &[name, attribute] : info.attributes) {
+            if (is_class(attribute.type)) {
+                attribute.type = new_index[attribute.type];
+            }
+        }
+        indices_[info.name] = new_index[type];
+        numbered.push_back(move(info));
+    }
+    classes_ = move(numbered);
+    object_ = index(Interner::OBJECT);
+    index_least_upper_bounds();
+    return new_index;
+}
+
+void TypeTable::index_least_upper_bounds() {
+    int count = self_type();
+    shallowest_.assign(1, vector<int>(count));
+    for (int type = 0; type < count; ++type) {
+        shallowest_[0][type] = type;
+    }
+    for (int span = 2; span <= count; span *= 2) {
+        const vector<int> &halves = shallowest_.back();
+        vector<int> level(count - span + 1);
+        for (int type = 0; type + span <= count; ++type) {
+            int a = halves[type];
+            int b = halves[type + span / 2];
+            level[type] = classes_[a].depth <= classes_[b].depth ? a : b;
+        }
+        shallowest_.push_back(move(level));
+    }
+}
+
+bool TypeTable::conforms(int type1, int type2, int self_class) const {
+    if (type1 == type2) return true;
+    if (type2 == object_) return true;
+
+    if (type1 == self_type()) {
+        return conforms(self_class, type2, self_class);
+    }
+    if (!is_class(type1) || !is_class(type2)) {
+        return false;
+    }
+    return is_subclass(type1, type2);
+}
+
+int TypeTable::lub(int type1, int type2, int self_class) const {
+    if (type1 == type2) return type1;
+    if (type1 == self_type()) type1 = self_class;
+    if (type2 == self_type()) type2 = self_class;
+
+    if (!is_class(type1) || !is_class(type2)) return object_;
+    if (type1 == type2) return type1;
+
+    // The classes after type1, up to type2, all descend from the lub, and
+    // they include the child of the lub that type2 inherits from, or is.
+    // None of them is shallower than that child.
+    if (type1 > type2) swap(type1, type2);
+    int first = type1 + 1;
+    int level = bit_width(static_cast<unsigned>(type2 - first + 1)) - 1;
+    int a = shallowest_[level][first];
+    int b = shallowest_[level][type2 - (1 << level) + 1];
+    int child = classes_[a].depth <= classes_[b].depth ? a : b;
+    return classes_[child].parent;
+}
+
+const MethodInfo *TypeTable::find_method(int type,
+                                         string_view method_name) const {
+    for (int curr = type; is_class(curr); curr = classes_[curr].parent) {
+        const auto &methods = classes_[curr].methods;
+        auto method = methods.find(method_name);
+        if (method != methods.end()) {
+            return &method->second;
+        }
+    }
+    return nullptr;
+}
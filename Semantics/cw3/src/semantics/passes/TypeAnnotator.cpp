@@ -0,0 +1,655 @@
+#include "semantics/passes/TypeAnnotator.h"
+
+#include <set>
+#include <string_view>
+
+#include "semantics/typed-ast/Arithmetic.h"
+#include "semantics/typed-ast/Assignment.h"
+#include "semantics/typed-ast/Attributes.h"
+#include "semantics/typed-ast/BoolConstant.h"
+#include "semantics/typed-ast/BooleanNegation.h"
+#include "semantics/typed-ast/CaseOfEsac.h"
+#include "semantics/typed-ast/DynamicDispatch.h"
+#include "semantics/typed-ast/EqualityComparison.h"
+#include "semantics/typed-ast/IfThenElseFi.h"
+#include "semantics/typed-ast/IntConstant.h"
+#include "semantics/typed-ast/IntegerComparison.h"
+#include "semantics/typed-ast/IntegerNegation.h"
+#include "semantics/typed-ast/IsVoid.h"
+#include "semantics/typed-ast/LetIn.h"
+#include "semantics/typed-ast/Methods.h"
+#include "semantics/typed-ast/NewObject.h"
+#include "semantics/typed-ast/ObjectReference.h"
+#include "semantics/typed-ast/ParenthesizedExpr.h"
+#include "semantics/typed-ast/Sequence.h"
+#include "semantics/typed-ast/StaticDispatch.h"
+#include "semantics/typed-ast/StringConstant.h"
+#include "semantics/typed-ast/Vardecl.h"
+#include "semantics/typed-ast/WhileLoopPool.h"
+
+using namespace std;
+
+using MethodError = ErrorMessagePrinter::MethodError;
+using AttrError = ErrorMessagePrinter::AttrError;
+using ExprError = ErrorMessagePrinter::ExprError;
+
+vector<string> TypeAnnotator::annotate(const ProgramSyntax &program) {
+    for (const auto &class_syntax : program.classes) {
+        annotateClass(class_syntax);
+    }
+    vector<string> str_errors;
+    for (const auto &err : errors) {
+        str_errors.push_back(err.to_string());
+    }
+    return str_errors;
+}
+
+void TypeAnnotator::enterScope() { symbol_table.enter_scope(); }
+
+void TypeAnnotator::exitScope() { symbol_table.exit_scope(); }
+
+void TypeAnnotator::addSymbol(Symbol name, int type) {
+    symbol_table.bind(name, type);
+}
+
+int TypeAnnotator::lookupSymbol(Symbol name) {
+    return symbol_table.find(name).value_or(NO_TYPE);
+}
+
+bool TypeAnnotator::conform(int type1, int type2) {
+    return types.conforms(type1, type2, current_class);
+}
+
+int TypeAnnotator::lub(int type1, int type2) {
+    return types.lub(type1, type2, current_class);
+}
+
+string TypeAnnotator::typeName(int type) const {
+    return symbols.str(types.name(type));
+}
+
+void TypeAnnotator::checkArguments(const MethodInfo &method,
+                                   Symbol method_name, int lookup_type,
+                                   const vector<unique_ptr<Expr>> &args) {
+    const auto &formal_types = method.arg_types;
+    if (args.size() != formal_types.size()) {
+        errors.push_back(ErrorMessagePrinter(
+            ExprError::METHOD_BAD_ARGS_NUMBER,
+            {symbols.str(method_name), typeName(lookup_type),
+             to_string(formal_types.size()), to_string(args.size())}));
+        return;
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+        int arg_type = args[i]->get_type();
+        if (!conform(arg_type, types.index(formal_types[i]))) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::METHOD_INVALID_CALL,
+                {symbols.str(method_name), typeName(lookup_type)}));
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::ARGUMENT_HAS_WRONG_TYPE,
+                {typeName(arg_type), symbols.str(formal_types[i]),
+                 to_string(i)}));
+        }
+    }
+}
+
+void TypeAnnotator::annotateClass(const ClassSyntax &syntax) {
+    current_class = types.index(syntax.name);
+
+    TypedClass typed_class;
+    typed_class.name = syntax.name;
+    typed_class.parent = syntax.parent;
+    typed_class.line = syntax.line;
+
+    enterScope();
+    addSymbol(Interner::SELF, self_type);
+
+    // add inherited attributes
+    for (int curr = types.at(current_class).parent; curr != object_type;
+         curr = types.at(curr).parent) {
+        for (auto const &[name, info] : types.at(curr).attributes) {
+            addSymbol(info.name, info.type);
+        }
+    }
+
+    for (const auto &attr : syntax.attributes) {
+        int type = types.index(attr.type);
+        if (type != NO_TYPE) {
+            addSymbol(attr.name, type);
+        }
+    }
+
+    for (const auto &attr : syntax.attributes) {
+        if (auto a = annotateAttr(attr)) {
+            typed_class.attributes.add(move(*a));
+        }
+    }
+    set<Symbol> seen_methods;
+    for (const auto &method : syntax.methods) {
+        if (!seen_methods.insert(method.name).second) {
+            continue;
+        }
+        if (auto m = annotateMethod(method)) {
+            if (!typed_class.methods.contains(m->get_name())) {
+                typed_class.methods.add_method(move(*m));
+            }
+        }
+    }
+
+    exitScope();
+
+    typed_program.classes.push_back(move(typed_class));
+}
+
+unique_ptr<Method> TypeAnnotator::annotateMethod(const MethodSyntax &syntax) {
+    enterScope();
+
+    vector<Symbol> arg_names;
+    vector<int> signature;
+    bool types_ok = true;
+
+    for (const auto &formal : syntax.formals) {
+        Symbol name = formal.name;
+        int type = types.index(formal.type);
+        if (name == Interner::SELF) {
+            errors.push_back(
+                ErrorMessagePrinter(MethodError::SELF_PARAMETER_NAME));
+        }
+        if (symbol_table.bound_in_innermost_scope(name)) {
+            errors.push_back(ErrorMessagePrinter(MethodError::MULTIPLE_DEF,
+                                                 {symbols.str(name)}));
+        }
+        if (type == self_type) {
+            errors.push_back(ErrorMessagePrinter(
+                MethodError::SELF_ARGUMENT_TYPE, {symbols.str(name)}));
+            types_ok = false;
+        } else if (type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(
+                MethodError::UNDEFINED_ARGUMENT_TYPE,
+                {symbols.str(syntax.name), typeName(current_class),
+                 symbols.str(formal.type)}));
+            types_ok = false;
+        }
+        addSymbol(name, type);
+        arg_names.push_back(name);
+        signature.push_back(type);
+    }
+
+    int return_type = types.index(syntax.return_type);
+    if (return_type == NO_TYPE) {
+        errors.push_back(ErrorMessagePrinter(
+            MethodError::UNDEFINED_RETURN_TYPE,
+            {symbols.str(syntax.name), typeName(current_class),
+             symbols.str(syntax.return_type)}));
+        types_ok = false;
+    }
+
+    if (!types_ok) {
+        exitScope();
+        return nullptr;
+    }
+
+    size_t errors_before = errors.size();
+    auto body = annotateExpr(*syntax.body);
+    int body_type = body->get_type();
+
+    if (errors.size() == errors_before || body_type != object_type) {
+        if (!conform(body_type, return_type)) {
+            errors.push_back(ErrorMessagePrinter(
+                MethodError::BODY_TYPE_MISMATCH,
+                {typeName(current_class), symbols.str(syntax.name),
+                 typeName(body_type), typeName(return_type)}));
+        }
+    }
+
+    exitScope();
+
+    signature.push_back(return_type);
+
+    auto m = make_unique<Method>(syntax.name, signature);
+    m->set_argument_names(arg_names);
+    m->set_body(move(body));
+    return m;
+}
+
+unique_ptr<Attribute> TypeAnnotator::annotateAttr(const AttrSyntax &syntax) {
+    Symbol name = syntax.name;
+    int type = types.index(syntax.type);
+
+    if (name == Interner::SELF) {
+        errors.push_back(ErrorMessagePrinter(AttrError::SELF_ATTR_NAME));
+    }
+
+    if (type == NO_TYPE) {
+        return nullptr;
+    }
+
+    unique_ptr<Expr> init = nullptr;
+    if (syntax.initializer) {
+        size_t errors_before = errors.size();
+        init = annotateExpr(*syntax.initializer);
+        int init_type = init->get_type();
+
+        if (errors.size() == errors_before) {
+            if (!conform(init_type, type)) {
+                errors.push_back(ErrorMessagePrinter(
+                    AttrError::BAD_SUBTYPE,
+                    {typeName(current_class), symbols.str(name),
+                     typeName(init_type), typeName(type)}));
+            }
+        }
+    }
+
+    auto a = make_unique<Attribute>(name, type);
+    if (init) a->set_initializer(move(init));
+    return a;
+}
+
+unique_ptr<Expr> TypeAnnotator::annotateExpr(const ExprSyntax &syntax) {
+    using Kind = ExprSyntax::Kind;
+
+    switch (syntax.kind) {
+    case Kind::IntConstant:
+        return make_unique<IntConstant>(syntax.value, int_type);
+
+    case Kind::StringConstant:
+        return make_unique<StringConstant>(syntax.name, string_type);
+
+    case Kind::BoolConstant:
+        return make_unique<BoolConstant>(syntax.value != 0, bool_type);
+
+    case Kind::Object: {
+        int type = lookupSymbol(syntax.name);
+        if (type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(ExprError::OUT_OF_SCOPE,
+                                                 {symbols.str(syntax.name)}));
+            type = object_type;
+        }
+        return make_unique<ObjectReference>(syntax.name, type);
+    }
+
+    case Kind::Assignment: {
+        Symbol name = syntax.name;
+        if (name == Interner::SELF) {
+            errors.push_back(ErrorMessagePrinter(ExprError::NO_SELF_ASSIGN));
+        }
+
+        auto val = annotateExpr(*syntax.operands[0]);
+        int val_type = val->get_type();
+
+        int var_type = lookupSymbol(name);
+        if (var_type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::ASSIGNEE_OUT_SCOPE, {symbols.str(name)}));
+        } else if (!conform(val_type, var_type)) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::ASSIGNEE_NOT_SUBTYPE,
+                {typeName(current_class), symbols.str(name),
+                 typeName(val_type), typeName(var_type)}));
+            val_type = var_type;
+        }
+
+        return make_unique<Assignment>(name, move(val), val_type);
+    }
+
+    case Kind::SelfDispatch:
+    case Kind::DynamicDispatch:
+    case Kind::StaticDispatch:
+        return annotateDispatch(syntax);
+
+    case Kind::NewObject: {
+        int type = types.index(syntax.type);
+        if (type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::INSTANTIATE_UKNOWN_CLASS,
+                {symbols.str(syntax.type)}));
+            type = object_type;
+        }
+        return make_unique<NewObject>(type);
+    }
+
+    case Kind::IfThenElseFi: {
+        auto pred = annotateExpr(*syntax.operands[0]);
+        int pred_type = pred->get_type();
+        if (pred_type != bool_type) {
+            errors.push_back(ErrorMessagePrinter(ExprError::IF_ELSE_NOT_BOOL,
+                                                 {typeName(pred_type)}));
+        }
+
+        auto then_e = annotateExpr(*syntax.operands[1]);
+        int then_type = then_e->get_type();
+
+        auto else_e = annotateExpr(*syntax.operands[2]);
+        int else_type = else_e->get_type();
+
+        int join_type = lub(then_type, else_type);
+        return make_unique<IfThenElseFi>(move(pred), move(then_e),
+                                         move(else_e), join_type);
+    }
+
+    case Kind::WhileLoopPool: {
+        auto pred = annotateExpr(*syntax.operands[0]);
+        int pred_type = pred->get_type();
+        if (pred_type != bool_type) {
+            errors.push_back(ErrorMessagePrinter(ExprError::WHILE_NOT_BOOL,
+                                                 {typeName(pred_type)}));
+        }
+
+        auto body = annotateExpr(*syntax.operands[1]);
+
+        return make_unique<WhileLoopPool>(move(pred), move(body),
+                                          object_type);
+    }
+
+    case Kind::Sequence: {
+        vector<unique_ptr<Expr>> exprs;
+        int last_type = object_type;
+        for (const ExprSyntax *operand : syntax.operands) {
+            auto expr = annotateExpr(*operand);
+            last_type = expr->get_type();
+            exprs.push_back(move(expr));
+        }
+        return make_unique<Sequence>(move(exprs), last_type);
+    }
+
+    case Kind::LetIn: {
+        enterScope();
+        vector<unique_ptr<Vardecl>> decls;
+        for (const auto &vardecl : syntax.vardecls) {
+            Symbol name = vardecl.name;
+            int type = types.index(vardecl.type);
+            if (name == Interner::SELF) {
+                errors.push_back(
+                    ErrorMessagePrinter(ExprError::LET_NO_SELF_ASSIGN));
+            }
+            if (type == NO_TYPE) {
+                errors.push_back(ErrorMessagePrinter(
+                    ExprError::LET_BAD_TYPE,
+                    {symbols.str(vardecl.type), symbols.str(name)}));
+                type = object_type;
+            }
+
+            unique_ptr<Expr> init = nullptr;
+            if (vardecl.initializer) {
+                size_t errors_before = errors.size();
+                init = annotateExpr(*vardecl.initializer);
+                bool init_had_error = errors.size() > errors_before;
+                int init_type = init->get_type();
+                if (!init_had_error && !conform(init_type, type)) {
+                    errors.push_back(ErrorMessagePrinter(
+                        ExprError::LET_NOT_SUBTYPE,
+                        {symbols.str(name), typeName(init_type),
+                         typeName(type)}));
+                }
+            }
+
+            addSymbol(name, type);
+            decls.push_back(make_unique<Vardecl>(name, move(init), type));
+        }
+
+        auto body = annotateExpr(*syntax.operands[0]);
+
+        exitScope();
+
+        int type = body->get_type();
+        return make_unique<LetIn>(move(decls), move(body), type);
+    }
+
+    case Kind::CaseOfEsac: {
+        auto expr = annotateExpr(*syntax.operands[0]);
+
+        vector<CaseOfEsac::Case> cases;
+        int join_type = NO_TYPE;
+        // by name, so that two undefined types only clash if they are the
+        // same
+        set<Symbol> branch_types;
+
+        for (const auto &branch : syntax.branches) {
+            Symbol name = branch.name;
+            int type = types.index(branch.type);
+            bool type_ok = true;
+
+            if (type == self_type) {
+                errors.push_back(ErrorMessagePrinter(ExprError::CASE_SELF_TYPE,
+                                                     {symbols.str(name)}));
+                type_ok = false;
+            } else if (type == NO_TYPE) {
+                errors.push_back(ErrorMessagePrinter(
+                    ExprError::CASE_UKNOWN_TYPE,
+                    {symbols.str(name), symbols.str(branch.type)}));
+                type_ok = false;
+            }
+
+            if (!branch_types.insert(branch.type).second) {
+                errors.push_back(ErrorMessagePrinter(
+                    ExprError::CASE_MULTIPLE_OPTIONS_TYPE,
+                    {symbols.str(branch.type)}));
+            }
+
+            enterScope();
+            if (type_ok) {
+                addSymbol(name, type);
+            }
+
+            auto branch_expr = annotateExpr(*branch.body);
+            int branch_type = branch_expr->get_type();
+
+            if (join_type == NO_TYPE) join_type = branch_type;
+            else join_type = lub(join_type, branch_type);
+
+            int type_id = type_ok ? type : object_type;
+            cases.emplace_back(name, type_id, move(branch_expr));
+
+            exitScope();
+        }
+
+        return make_unique<CaseOfEsac>(move(expr), move(cases), syntax.line,
+                                       join_type);
+    }
+
+    case Kind::Addition:
+    case Kind::Subtraction:
+    case Kind::Multiplication:
+    case Kind::Division: {
+        auto l = annotateExpr(*syntax.operands[0]);
+        auto r = annotateExpr(*syntax.operands[1]);
+
+        int l_type = l->get_type();
+        int r_type = r->get_type();
+
+        if (l_type != int_type) {
+            errors.push_back(
+                ErrorMessagePrinter(ExprError::OP_BAD_LEFT, {typeName(l_type)}));
+        }
+        if (r_type != int_type) {
+            errors.push_back(ErrorMessagePrinter(ExprError::OP_BAD_RIGHT,
+                                                 {typeName(r_type)}));
+        }
+
+        Arithmetic::Kind op = Arithmetic::Kind::Division;
+        if (syntax.kind == Kind::Addition) {
+            op = Arithmetic::Kind::Addition;
+        } else if (syntax.kind == Kind::Subtraction) {
+            op = Arithmetic::Kind::Subtraction;
+        } else if (syntax.kind == Kind::Multiplication) {
+            op = Arithmetic::Kind::Multiplication;
+        }
+
+        return make_unique<Arithmetic>(move(l), move(r), op, int_type);
+    }
+
+    case Kind::LessThan:
+    case Kind::LessThanEqual:
+    case Kind::Equal: {
+        auto l = annotateExpr(*syntax.operands[0]);
+        auto r = annotateExpr(*syntax.operands[1]);
+
+        int l_type = l->get_type();
+        int r_type = r->get_type();
+
+        if (syntax.kind == Kind::Equal) {
+            auto is_basic = [&](int type) {
+                return type == int_type || type == string_type ||
+                       type == bool_type;
+            };
+            if ((is_basic(l_type) || is_basic(r_type)) && l_type != r_type) {
+                errors.push_back(ErrorMessagePrinter(
+                    ExprError::OP_BAD_COMPARE,
+                    {typeName(l_type), typeName(r_type)}));
+            }
+            return make_unique<EqualityComparison>(move(l), move(r),
+                                                   bool_type);
+        }
+
+        if (l_type != int_type) {
+            errors.push_back(ErrorMessagePrinter(ExprError::CMP_BAD_LEFT,
+                                                 {typeName(l_type)}));
+        }
+        if (r_type != int_type) {
+            errors.push_back(ErrorMessagePrinter(ExprError::CMP_BAD_RIGHT,
+                                                 {typeName(r_type)}));
+        }
+        auto op = syntax.kind == Kind::LessThan
+                      ? IntegerComparison::Kind::LessThan
+                      : IntegerComparison::Kind::LessThanEqual;
+        return make_unique<IntegerComparison>(move(l), move(r), op,
+                                              bool_type);
+    }
+
+    case Kind::BooleanNegation: {
+        auto e = annotateExpr(*syntax.operands[0]);
+        if (e->get_type() != bool_type) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::NOT_BAD_TYPE, {typeName(e->get_type())}));
+        }
+        return make_unique<BooleanNegation>(move(e), bool_type);
+    }
+
+    case Kind::IntegerNegation: {
+        auto e = annotateExpr(*syntax.operands[0]);
+        if (e->get_type() != int_type) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::TILDE_BAD_TYPE, {typeName(e->get_type())}));
+        }
+        return make_unique<IntegerNegation>(move(e), int_type);
+    }
+
+    case Kind::IsVoid: {
+        auto e = annotateExpr(*syntax.operands[0]);
+        return make_unique<IsVoid>(move(e), bool_type);
+    }
+
+    case Kind::Parenthesized: {
+        auto e = annotateExpr(*syntax.operands[0]);
+        int type = e->get_type();
+        return make_unique<ParenthesizedExpr>(move(e), type);
+    }
+    }
+
+    return make_unique<Expr>(object_type);
+}
+
+unique_ptr<Expr> TypeAnnotator::annotateDispatch(const ExprSyntax &syntax) {
+    string_view method_name = symbols.name(syntax.name);
+
+    // Implicit dispatch, whose target is self
+    if (syntax.kind == ExprSyntax::Kind::SelfDispatch) {
+        auto target = make_unique<ObjectReference>(Interner::SELF, self_type);
+
+        vector<unique_ptr<Expr>> args;
+        for (const ExprSyntax *operand : syntax.operands) {
+            args.push_back(annotateExpr(*operand));
+        }
+
+        int lookup_type = current_class;
+        const MethodInfo *method = types.find_method(lookup_type, method_name);
+        if (!method) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::METHOD_NOT_DEFINED,
+                {string(method_name), typeName(lookup_type),
+                 "dynamic dispatch"}));
+        } else {
+            checkArguments(*method, syntax.name, lookup_type, args);
+        }
+
+        // SELF_TYPE stays SELF_TYPE, since the target is self. An undefined
+        // return type was reported with the method.
+        int return_type = object_type;
+        if (method) {
+            return_type = types.index(method->return_type);
+            if (return_type == NO_TYPE) {
+                return_type = object_type;
+            }
+        }
+
+        return make_unique<DynamicDispatch>(move(target), syntax.name,
+                                            move(args), return_type);
+    }
+
+    bool is_static = syntax.kind == ExprSyntax::Kind::StaticDispatch;
+
+    size_t errors_before = errors.size();
+    auto target = annotateExpr(*syntax.operands[0]);
+    bool target_had_error = errors.size() > errors_before;
+
+    int target_type = target->get_type();
+
+    int static_type = NO_TYPE;
+    bool static_type_error = false;
+    if (is_static) {
+        static_type = types.index(syntax.type);
+        if (static_type == self_type) {
+            errors.push_back(ErrorMessagePrinter(ExprError::STATIC_TO_SELF));
+            static_type = object_type;
+            static_type_error = true;
+        } else if (static_type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::STATIC_UNDEFINED_TYPE, {symbols.str(syntax.type)}));
+            static_type = object_type;
+            static_type_error = true;
+        } else if (!conform(target_type, static_type)) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::STAT_DISPATCH_BAD_TYPE,
+                {typeName(target_type), typeName(static_type)}));
+        }
+    }
+
+    vector<unique_ptr<Expr>> args;
+    for (const ExprSyntax *operand : syntax.operands.subspan(1)) {
+        args.push_back(annotateExpr(*operand));
+    }
+
+    int lookup_type = static_type == NO_TYPE ? target_type : static_type;
+    if (static_type_error) lookup_type = target_type;
+    if (lookup_type == self_type) lookup_type = current_class;
+
+    const MethodInfo *method = types.find_method(lookup_type, method_name);
+    if (!method) {
+        if (!target_had_error) {
+            errors.push_back(ErrorMessagePrinter(
+                ExprError::METHOD_NOT_DEFINED,
+                {string(method_name), typeName(lookup_type),
+                 is_static ? "static dispatch" : "dynamic dispatch"}));
+        }
+    } else {
+        checkArguments(*method, syntax.name, lookup_type, args);
+    }
+
+    int return_type = object_type;
+    if (method) {
+        return_type = types.index(method->return_type);
+        if (return_type == self_type) {
+            return_type = target_type;
+        } else if (return_type == NO_TYPE) {
+            return_type = object_type;
+        }
+    }
+
+    if (is_static) {
+        return make_unique<StaticDispatch>(move(target), static_type,
+                                           syntax.name, move(args),
+                                           return_type);
+    }
+    return make_unique<DynamicDispatch>(move(target), syntax.name, move(args),
+                                        return_type);
+}
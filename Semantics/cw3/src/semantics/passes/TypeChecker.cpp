@@ -1,5 +1,8 @@
 #include "semantics/passes/TypeChecker.h"
 
+#include <set>
+#include <string_view>
+
 #include "semantics/typed-ast/Arithmetic.h"
 #include "semantics/typed-ast/Assignment.h"
 #include "semantics/typed-ast/Attribute.h"
@@ -30,6 +33,19 @@
 
 using namespace std;
 
+namespace {
+
+// Returns `tree` as a token node, or nullptr if it is a rule context or an
+// error node.
+antlr4::tree::TerminalNode *token_node(antlr4::tree::ParseTree *tree) {
+    if (dynamic_cast<antlr4::tree::ErrorNode *>(tree) != nullptr) {
+        return nullptr;
+    }
+    return dynamic_cast<antlr4::tree::TerminalNode *>(tree);
+}
+
+} // namespace
+
 string ErrorMessagePrinter::to_string() const {
     if (holds_alternative<MethodError>(error)) {
         MethodError err = get<MethodError>(error);
@@ -84,7 +100,7 @@ string ErrorMessagePrinter::to_string() const {
 }
 
 vector<string> TypeChecker::check(CoolParser::ProgramContext *ctx) {
-    visit(ctx);
+    visitProgram(ctx);
     vector<string> str_errors;
     for (const auto& err : errors) {
         str_errors.push_back(err.to_string());
@@ -93,143 +109,157 @@ vector<string> TypeChecker::check(CoolParser::ProgramContext *ctx) {
 }
 
 void TypeChecker::enterScope() {
-    symbol_table.push_back({});
+    symbol_table.enter_scope();
 }
 
 void TypeChecker::exitScope() {
-    symbol_table.pop_back();
+    symbol_table.exit_scope();
 }
 
-void TypeChecker::addSymbol(string name, string type) {
-    symbol_table.back()[name] = type;
+void TypeChecker::addSymbol(Symbol name, int type) {
+    symbol_table.bind(name, type);
 }
 
-string TypeChecker::lookupSymbol(string name) {
-    for (auto it = symbol_table.rbegin(); it != symbol_table.rend(); ++it) {
-        if (it->contains(name)) {
-            return (*it)[name];
-        }
-    }
-    return "";
+int TypeChecker::lookupSymbol(Symbol name) {
+    return symbol_table.find(name).value_or(NO_TYPE);
 }
 
-bool TypeChecker::conform(string type1, string type2) {
-    if (type1 == type2) return true;
-    if (type2 == "Object") return true;
-    if (type1 == "Object") return false; 
-    
-    if (type1 == "SELF_TYPE") {
-        if (type2 == "SELF_TYPE") return true;
-        return conform(current_class, type2);
-    }
-    if (type2 == "SELF_TYPE") {
-        return false; 
-    }
-    
-    string curr = type1;
-    while (curr != "Object" && classes.contains(curr)) {
-        if (curr == type2) return true;
-        curr = classes.at(curr).parent;
-    }
-    return false;
+bool TypeChecker::conform(int type1, int type2) {
+    return types.conforms(type1, type2, current_class);
 }
 
-string TypeChecker::lub(string type1, string type2) {
-    if (type1 == type2) return type1;
-    if (type1 == "SELF_TYPE") return lub(current_class, type2);
-    if (type2 == "SELF_TYPE") return lub(type1, current_class);
-    
-    if (!classes.contains(type1) || !classes.contains(type2)) return "Object";
+int TypeChecker::lub(int type1, int type2) {
+    return types.lub(type1, type2, current_class);
+}
 
-    int d1 = classes.at(type1).depth;
-    int d2 = classes.at(type2).depth;
-    
-    string t1 = type1;
-    string t2 = type2;
-    
-    while (d1 > d2) {
-        t1 = classes.at(t1).parent;
-        d1--;
-    }
-    while (d2 > d1) {
-        t2 = classes.at(t2).parent;
-        d2--;
-    }
-    
-    while (t1 != t2) {
-        t1 = classes.at(t1).parent;
-        t2 = classes.at(t2).parent;
-    }
-    
-    return t1;
+string TypeChecker::typeName(int type) const {
+    return symbols.str(types.name(type));
 }
 
-unique_ptr<Expr> TypeChecker::visitExprAndAssertOk(CoolParser::ExprContext *ctx) {
-    visitExpr(ctx);
-    if (scratchpad.empty()) {
-        assert(false && "scratchpad is empty after visitExpr, but "
-               "caller expects an Expr there");
+unique_ptr<Expr> TypeChecker::visitExpr(CoolParser::ExprContext *ctx) {
+    // After a syntax error, CoolParser may leave an expr out, or build one
+    // with no children or with error nodes where tokens were expected. Such an
+    // expr gets type Object, and no error of its own.
+    if (ctx == nullptr || ctx->children.empty()) {
+        return make_unique<Expr>(object_type);
     }
-    auto expr = move(scratchpad.top());
-    scratchpad.pop();
-    return move(expr);
+
+    // The alternatives of `expr` share ExprContext. Most of them start with a
+    // token of their own; the left-recursive ones start with an expr, and are
+    // told apart by the token that follows it.
+    auto *first = token_node(ctx->children[0]);
+    if (first == nullptr) {
+        auto *op = ctx->children.size() > 1 ? token_node(ctx->children[1])
+                                            : nullptr;
+        switch (op ? op->getSymbol()->getType() : antlr4::Token::INVALID_TYPE) {
+            case CoolParser::AT:
+            case CoolParser::DOT:
+                return visitDispatch(ctx);
+            case CoolParser::STAR:
+                return visitArithmetic(ctx, Arithmetic::Kind::Multiplication);
+            case CoolParser::SLASH:
+                return visitArithmetic(ctx, Arithmetic::Kind::Division);
+            case CoolParser::PLUS:
+                return visitArithmetic(ctx, Arithmetic::Kind::Addition);
+            case CoolParser::MINUS:
+                return visitArithmetic(ctx, Arithmetic::Kind::Subtraction);
+            case CoolParser::EQ:
+            case CoolParser::LT:
+            case CoolParser::LE:
+                return visitCompare(ctx);
+        }
+    } else {
+        switch (first->getSymbol()->getType()) {
+            case CoolParser::OBJECTID:
+                // a variable, an assignment or a call of a method of self
+                if (ctx->children.size() == 1) {
+                    return visitObject(ctx);
+                }
+                if (ctx->ASSIGN()) {
+                    return visitAssignment(ctx);
+                }
+                return visitSelfDispatch(ctx);
+            case CoolParser::INT_CONST:
+                return visitInt(ctx);
+            case CoolParser::STR_CONST:
+                return visitString(ctx);
+            case CoolParser::BOOL_CONST:
+                return visitBool(ctx);
+            case CoolParser::NEW:
+                return visitNew(ctx);
+            case CoolParser::IF:
+                return visitCond(ctx);
+            case CoolParser::WHILE:
+                return visitLoop(ctx);
+            case CoolParser::OCURLY:
+                return visitBlock(ctx);
+            case CoolParser::LET:
+                return visitLet(ctx);
+            case CoolParser::CASE:
+                return visitCase(ctx);
+            case CoolParser::OPAREN:
+                return visitParen(ctx);
+            case CoolParser::TILDE:
+                return visitNeg(ctx);
+            case CoolParser::ISVOID:
+                return visitIsvoid(ctx);
+            case CoolParser::NOT:
+                return visitNot(ctx);
+        }
+    }
+    return make_unique<Expr>(object_type);
 }
 
-any TypeChecker::visitProgram(CoolParser::ProgramContext *ctx) {
+void TypeChecker::visitProgram(CoolParser::ProgramContext *ctx) {
     for (auto class_ctx : ctx->class_()) {
-        visit(class_ctx);
+        visitClass(class_ctx);
     }
-    return nullptr;
 }
 
-any TypeChecker::visitClass(CoolParser::ClassContext *ctx) {
-    current_class = ctx->TYPEID(0)->getText();
-    string parent = "Object";
-    if (ctx->INHERITS()) parent = ctx->TYPEID(1)->getText();
+void TypeChecker::visitClass(CoolParser::ClassContext *ctx) {
+    Symbol class_symbol = symbols.symbol(ctx->TYPEID(0));
+    Symbol parent_symbol = Interner::OBJECT;
+    if (ctx->INHERITS()) parent_symbol = symbols.symbol(ctx->TYPEID(1));
+    current_class = types.index(class_symbol);
     
     TypedClass typed_class;
-    typed_class.name = current_class;
-    typed_class.parent = parent;
+    typed_class.name = class_symbol;
+    typed_class.parent = parent_symbol;
     typed_class.line = ctx->getStart()->getLine();
     
     enterScope();
-    addSymbol("self", "SELF_TYPE");
+    addSymbol(Interner::SELF, self_type);
     
     // add inherited attributes
-    string curr = parent;
-    while (curr != "Object" && classes.contains(curr)) {
-        for (auto const& [name, info] : classes.at(curr).attributes) {
-             addSymbol(name, info.type);
+    for (int curr = types.at(current_class).parent; curr != object_type;
+         curr = types.at(curr).parent) {
+        for (auto const& [name, info] : types.at(curr).attributes) {
+             addSymbol(info.name, info.type);
         }
-        curr = classes.at(curr).parent;
     }
 
     for (auto attr : ctx->attr()) {
-        string name = attr->OBJECTID()->getText();
-        string type = attr->TYPEID()->getText();
-        if (type_ids.contains(type)) {
+        Symbol name = symbols.symbol(attr->OBJECTID());
+        int type = types.index(symbols.symbol(attr->TYPEID()));
+        if (type != NO_TYPE) {
             addSymbol(name, type);
         }
     }
 
     for (auto attr : ctx->attr()) {
-        any res = visit(attr);
-        if (res.has_value()) {
-            unique_ptr<Attribute> a(any_cast<Attribute*>(res));
+        if (auto a = visitAttr(attr)) {
             typed_class.attributes.add(move(*a));
         }
     }
-    std::set<string> seen_methods;
+    std::set<Symbol> seen_methods;
     for (auto method : ctx->method()) {
-        string method_name = method->OBJECTID()->getText();
+        Symbol method_name = symbols.symbol(method->OBJECTID());
         if (seen_methods.contains(method_name)) {
             continue;
         }
         seen_methods.insert(method_name);
 
-        any res = visit(method);
-        if (res.has_value()) {
-            unique_ptr<Method> m(any_cast<Method*>(res));
+        if (auto m = visitMethod(method)) {
             if (!typed_class.methods.contains(m->get_name())) {
                 typed_class.methods.add_method(move(*m));
             }
@@ -239,543 +269,473 @@ any TypeChecker::visitClass(CoolParser::ClassContext *ctx) {
     exitScope();
     
     typed_program.classes.push_back(move(typed_class));
-    return nullptr;
 }
 
-any TypeChecker::visitMethod(CoolParser::MethodContext *ctx) {
-    string method_name = ctx->OBJECTID()->getText();
+unique_ptr<Method> TypeChecker::visitMethod(CoolParser::MethodContext *ctx) {
+    Symbol method_symbol = symbols.symbol(ctx->OBJECTID());
     enterScope();
     
-    vector<string> arg_names;
-    vector<string> arg_types;
+    vector<Symbol> arg_names;
+    vector<int> signature;
     bool types_ok = true;
     
     for (auto formal : ctx->formal()) {
-        string name = formal->OBJECTID()->getText();
-        string type = formal->TYPEID()->getText();
-        if (name == "self") {
+        Symbol name = symbols.symbol(formal->OBJECTID());
+        Symbol type_symbol = symbols.symbol(formal->TYPEID());
+        int type = types.index(type_symbol);
+        if (name == Interner::SELF) {
             errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::SELF_PARAMETER_NAME));
         }
-        if (symbol_table.back().contains(name)) {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::MULTIPLE_DEF, {name}));
+        if (symbol_table.bound_in_innermost_scope(name)) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::MULTIPLE_DEF, {symbols.str(name)}));
         }
-        if (type == "SELF_TYPE") {
-             errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::SELF_ARGUMENT_TYPE, {name}));
+        if (type == self_type) {
+             errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::SELF_ARGUMENT_TYPE, {symbols.str(name)}));
              types_ok = false;
-        } else if (!type_ids.contains(type)) {
-             errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::UNDEFINED_ARGUMENT_TYPE, {method_name, current_class, type}));
+        } else if (type == NO_TYPE) {
+             errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::UNDEFINED_ARGUMENT_TYPE, {symbols.str(method_symbol), typeName(current_class), symbols.str(type_symbol)}));
              types_ok = false;
         }
         addSymbol(name, type);
         arg_names.push_back(name);
-        arg_types.push_back(type);
+        signature.push_back(type);
     }
     
-    string return_type = ctx->TYPEID()->getText();
-    if (!type_ids.contains(return_type)) {
-        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::UNDEFINED_RETURN_TYPE, {method_name, current_class, return_type}));
+    Symbol return_symbol = symbols.symbol(ctx->TYPEID());
+    int return_type = types.index(return_symbol);
+    if (return_type == NO_TYPE) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::UNDEFINED_RETURN_TYPE, {symbols.str(method_symbol), typeName(current_class), symbols.str(return_symbol)}));
         types_ok = false;
     }
 
     if (!types_ok) {
         exitScope();
-        return {};
+        return nullptr;
     }
     
     size_t errors_before = errors.size();
-    auto body = visitExprAndAssertOk(ctx->expr());
-    string body_type = type_names[body->get_type()];
+    auto body = visitExpr(ctx->expr());
+    int body_type = body->get_type();
     
-    if (errors.size() == errors_before || body_type != "Object") {
+    if (errors.size() == errors_before || body_type != object_type) {
         if (!conform(body_type, return_type)) {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::BODY_TYPE_MISMATCH, {current_class, method_name, body_type, return_type}));
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::MethodError::BODY_TYPE_MISMATCH, {typeName(current_class), symbols.str(method_symbol), typeName(body_type), typeName(return_type)}));
         }
     }
     
     exitScope();
     
-    vector<int> signature;
-    for (const auto& t : arg_types) signature.push_back(type_ids.at(t));
-    signature.push_back(type_ids.at(return_type));
+    signature.push_back(return_type);
     
-    auto m = make_unique<Method>(method_name, signature);
+    auto m = make_unique<Method>(method_symbol, signature);
     m->set_argument_names(arg_names);
     m->set_body(move(body));
-    return m.release();
+    return m;
 }
 
-any TypeChecker::visitAttr(CoolParser::AttrContext *ctx) {
-    string name = ctx->OBJECTID()->getText();
-    string type = ctx->TYPEID()->getText();
+unique_ptr<Attribute> TypeChecker::visitAttr(CoolParser::AttrContext *ctx) {
+    Symbol name = symbols.symbol(ctx->OBJECTID());
+    int type = types.index(symbols.symbol(ctx->TYPEID()));
     
-    if (name == "self") {
+    if (name == Interner::SELF) {
         errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::AttrError::SELF_ATTR_NAME));
     }
     
-    if (!type_ids.contains(type)) {
-        return {};
+    if (type == NO_TYPE) {
+        return nullptr;
     }
 
     unique_ptr<Expr> init = nullptr;
     if (ctx->ASSIGN()) {
         size_t errors_before = errors.size();
-        init = visitExprAndAssertOk(ctx->expr());
-        string init_type = type_names[init->get_type()];
+        init = visitExpr(ctx->expr());
+        int init_type = init->get_type();
         
         if (errors.size() == errors_before) {
             if (!conform(init_type, type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::AttrError::BAD_SUBTYPE, {current_class, name, init_type, type}));
+                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::AttrError::BAD_SUBTYPE, {typeName(current_class), symbols.str(name), typeName(init_type), typeName(type)}));
             }
         }
     }
     
-    auto a = make_unique<Attribute>(name, type_ids.at(type));
+    auto a = make_unique<Attribute>(name, type);
     if (init) a->set_initializer(move(init));
-    return a.release();
+    return a;
 }
 
-any TypeChecker::visitFormal(CoolParser::FormalContext *ctx) {
-    return nullptr;
+unique_ptr<Expr> TypeChecker::visitInt(CoolParser::ExprContext *ctx) {
+    return std::make_unique<IntConstant>(stoi(ctx->INT_CONST()->getText()), int_type);
 }
 
-any TypeChecker::visitExpr(CoolParser::ExprContext *ctx) {
-    // Literals
-    if (ctx->INT_CONST()) {
-        scratchpad.push(std::make_unique<IntConstant>(stoi(ctx->INT_CONST()->getText()), type_ids.at("Int")));
-        return nullptr;
-    }
-    if (ctx->STR_CONST()) {
-        scratchpad.push(std::make_unique<StringConstant>(ctx->STR_CONST()->getText(), type_ids.at("String")));
-        return nullptr;
-    }
-    if (ctx->BOOL_CONST()) {
-        scratchpad.push(std::make_unique<BoolConstant>(ctx->BOOL_CONST()->getText() == "true", type_ids.at("Bool")));
-        return nullptr;
+unique_ptr<Expr> TypeChecker::visitString(CoolParser::ExprContext *ctx) {
+    return std::make_unique<StringConstant>(symbols.symbol(ctx->STR_CONST()), string_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitBool(CoolParser::ExprContext *ctx) {
+    return std::make_unique<BoolConstant>(ctx->BOOL_CONST()->getText() == "true", bool_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitObject(CoolParser::ExprContext *ctx) {
+    Symbol name = symbols.symbol(ctx->OBJECTID(0));
+    int type = lookupSymbol(name);
+    if (type == NO_TYPE) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OUT_OF_SCOPE, {symbols.str(name)}));
+        type = object_type; 
+    }
+    return make_unique<ObjectReference>(name, type);
+}
+
+unique_ptr<Expr> TypeChecker::visitAssignment(CoolParser::ExprContext *ctx) {
+    Symbol name = symbols.symbol(ctx->OBJECTID(0));
+    if (name == Interner::SELF) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::NO_SELF_ASSIGN));
     }
-    
-    // Variable
-    if (!ctx->OBJECTID().empty() && ctx->children.size() == 1) {
-        string name = ctx->OBJECTID(0)->getText();
-        string type = lookupSymbol(name);
-        if (type == "") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OUT_OF_SCOPE, {name}));
-            type = "Object"; 
+
+    auto val = visitExpr(ctx->expr(0));
+    int val_type = val->get_type();
+
+    int var_type = lookupSymbol(name);
+    if (var_type == NO_TYPE) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ASSIGNEE_OUT_SCOPE, {symbols.str(name)}));
+    } else {
+
+        if (!conform(val_type, var_type)) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ASSIGNEE_NOT_SUBTYPE, {typeName(current_class), symbols.str(name), typeName(val_type), typeName(var_type)}));
+            val_type = var_type;
         }
-        scratchpad.push(make_unique<ObjectReference>(name, type_ids.at(type)));
-        return nullptr;
     }
-    
-    // Assignment
-    if (ctx->ASSIGN()) {
-        string name = ctx->OBJECTID(0)->getText();
-        if (name == "self") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::NO_SELF_ASSIGN));
-        }
-        
-        auto val = visitExprAndAssertOk(ctx->expr(0));
-        string val_type = type_names[val->get_type()];
-        
-        string var_type = lookupSymbol(name);
-        if (var_type == "") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ASSIGNEE_OUT_SCOPE, {name}));
-            var_type = "Object";
-        } else {
-            
-            if (!conform(val_type, var_type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ASSIGNEE_NOT_SUBTYPE, {current_class, name, val_type, var_type}));
-                val_type = var_type;
-            }
-        }
-        
-        scratchpad.push(make_unique<Assignment>(name, move(val), type_ids.at(val_type)));
-        return nullptr;
+
+    return make_unique<Assignment>(name, move(val), val_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitSelfDispatch(CoolParser::ExprContext *ctx) {
+    Symbol method_symbol = symbols.symbol(ctx->OBJECTID(0));
+    string_view method_name = symbols.name(method_symbol);
+
+    // Target is self
+    auto target = make_unique<ObjectReference>(Interner::SELF, self_type);
+
+    vector<unique_ptr<Expr>> args;
+    for (auto e : ctx->expr()) {
+        args.push_back(visitExpr(e));
     }
-    
-    // Implicit Dispatch
-    if (!ctx->OBJECTID().empty() && ctx->children.size() > 1 && ctx->children[1]->getText() == "(") {
-        string method_name = ctx->OBJECTID(0)->getText();
-        
-        // Target is self
-        auto target = make_unique<ObjectReference>("self", type_ids.at("SELF_TYPE"));
-        string target_type = "SELF_TYPE";
-        
-        vector<unique_ptr<Expr>> args;
-        for (auto e : ctx->expr()) {
-            args.push_back(visitExprAndAssertOk(e));
-        }
-        
-        string lookup_type = current_class;
-        
-        string actual_method_type = "Object";
-        vector<string> formal_types;
-        bool method_found = false;
-        
-        string curr = lookup_type;
-        while (curr != "" && classes.contains(curr)) {
-            if (classes.at(curr).methods.contains(method_name)) {
-                auto& m = classes.at(curr).methods.at(method_name);
-                actual_method_type = m.return_type;
-                formal_types = m.arg_types;
-                method_found = true;
-                break;
-            }
-            curr = classes.at(curr).parent;
-        }
-        
-        if (!method_found) {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_NOT_DEFINED, {method_name, lookup_type, "dynamic dispatch"}));
+
+    int lookup_type = current_class;
+
+    const MethodInfo *method = types.find_method(lookup_type, method_name);
+    if (!method) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_NOT_DEFINED, {string(method_name), typeName(lookup_type), "dynamic dispatch"}));
+    } else {
+        const auto &formal_types = method->arg_types;
+        if (args.size() != formal_types.size()) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_BAD_ARGS_NUMBER, {string(method_name), typeName(lookup_type), to_string(formal_types.size()), to_string(args.size())}));
         } else {
-            if (args.size() != formal_types.size()) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_BAD_ARGS_NUMBER, {method_name, lookup_type, to_string(formal_types.size()), to_string(args.size())}));
-            } else {
-                for (size_t i = 0; i < args.size(); ++i) {
-                    string arg_type = type_names[args[i]->get_type()];
-                    if (!conform(arg_type, formal_types[i])) {
-                        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_INVALID_CALL, {method_name, lookup_type}));
-                        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ARGUMENT_HAS_WRONG_TYPE, {arg_type, formal_types[i], to_string(i)}));
-                    }
+            for (size_t i = 0; i < args.size(); ++i) {
+                int arg_type = args[i]->get_type();
+                if (!conform(arg_type, types.index(formal_types[i]))) {
+                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_INVALID_CALL, {string(method_name), typeName(lookup_type)}));
+                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ARGUMENT_HAS_WRONG_TYPE, {typeName(arg_type), symbols.str(formal_types[i]), to_string(i)}));
                 }
             }
         }
-        
-        string return_type = actual_method_type;
-        if (return_type == "SELF_TYPE") {
-            return_type = target_type; 
-        }
-        
-        if (!method_found) {
-            return_type = "Object";
-        }
-        
-        scratchpad.push(make_unique<DynamicDispatch>(move(target), method_name, move(args), type_ids.at(return_type)));
-        return nullptr;
     }
-    
-    // New
-    if (ctx->NEW()) {
-        string type = ctx->TYPEID(0)->getText();
-        if (type != "SELF_TYPE" && !classes.contains(type)) {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::INSTANTIATE_UKNOWN_CLASS, {type}));
-            type = "Object";
+
+    // A method whose return type is SELF_TYPE returns SELF_TYPE here, since
+    // the target is self. An undefined return type was reported with the
+    // method.
+    int return_type = object_type;
+    if (method) {
+        return_type = types.index(method->return_type);
+        if (return_type == NO_TYPE) {
+            return_type = object_type;
         }
-        scratchpad.push(make_unique<NewObject>(type_ids.at(type)));
-        return nullptr;
     }
-    
-    // If
-    if (ctx->IF()) {
-        auto pred = visitExprAndAssertOk(ctx->expr(0));
-        string pred_type = type_names[pred->get_type()];
-        if (pred_type != "Bool") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::IF_ELSE_NOT_BOOL, {pred_type}));
-        }
-        
-        auto then_e = visitExprAndAssertOk(ctx->expr(1));
-        string then_type = type_names[then_e->get_type()];
-        
-        auto else_e = visitExprAndAssertOk(ctx->expr(2));
-        string else_type = type_names[else_e->get_type()];
-        
-        string join_type = lub(then_type, else_type);
-        scratchpad.push(make_unique<IfThenElseFi>(move(pred), move(then_e), move(else_e), type_ids.at(join_type)));
-        return nullptr;
+
+    return make_unique<DynamicDispatch>(move(target), method_symbol, move(args), return_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitNew(CoolParser::ExprContext *ctx) {
+    Symbol type_symbol = symbols.symbol(ctx->TYPEID(0));
+    int type = types.index(type_symbol);
+    if (type == NO_TYPE) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::INSTANTIATE_UKNOWN_CLASS, {symbols.str(type_symbol)}));
+        type = object_type;
+    }
+    return make_unique<NewObject>(type);
+}
+
+unique_ptr<Expr> TypeChecker::visitCond(CoolParser::ExprContext *ctx) {
+    auto pred = visitExpr(ctx->expr(0));
+    int pred_type = pred->get_type();
+    if (pred_type != bool_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::IF_ELSE_NOT_BOOL, {typeName(pred_type)}));
     }
-    
-    // While
-    if (ctx->WHILE()) {
-        auto pred = visitExprAndAssertOk(ctx->expr(0));
-        string pred_type = type_names[pred->get_type()];
-        if (pred_type != "Bool") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::WHILE_NOT_BOOL, {pred_type}));
-        }
-        
-        auto body = visitExprAndAssertOk(ctx->expr(1));
-        
-        scratchpad.push(make_unique<WhileLoopPool>(move(pred), move(body), type_ids.at("Object")));
-        return nullptr;
+
+    auto then_e = visitExpr(ctx->expr(1));
+    int then_type = then_e->get_type();
+
+    auto else_e = visitExpr(ctx->expr(2));
+    int else_type = else_e->get_type();
+
+    int join_type = lub(then_type, else_type);
+    return make_unique<IfThenElseFi>(move(pred), move(then_e), move(else_e), join_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitLoop(CoolParser::ExprContext *ctx) {
+    auto pred = visitExpr(ctx->expr(0));
+    int pred_type = pred->get_type();
+    if (pred_type != bool_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::WHILE_NOT_BOOL, {typeName(pred_type)}));
     }
-    
-    // Block
-    if (ctx->children.size() > 2 && ctx->children[0]->getText() == "{") {
-        vector<unique_ptr<Expr>> exprs;
-        string last_type = "Object"; 
-        for (auto e : ctx->expr()) {
-            auto expr = visitExprAndAssertOk(e);
-            last_type = type_names[expr->get_type()];
-            exprs.push_back(move(expr));
+
+    auto body = visitExpr(ctx->expr(1));
+
+    return make_unique<WhileLoopPool>(move(pred), move(body), object_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitBlock(CoolParser::ExprContext *ctx) {
+    vector<unique_ptr<Expr>> exprs;
+    int last_type = object_type; 
+    for (auto e : ctx->expr()) {
+        auto expr = visitExpr(e);
+        last_type = expr->get_type();
+        exprs.push_back(move(expr));
+    }
+    return make_unique<Sequence>(move(exprs), last_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitLet(CoolParser::ExprContext *ctx) {
+    enterScope();
+    vector<unique_ptr<Vardecl>> decls;
+    for (auto v : ctx->vardecl()) {
+        Symbol name = symbols.symbol(v->OBJECTID());
+        Symbol type_symbol = symbols.symbol(v->TYPEID());
+        int type = types.index(type_symbol);
+        if (name == Interner::SELF) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::LET_NO_SELF_ASSIGN));
+        }
+        if (type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::LET_BAD_TYPE, {symbols.str(type_symbol), symbols.str(name)}));
+            type = object_type;
         }
-        scratchpad.push(make_unique<Sequence>(move(exprs), type_ids.at(last_type)));
-        return nullptr;
+
+        unique_ptr<Expr> init = nullptr;
+        if (v->ASSIGN()) {
+            size_t errors_before = errors.size();
+            init = visitExpr(v->expr());
+            bool init_had_error = errors.size() > errors_before;
+            int init_type = init->get_type();
+            if (!init_had_error && !conform(init_type, type)) {
+                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::LET_NOT_SUBTYPE, {symbols.str(name), typeName(init_type), typeName(type)}));
+            }
+        }
+
+        addSymbol(name, type);
+        decls.push_back(unique_ptr<Vardecl>(new Vardecl(name, move(init), type)));
     }
-    
-    // Let
-    if (ctx->LET()) {
+
+    auto body = visitExpr(ctx->expr(0));
+
+    exitScope();
+
+    return make_unique<LetIn>(move(decls), move(body), body->get_type());
+}
+
+unique_ptr<Expr> TypeChecker::visitCase(CoolParser::ExprContext *ctx) {
+    auto expr = visitExpr(ctx->expr(0));
+
+    vector<CaseOfEsac::Case> cases;
+    int join_type = NO_TYPE;
+
+    size_t num_branches = ctx->OBJECTID().size();
+    // by name, so that two undefined types only clash if they are the same
+    set<Symbol> branch_types;
+
+    for (size_t i = 0; i < num_branches; ++i) {
+        Symbol name = symbols.symbol(ctx->OBJECTID(i));
+        Symbol type_symbol = symbols.symbol(ctx->TYPEID(i));
+        int type = types.index(type_symbol);
+        bool type_ok = true;
+
+        if (type == self_type) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CASE_SELF_TYPE, {symbols.str(name)}));
+            type_ok = false;
+        } else if (type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CASE_UKNOWN_TYPE, {symbols.str(name), symbols.str(type_symbol)}));
+            type_ok = false;
+        }
+
+        if (branch_types.contains(type_symbol)) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CASE_MULTIPLE_OPTIONS_TYPE, {symbols.str(type_symbol)}));
+        }
+        branch_types.insert(type_symbol);
+
         enterScope();
-        vector<unique_ptr<Vardecl>> decls;
-        for (auto v : ctx->vardecl()) {
-            string name = v->OBJECTID()->getText();
-            string type = v->TYPEID()->getText();
-            if (name == "self") {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::LET_NO_SELF_ASSIGN));
-            }
-            if (type != "SELF_TYPE" && !classes.contains(type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::LET_BAD_TYPE, {type, name}));
-                type = "Object";
-            }
-            
-            unique_ptr<Expr> init = nullptr;
-            if (v->ASSIGN()) {
-                size_t errors_before = errors.size();
-                init = visitExprAndAssertOk(v->expr());
-                bool init_had_error = errors.size() > errors_before;
-                string init_type = type_names[init->get_type()];
-                if (!init_had_error && !conform(init_type, type)) {
-                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::LET_NOT_SUBTYPE, {name, init_type, type}));
-                }
-            }
-            
+        if (type_ok) {
             addSymbol(name, type);
-            decls.push_back(unique_ptr<Vardecl>(new Vardecl(name, move(init), type_ids.at(type))));
         }
-        
-        auto body = visitExprAndAssertOk(ctx->expr(0));
-        
+
+        auto branch_expr = visitExpr(ctx->expr(i+1));
+        int branch_type = branch_expr->get_type();
+
+        if (join_type == NO_TYPE) join_type = branch_type;
+        else join_type = lub(join_type, branch_type);
+
+        int type_id = type_ok ? type : object_type;
+        cases.emplace_back(name, type_id, move(branch_expr));
+
         exitScope();
-        
-        scratchpad.push(make_unique<LetIn>(move(decls), move(body), body->get_type()));
-        return nullptr;
     }
-    
-    // Case
-    if (ctx->CASE()) {
-        auto expr = visitExprAndAssertOk(ctx->expr(0));
-        
-        vector<CaseOfEsac::Case> cases;
-        string join_type = "";
-        
-        size_t num_branches = ctx->OBJECTID().size();
-        set<string> branch_types;
-        
-        for (size_t i = 0; i < num_branches; ++i) {
-            string name = ctx->OBJECTID(i)->getText();
-            string type = ctx->TYPEID(i)->getText();
-            bool type_ok = true;
-            
-            if (type == "SELF_TYPE") {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CASE_SELF_TYPE, {name}));
-                type_ok = false;
-            } else if (!classes.contains(type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CASE_UKNOWN_TYPE, {name, type}));
-                type_ok = false;
-            }
-            
-            if (branch_types.contains(type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CASE_MULTIPLE_OPTIONS_TYPE, {type}));
-            }
-            branch_types.insert(type);
-            
-            enterScope();
-            if (type_ok) {
-                addSymbol(name, type);
-            }
-            
-            auto branch_expr = visitExprAndAssertOk(ctx->expr(i+1));
-            string branch_type = type_names[branch_expr->get_type()];
-            
-            if (join_type == "") join_type = branch_type;
-            else join_type = lub(join_type, branch_type);
-            
-            int type_id = type_ok ? type_ids.at(type) : type_ids.at("Object");
-            cases.emplace_back(name, type_id, move(branch_expr));
-            
-            exitScope();
+
+    return make_unique<CaseOfEsac>(move(expr), move(cases), ctx->getStart()->getLine(), join_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitDispatch(CoolParser::ExprContext *ctx) {
+    size_t errors_before = errors.size();
+    auto target = visitExpr(ctx->expr(0));
+    bool target_had_error = errors.size() > errors_before;
+
+    int target_type = target->get_type();
+
+    Symbol method_symbol = symbols.symbol(ctx->OBJECTID(0));
+    string_view method_name = symbols.name(method_symbol);
+    int static_type = NO_TYPE;
+    bool static_type_error = false;
+    if (ctx->AT()) {
+        Symbol static_symbol = symbols.symbol(ctx->TYPEID(0));
+        static_type = types.index(static_symbol);
+        if (static_type == self_type) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::STATIC_TO_SELF));
+            static_type = object_type;
+            static_type_error = true;
+        } else if (static_type == NO_TYPE) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::STATIC_UNDEFINED_TYPE, {symbols.str(static_symbol)}));
+            static_type = object_type;
+            static_type_error = true;
+        } else if (!conform(target_type, static_type)) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::STAT_DISPATCH_BAD_TYPE, {typeName(target_type), typeName(static_type)}));
         }
-        
-        scratchpad.push(make_unique<CaseOfEsac>(move(expr), move(cases), ctx->getStart()->getLine(), type_ids.at(join_type)));
-        return nullptr;
     }
-    
-    // Dispatch
-    if (ctx->DOT()) {
-        size_t errors_before = errors.size();
-        auto target = visitExprAndAssertOk(ctx->expr(0));
-        bool target_had_error = errors.size() > errors_before;
-        
-        string target_type = type_names[target->get_type()];
-        
-        string method_name = ctx->OBJECTID(0)->getText();
-        string static_type = "";
-        bool static_type_error = false;
-        if (ctx->AT()) {
-            static_type = ctx->TYPEID(0)->getText();
-            if (static_type == "SELF_TYPE") {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::STATIC_TO_SELF));
-                static_type = "Object";
-                static_type_error = true;
-            } else if (!classes.contains(static_type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::STATIC_UNDEFINED_TYPE, {static_type}));
-                static_type = "Object";
-                static_type_error = true;
-            } else if (!conform(target_type, static_type)) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::STAT_DISPATCH_BAD_TYPE, {target_type, static_type}));
-            }
-        }
-        
-        vector<unique_ptr<Expr>> args;
-        for (size_t i = 1; i < ctx->expr().size(); ++i) {
-            args.push_back(visitExprAndAssertOk(ctx->expr(i)));
-        }
-        
-        string lookup_type = static_type.empty() ? target_type : static_type;
-        if (static_type_error) lookup_type = target_type;
-        if (lookup_type == "SELF_TYPE") lookup_type = current_class;
-        
-        string actual_method_type = "Object";
-        vector<string> formal_types;
-        bool method_found = false;
-        
-        string curr = lookup_type;
-        while (curr != "" && classes.contains(curr)) {
-            if (classes.at(curr).methods.contains(method_name)) {
-                auto& m = classes.at(curr).methods.at(method_name);
-                actual_method_type = m.return_type;
-                formal_types = m.arg_types;
-                method_found = true;
-                break;
+
+    vector<unique_ptr<Expr>> args;
+    for (size_t i = 1; i < ctx->expr().size(); ++i) {
+        args.push_back(visitExpr(ctx->expr(i)));
+    }
+
+    int lookup_type = static_type == NO_TYPE ? target_type : static_type;
+    if (static_type_error) lookup_type = target_type;
+    if (lookup_type == self_type) lookup_type = current_class;
+
+    const MethodInfo *method = types.find_method(lookup_type, method_name);
+    if (!method) {
+        if (!target_had_error) {
+            if (ctx->AT()) {
+                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_NOT_DEFINED, {string(method_name), typeName(lookup_type), "static dispatch"}));
+            } else {
+                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_NOT_DEFINED, {string(method_name), typeName(lookup_type), "dynamic dispatch"}));
             }
-            curr = classes.at(curr).parent;
         }
-        
-        if (!method_found) {
-            if (!target_had_error) {
-                if (ctx->AT()) {
-                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_NOT_DEFINED, {method_name, lookup_type, "static dispatch"}));
-                } else {
-                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_NOT_DEFINED, {method_name, lookup_type, "dynamic dispatch"}));
-                }
-            }
+    } else {
+        const auto &formal_types = method->arg_types;
+        if (args.size() != formal_types.size()) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_BAD_ARGS_NUMBER, {string(method_name), typeName(lookup_type), to_string(formal_types.size()), to_string(args.size())}));
         } else {
-            if (args.size() != formal_types.size()) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_BAD_ARGS_NUMBER, {method_name, lookup_type, to_string(formal_types.size()), to_string(args.size())}));
-            } else {
-                for (size_t i = 0; i < args.size(); ++i) {
-                    string arg_type = type_names[args[i]->get_type()];
-                    if (!conform(arg_type, formal_types[i])) {
-                        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_INVALID_CALL, {method_name, lookup_type}));
-                        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ARGUMENT_HAS_WRONG_TYPE, {arg_type, formal_types[i], to_string(i)}));
-                    }
+            for (size_t i = 0; i < args.size(); ++i) {
+                int arg_type = args[i]->get_type();
+                if (!conform(arg_type, types.index(formal_types[i]))) {
+                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::METHOD_INVALID_CALL, {string(method_name), typeName(lookup_type)}));
+                    errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::ARGUMENT_HAS_WRONG_TYPE, {typeName(arg_type), symbols.str(formal_types[i]), to_string(i)}));
                 }
             }
         }
-        
-        string return_type = actual_method_type;
-        if (return_type == "SELF_TYPE") {
+    }
+
+    // An undefined return type was reported with the method.
+    int return_type = object_type;
+    if (method) {
+        return_type = types.index(method->return_type);
+        if (return_type == self_type) {
             return_type = target_type; 
+        } else if (return_type == NO_TYPE) {
+            return_type = object_type;
         }
-        
-        if (!method_found) {
-            return_type = "Object";
-        }
-        
-        if (ctx->AT()) {
-             scratchpad.push(make_unique<StaticDispatch>(move(target), type_ids.at(static_type), method_name, move(args), type_ids.at(return_type)));
-        } else {
-             scratchpad.push(make_unique<DynamicDispatch>(move(target), method_name, move(args), type_ids.at(return_type)));
-        }
-        return nullptr;
     }
-    
-    // Operations
-    if (ctx->PLUS() || ctx->MINUS() || ctx->STAR() || ctx->SLASH()) {
-        auto l = visitExprAndAssertOk(ctx->expr(0));
-        auto r = visitExprAndAssertOk(ctx->expr(1));
-        
-        string l_type = type_names[l->get_type()];
-        string r_type = type_names[r->get_type()];
-        
-        if (l_type != "Int") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OP_BAD_LEFT, {l_type}));
-        }
-        if (r_type != "Int") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OP_BAD_RIGHT, {r_type}));
-        }
-        
-        Arithmetic::Kind op;
-        if (ctx->PLUS()) op = Arithmetic::Kind::Addition;
-        else if (ctx->MINUS()) op = Arithmetic::Kind::Subtraction;
-        else if (ctx->STAR()) op = Arithmetic::Kind::Multiplication;
-        else op = Arithmetic::Kind::Division;
-        
-        scratchpad.push(make_unique<Arithmetic>(move(l), move(r), op, type_ids.at("Int")));
-        return nullptr;
+
+    if (ctx->AT()) {
+         return make_unique<StaticDispatch>(move(target), static_type, method_symbol, move(args), return_type);
     }
-    
-    // Comparison
-    if (ctx->LT() || ctx->LE() || ctx->EQ()) {
-        auto l = visitExprAndAssertOk(ctx->expr(0));
-        auto r = visitExprAndAssertOk(ctx->expr(1));
-        
-        string l_type = type_names[l->get_type()];
-        string r_type = type_names[r->get_type()];
-        
-        if (ctx->EQ()) {
-            if ((l_type == "Int" || l_type == "String" || l_type == "Bool" ||
-                 r_type == "Int" || r_type == "String" || r_type == "Bool") &&
-                l_type != r_type) {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OP_BAD_COMPARE, {l_type, r_type}));
-            }
-            scratchpad.push(make_unique<EqualityComparison>(move(l), move(r), type_ids.at("Bool")));
-        } else {
-            if (l_type != "Int") {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CMP_BAD_LEFT, {l_type}));
-            }
-            if (r_type != "Int") {
-                errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CMP_BAD_RIGHT, {r_type}));
-            }
-            if (ctx->LT()) {
-                scratchpad.push(make_unique<IntegerComparison>(move(l), move(r), IntegerComparison::Kind::LessThan, type_ids.at("Bool")));
-            } else {
-                scratchpad.push(make_unique<IntegerComparison>(move(l), move(r), IntegerComparison::Kind::LessThanEqual, type_ids.at("Bool")));
-            }
-        }
-        return nullptr;
+    return make_unique<DynamicDispatch>(move(target), method_symbol, move(args), return_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitArithmetic(CoolParser::ExprContext *ctx, Arithmetic::Kind op) {
+    auto l = visitExpr(ctx->expr(0));
+    auto r = visitExpr(ctx->expr(1));
+
+    int l_type = l->get_type();
+    int r_type = r->get_type();
+
+    if (l_type != int_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OP_BAD_LEFT, {typeName(l_type)}));
     }
-    
-    // Not
-    if (ctx->NOT()) {
-        auto e = visitExprAndAssertOk(ctx->expr(0));
-        if (type_names[e->get_type()] != "Bool") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::NOT_BAD_TYPE, {type_names[e->get_type()]}));
-        }
-        scratchpad.push(make_unique<BooleanNegation>(move(e), type_ids.at("Bool")));
-        return nullptr;
+    if (r_type != int_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OP_BAD_RIGHT, {typeName(r_type)}));
     }
-    
-    // Neg
-    if (ctx->TILDE()) {
-        auto e = visitExprAndAssertOk(ctx->expr(0));
-        if (type_names[e->get_type()] != "Int") {
-            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::TILDE_BAD_TYPE, {type_names[e->get_type()]}));
+
+    return make_unique<Arithmetic>(move(l), move(r), op, int_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitCompare(CoolParser::ExprContext *ctx) {
+    auto l = visitExpr(ctx->expr(0));
+    auto r = visitExpr(ctx->expr(1));
+
+    int l_type = l->get_type();
+    int r_type = r->get_type();
+
+    if (ctx->EQ()) {
+        auto is_basic = [&](int type) {
+            return type == int_type || type == string_type || type == bool_type;
+        };
+        if ((is_basic(l_type) || is_basic(r_type)) && l_type != r_type) {
+            errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::OP_BAD_COMPARE, {typeName(l_type), typeName(r_type)}));
         }
-        scratchpad.push(make_unique<IntegerNegation>(move(e), type_ids.at("Int")));
-        return nullptr;
+        return make_unique<EqualityComparison>(move(l), move(r), bool_type);
     }
-    
-    // IsVoid
-    if (ctx->ISVOID()) {
-        auto e = visitExprAndAssertOk(ctx->expr(0));
-        scratchpad.push(make_unique<IsVoid>(move(e), type_ids.at("Bool")));
-        return nullptr;
+
+    if (l_type != int_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CMP_BAD_LEFT, {typeName(l_type)}));
     }
-    
-    // Paren
-    if (ctx->children.size() == 3 && ctx->children[0]->getText() == "(") {
-        auto e = visitExprAndAssertOk(ctx->expr(0));
-        int type = e->get_type();
-        scratchpad.push(make_unique<ParenthesizedExpr>(move(e), type));
-        return nullptr;
+    if (r_type != int_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::CMP_BAD_RIGHT, {typeName(r_type)}));
     }
-    
-    scratchpad.push(make_unique<Expr>(type_ids.at("Object")));
-    return nullptr;
+    if (ctx->LT()) {
+        return make_unique<IntegerComparison>(move(l), move(r), IntegerComparison::Kind::LessThan, bool_type);
+    }
+    return make_unique<IntegerComparison>(move(l), move(r), IntegerComparison::Kind::LessThanEqual, bool_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitNot(CoolParser::ExprContext *ctx) {
+    auto e = visitExpr(ctx->expr(0));
+    if (e->get_type() != bool_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::NOT_BAD_TYPE, {typeName(e->get_type())}));
+    }
+    return make_unique<BooleanNegation>(move(e), bool_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitNeg(CoolParser::ExprContext *ctx) {
+    auto e = visitExpr(ctx->expr(0));
+    if (e->get_type() != int_type) {
+        errors.push_back(ErrorMessagePrinter(ErrorMessagePrinter::ExprError::TILDE_BAD_TYPE, {typeName(e->get_type())}));
+    }
+    return make_unique<IntegerNegation>(move(e), int_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitIsvoid(CoolParser::ExprContext *ctx) {
+    auto e = visitExpr(ctx->expr(0));
+    return make_unique<IsVoid>(move(e), bool_type);
+}
+
+unique_ptr<Expr> TypeChecker::visitParen(CoolParser::ExprContext *ctx) {
+    auto e = visitExpr(ctx->expr(0));
+    int type = e->get_type();
+    return make_unique<ParenthesizedExpr>(move(e), type);
 }
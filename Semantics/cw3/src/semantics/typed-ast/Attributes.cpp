@@ -2,7 +2,7 @@
 
 #include <cassert>
 
-std::optional<int> Attributes::get_type(const std::string &attribute_name) {
+std::optional<int> Attributes::get_type(Symbol attribute_name) {
     auto it = name_to_index_.find(attribute_name);
     if (it == name_to_index_.end()) {
         return std::nullopt;
@@ -12,7 +12,7 @@ std::optional<int> Attributes::get_type(const std::string &attribute_name) {
 }
 
 bool Attributes::add(Attribute &&attribute) {
-    auto &attribute_name = attribute.get_name();
+    Symbol attribute_name = attribute.get_name();
     if (contains(attribute_name)) {
         return false;
     }
@@ -23,7 +23,7 @@ bool Attributes::add(Attribute &&attribute) {
     return true;
 }
 
-Attribute *Attributes::get(const std::string &attribute_name) {
+Attribute *Attributes::get(Symbol attribute_name) {
     auto it = name_to_index_.find(attribute_name);
     if (it == name_to_index_.end()) {
         return nullptr;
@@ -32,12 +32,12 @@ Attribute *Attributes::get(const std::string &attribute_name) {
     return &attributes_[it->second];
 }
 
-bool Attributes::contains(const std::string &attribute_name) {
+bool Attributes::contains(Symbol attribute_name) {
     return name_to_index_.find(attribute_name) != name_to_index_.end();
 }
 
-std::vector<std::string> Attributes::get_names() {
-    std::vector<std::string> attribute_names;
+std::vector<Symbol> Attributes::get_names() {
+    std::vector<Symbol> attribute_names;
     attribute_names.reserve(attributes_.size());
 
     for (auto &attribute : attributes_) {
@@ -48,16 +48,16 @@ std::vector<std::string> Attributes::get_names() {
 }
 
 bool
-Attributes::has_initializer(const std::string &attribute_name) const {
+Attributes::has_initializer(Symbol attribute_name) const {
     return name_to_index_.contains(attribute_name);
 }
 
 const Expr *
-Attributes::get_initializer(const std::string &attribute_name) const {
+Attributes::get_initializer(Symbol attribute_name) const {
     return attributes_.at(name_to_index_.at(attribute_name)).get_initializer();
 }
 
-void Attributes::set_initializer(const std::string &attribute_name,
+void Attributes::set_initializer(Symbol attribute_name,
                                  std::unique_ptr<Expr> &&initializer) {
     attributes_[name_to_index_[attribute_name]].set_initializer(
         move(initializer));
@@ -4,7 +4,7 @@
 
 using namespace std;
 
-optional<vector<int>> Methods::get_signature(const string &method_name) {
+optional<vector<int>> Methods::get_signature(Symbol method_name) {
     auto it = method_name_to_index_.find(method_name);
     if (it == method_name_to_index_.end()) {
         return nullopt;
@@ -14,19 +14,19 @@ optional<vector<int>> Methods::get_signature(const string &method_name) {
 }
 
 void Methods::add_method(Method &&method) {
-    auto &method_name = method.get_name();
+    Symbol method_name = method.get_name();
     assert(!contains(method_name));
 
     method_name_to_index_.insert({method_name, methods_.size()});
     methods_.push_back(move(method));
 }
 
-bool Methods::contains(const string &method_name) {
+bool Methods::contains(Symbol method_name) {
     return method_name_to_index_.find(method_name) != method_name_to_index_.end();
 }
 
-vector<string> Methods::get_names() {
-    vector<string> method_names;
+vector<Symbol> Methods::get_names() {
+    vector<Symbol> method_names;
     method_names.reserve(methods_.size());
 
     for (auto &method : methods_) {
@@ -36,29 +36,29 @@ vector<string> Methods::get_names() {
     return method_names;
 }
 
-void Methods::set_argument_names(const string &method_name,
-                                 vector<string> argument_names) {
+void Methods::set_argument_names(Symbol method_name,
+                                 vector<Symbol> argument_names) {
     auto it = method_name_to_index_.find(method_name);
     assert(it != method_name_to_index_.end());
 
     methods_[it->second].set_argument_names(move(argument_names));
 }
 
-vector<string> Methods::get_argument_names(const string &method_name) {
+vector<Symbol> Methods::get_argument_names(Symbol method_name) {
     auto it = method_name_to_index_.find(method_name);
     assert(it != method_name_to_index_.end());
 
     return methods_[it->second].get_argument_names();
 }
 
-void Methods::set_body(const string &method_name, unique_ptr<Expr> &&body) {
+void Methods::set_body(Symbol method_name, unique_ptr<Expr> &&body) {
     auto it = method_name_to_index_.find(method_name);
     assert(it != method_name_to_index_.end());
 
     methods_[it->second].set_body(move(body));
 }
 
-const Expr *Methods::get_body(const string &method_name) {
+const Expr *Methods::get_body(Symbol method_name) {
     auto it = method_name_to_index_.find(method_name);
     assert(it != method_name_to_index_.end());
 
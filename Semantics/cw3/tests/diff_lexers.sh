@@ -0,0 +1,22 @@
+#!/bin/sh
+# Checks that CoolFastLexer and CoolLexer produce the same tokens, with the
+# same side data, for every file of the lexer corpus, and that each lexer
+# streams the same payloads that it keeps in its table.
+#
+# Usage: tests/diff_lexers.sh <driver>
+#
+# where <driver> is a built SemanticsDriver (or the CodegenDriver of cw4,
+# which takes the same --diff-lexers flag). The first difference in each file
+# is printed, and the script fails if any file differs.
+
+set -eu
+
+if [ $# -ne 1 ]; then
+    echo "usage: $0 <driver>" >&2
+    exit 2
+fi
+
+driver=$1
+corpus=$(dirname "$0")/lexer
+
+exec "$driver" --diff-lexers "$corpus"/*.cl
@@ -0,0 +1,12 @@
+-- a line comment
+--
+(* a block comment *)
+(**)
+(* nested (* comments (* three *) deep *) still inside *)
+(* -- a line comment inside a block comment *)
+-- (* a block comment inside a line comment
+(* a string "inside *)" a comment *)
+*) unmatched close
+(*) still a comment *)
+a--b
+a(*b*)c
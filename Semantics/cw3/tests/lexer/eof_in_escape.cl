@@ -0,0 +1 @@
+x <- "ends in an escape \
\ No newline at end of file
@@ -0,0 +1 @@
+x <- "never closed
\ No newline at end of file
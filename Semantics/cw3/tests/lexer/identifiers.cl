@@ -0,0 +1,3 @@
+a A z Z a1 A1 a_b A_B _a _ __ x123_y Main SELF_TYPE self
+classy Classy iff Iffy truely falsey newer notable of_ esac_
+0 007 1234567890 12ab 3X
@@ -0,0 +1,5 @@
+class CLASS Class cLaSs else ELSE fi FI if IF in IN inherits INHERITS
+isvoid ISVOID let LET loop LOOP pool POOL then THEN while WHILE case CASE
+esac ESAC new NEW of OF not NOT
+true false tRUE fALSE trUe faLSE
+True False TRUE FALSE
@@ -0,0 +1,4 @@
+<- <= < => = + - * / ~ . @ , : ; ( ) { }
+<-- <=> <<- ==> -> =< ~~ .. @@
+a<-b a<=b a<b a=>b
+! # $ % ^ & [ ] | \ ` ? > '
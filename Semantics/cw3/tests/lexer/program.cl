@@ -0,0 +1,20 @@
+(* A complete program, so that the corpus covers the common case. *)
+class Main inherits IO {
+    count : Int <- 0;
+    name : String <- "main";
+
+    main() : Object {
+        let i : Int <- 10 in {
+            while 0 < i loop {
+                out_string(name.concat("\n"));
+                count <- count + 1;
+                i <- i - 1;
+            } pool;
+            if count = 10 then out_int(count) else abort() fi;
+            case self of
+                m : Main => m;
+                o : Object => o;
+            esac;
+        }
+    };
+};
@@ -0,0 +1,11 @@
+""
+"plain"
+"with \"quotes\" and \\backslashes\\"
+"\n\t\b\f \a\q\z \0\1"
+"escaped \
+newline"
+"unterminated
+"after unterminated"
+"tab	inside" "two" "strings"
+"\
+"